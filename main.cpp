@@ -10,6 +10,53 @@
 // This file must be included before using any Raylib functions.
 #include "raylib.h"
 
+// OpenGL itself, only for the pixel-pack buffers of the replay export
+// (raylib keeps its loader private; libGL exports the GL 3 entry points).
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// Engine components (header-only so the game still builds as one unit):
+// - ai.h       → CPU opponent (opening book + alpha-beta search)
+// - analysis.h → exact per-cell values for the analysis overlay (key A)
+// - protocol.h → optional external engine process (--engine "<command>")
+// - puzzle.h   → memory-mapped "win in N" puzzle pack (make puzzles)
+// - archive.h  → archive of finished games, streamed by the replay scene
+// - clock.h    → monotonic per-player clocks of the blitz mode
+// - variants.h → wild / misère / Order and Chaos boards from rules policies
+// - quantum.h  → quantum tic-tac-toe rules (spooky marks and collapse)
+// - lockfree.h → wait-free channels between the render and logic threads
+// - arena.h    → per-frame linear arenas; ARENA_COUNT_HEAP makes this unit
+//                count every heap allocation so frame loops can prove they
+//                make none
+// - gravity.h  → 7×6 gravity-mode bitboard and its solver
+// - hotreload.h → --dev: reload edited resources/*.png without a restart
+// - infinite.h → sparse chunked board for the infinite-board mode
+// - notakto.h  → Notakto boards solved through their misère quotient
+// - script.h   → coroutine scripts for timed sequences (scene transitions)
+// - video.h    → GIF / ffmpeg encoder thread behind --export
+#define ARENA_COUNT_HEAP
+#include "src/ai.h"
+#include "src/analysis.h"
+#include "src/archive.h"
+#include "src/arena.h"
+#include "src/clock.h"
+#include "src/gravity.h"
+#include "src/hotreload.h"
+#include "src/infinite.h"
+#include "src/lockfree.h"
+#include "src/notakto.h"
+#include "src/protocol.h"
+#include "src/puzzle.h"
+#include "src/quantum.h"
+#include "src/script.h"
+#include "src/variants.h"
+#include "src/video.h"
+
+#include <chrono>
+#include <csignal>
+#include <thread>
+
 // ============================================================================
 // ENUM DECLARATIONS
 // ============================================================================
@@ -22,7 +69,31 @@
 //   SCENE_MENU    → Main Menu screen
 //   SCENE_GAME    → Game screen where Tic-Tac-Toe is played
 //   SCENE_CREDITS → Credits screen
-enum SceneName { SCENE_MENU = 1, SCENE_GAME = 2, SCENE_CREDITS = 3 };
+//   SCENE_MODES   → Game mode picker opened by PLAY
+//   SCENE_INFINITE → k-in-a-row on an unbounded board
+//   SCENE_GRAVITY → 7×6 board where stones drop to the lowest free cell
+//   SCENE_NOTAKTO → X-only misère play on several 3×3 boards
+//   SCENE_QUANTUM → quantum tic-tac-toe (entangled marks that collapse)
+//   SCENE_PUZZLE  → daily "win in N" puzzle from the mined pack
+//   SCENE_REPLAY  → pages through archived games, move by move
+//   SCENE_BLITZ   → 3×3 with a clock per player and an increment per move
+//   SCENE_VARIANT → wild 3×3, misère 3×3 and Order and Chaos
+// Each scene's assets and entry points live in the SCENES table.
+enum SceneName {
+  SCENE_MENU = 1,
+  SCENE_GAME = 2,
+  SCENE_CREDITS = 3,
+  SCENE_MODES = 4,
+  SCENE_INFINITE = 5,
+  SCENE_GRAVITY = 6,
+  SCENE_NOTAKTO = 7,
+  SCENE_QUANTUM = 8,
+  SCENE_PUZZLE = 9,
+  SCENE_REPLAY = 10,
+  SCENE_BLITZ = 11,
+  SCENE_VARIANT = 12,
+  SCENE_COUNT // one past the last scene; see the SCENES registry
+};
 
 // -----------------------------------------------------------------------------
 // enum Player
@@ -34,11 +105,209 @@ enum SceneName { SCENE_MENU = 1, SCENE_GAME = 2, SCENE_CREDITS = 3 };
 //   PLAYER_O → tile contains O
 enum Player { EMPTY = 0, PLAYER_X = 1, PLAYER_O = 2 };
 
+// ============================================================================
+// STRUCT: InfiniteView
+// ============================================================================
+// The renderable part of the infinite-board mode. The stones themselves live
+// in an InfiniteBoard owned by the logic thread (it is a hash map, so it
+// can't be copied into snapshots); each snapshot carries just the stones
+// inside the viewport.
+//
+// MEMBER VARIABLES:
+//   camX, camY   → board cell shown in the viewport's top-left corner
+//   lastX, lastY → the most recent stone (highlighted, HOME jumps to it)
+//   stones       → stones on the board
+//
+struct InfiniteView {
+  int camX = -5, camY = -4;
+  int lastX = 0, lastY = 0;
+  int stones = 0;
+};
+
+// ============================================================================
+// STRUCT: GravityView
+// ============================================================================
+// State of the gravity mode. The whole board is 24 bytes, so unlike the
+// infinite mode it simply lives in GameState and every snapshot has it.
+//
+// MEMBER VARIABLES:
+//   board    → stones, side to move and move count
+//   lastCol  → column of the most recent stone (highlighted), -1 if none
+//   cpuMoved → true once the CPU has moved this game (cpu is valid)
+//   cpu      → the CPU's last answer: column, exact score if solved, nodes
+//
+struct GravityView {
+  GravityBoard board;
+  int lastCol = -1;
+  bool cpuMoved = false;
+  GravityMove cpu;
+};
+
+// ============================================================================
+// STRUCT: NotaktoView
+// ============================================================================
+// State of the Notakto mode; like GravityView small enough to live in
+// GameState.
+//
+// MEMBER VARIABLES:
+//   pos       → the boards (9-bit masks of occupied cells)
+//   boards    → board count for new games, chosen with the < > arrows
+//   lastBoard → board and cell of the most recent X (highlighted), -1 if
+//   lastCell    none
+//   cpuMoved  → true once the CPU has moved this game
+//   cpuValue  → quotient element of the position the CPU moved from
+//   cpuWon    → the CPU found a move to a P-position (it wins from here)
+//
+struct NotaktoView {
+  NotaktoPosition pos;
+  int boards = 3;
+  int lastBoard = -1, lastCell = -1;
+  bool cpuMoved = false;
+  int cpuValue = 0;
+  bool cpuWon = false;
+};
+
+// ============================================================================
+// STRUCT: QuantumView
+// ============================================================================
+// State of the quantum mode. The classical marks are also mirrored into
+// GameState::board, so DrawBoard() draws them as ordinary X / O tiles.
+//
+// MEMBER VARIABLES:
+//   board → spooky and classical marks, pending collapse, result
+//   pick  → first cell of the move being entered, -1 if none
+//
+struct QuantumView {
+  QuantumBoard board;
+  int pick = -1;
+};
+
+// ============================================================================
+// STRUCT: PuzzleView
+// ============================================================================
+// State of the puzzle scene. The puzzle is copied out of the mapped pack
+// (24 bytes), so snapshots carry everything the scene draws.
+//
+// MEMBER VARIABLES:
+//   puzzle → position, answer and N of the puzzle on screen
+//   index  → its index in the pack, -1 if no pack is loaded
+//   count  → puzzles in the pack
+//   tried  → cell of the last answer, -1 if none yet
+//   solved → the last answer was right
+//   misses → wrong answers so far on this puzzle
+//
+struct PuzzleView {
+  PuzzleEntry puzzle = {};
+  int index = -1;
+  int count = 0;
+  int tried = -1;
+  bool solved = false;
+  int misses = 0;
+};
+
+// ============================================================================
+// STRUCT: ReplayView
+// ============================================================================
+// State of the replay scene. The game on screen is a copy of a decoded
+// archive record, so snapshots never reach into the streamer's ring.
+//
+// MEMBER VARIABLES:
+//   game  → the game on screen (valid only if shown)
+//   shown → a game has been fetched since the scene was entered
+//   want  → index of the game asked for; differs from game.index while the
+//           streamer is still reading it
+//   ply   → moves of `game` shown on the board
+//   count → games in the archive, 0 if there is none
+//   size  → board side of the archive
+//   recording → drawn for --export: no buttons or key reminder
+//
+struct ReplayView {
+  ArchivedGame game;
+  bool shown = false;
+  uint32_t want = 0;
+  int ply = 0;
+  uint32_t count = 0;
+  int size = 3;
+  bool recording = false;
+};
+
+// ============================================================================
+// STRUCT: BlitzView
+// ============================================================================
+// State of the blitz scene, which plays on the classic board fields. The
+// clock is a plain copy in every snapshot: the render thread works out the
+// time left from it and the current time, so the display never depends on
+// how often the logic thread steps.
+//
+// MEMBER VARIABLES:
+//   clock   → both players' time; side 0 is X
+//   preset  → index into BLITZ_PRESETS
+//   flagged → player who lost on time, 0 if none
+//   lagWorst → longest a move waited between its click being polled and
+//             being handled, in ns (time the clock did not charge)
+//
+struct BlitzView {
+  GameClock clock;
+  int preset = 1;
+  int flagged = 0;
+  int64_t lagWorst = 0;
+};
+
+// ============================================================================
+// STRUCT: VariantView
+// ============================================================================
+// State of the variant scene: one board per rule variant (their types
+// differ), of which `variant` is on screen.
+//
+// MEMBER VARIABLES:
+//   variant → index into VARIANTS
+//   mark    → mark the next move places where the rules let players
+//             choose (0 = X, 1 = O)
+//   wild / misere / orderChaos → the boards
+//
+struct VariantView {
+  int variant = 0;
+  int mark = 0;
+  VariantBoard<WildRules> wild;
+  VariantBoard<MisereRules> misere;
+  VariantBoard<OrderChaosRules> orderChaos;
+};
+
+// ============================================================================
+// STRUCT: AnalysisView
+// ============================================================================
+// The classic game's analysis overlay: the value of every empty cell for
+// the side to move (see src/analysis.h), which DrawBoard() shows as a tint.
+// Values are refreshed by the logic thread only when the board changes.
+//
+// MEMBER VARIABLES:
+//   on    → overlay shown (toggled with A)
+//   key   → Key() of the board the values belong to, -1 if none
+//   value → per cell: Analyser value, ANALYSIS_NONE if occupied
+//
+struct AnalysisView {
+  bool on = false;
+  int key = -1;
+  int8_t value[9] = {0};
+
+  // The 3×3 cells as a base-3 number; one per position.
+  static int Key(const int *board) {
+    int k = 0;
+    for (int i = 0; i < 9; i++)
+      k = k * 3 + board[i];
+    return k;
+  }
+};
+
 // ============================================================================
 // STRUCT: GameState
 // ============================================================================
 // Holds **all mutable game state** used during gameplay and scene transitions.
 // This allows all functions to receive & modify shared game data cleanly.
+//
+// The logic thread owns the one mutable GameState. The render thread only
+// ever sees immutable copies ("snapshots") published through a TripleBuffer,
+// which is why the struct must stay trivially copyable.
 // ----------------------------------------------------------------------------
 //
 // MEMBER VARIABLES:
@@ -51,6 +320,33 @@ enum Player { EMPTY = 0, PLAYER_X = 1, PLAYER_O = 2 };
 // turn          → whose turn it is (PLAYER_X / PLAYER_O)
 // winner        → winner of the round (1,2) or draw (3)
 // mousePos      → stores latest mouse cursor position
+// clicked       → true while a left click at mousePos is being handled
+// key           → raylib key code being handled this step, 0 if none
+// inputTime     → MonotonicNs() when the click or key being handled was
+//                 polled; the time of the step when there is none
+// history       → move stack for undo/redo and the timeline scrubber
+// archived      → the finished game has been appended to the game archive
+// vsCpu         → true when one side is played by the CPU opponent
+// cpuPlayer     → which side the CPU plays (PLAYER_X / PLAYER_O)
+// cpuMoved      → true once the CPU has moved this game (cpuStats is valid)
+// cpuStats      → how the CPU found its last move (book / search depth...)
+// cpuAskedHash  → hash of the position last sent to an external engine
+// analysis      → per-cell outcome overlay of the classic game
+// quit          → set by the EXIT button; the render thread closes the window
+// fade          → 0..1 cover drawn over the scene by a running transition
+//                 script; input is ignored while it is non-zero
+// infinite      → camera and last move of the infinite-board mode, which
+//                 also uses turn / gameOver / winner
+// gravity       → board of the gravity mode (same shared fields, plus
+//                 vsCpu / cpuPlayer)
+// notakto       → boards of the Notakto mode (same shared fields)
+// quantum       → marks of the quantum mode (same shared fields; turn is
+//                 the player who must act, including choosing a collapse)
+// puzzle        → the puzzle on screen in the puzzle scene
+// replay        → archived game and ply shown by the replay scene
+// blitz         → clocks of the blitz mode (board fields as in the classic
+//                 game)
+// variant       → boards of the rule variants scene
 //
 struct GameState {
   SceneName scene = SCENE_MENU;
@@ -63,80 +359,392 @@ struct GameState {
   int winner = 0;
 
   Vector2 mousePos;
+  bool clicked = false;
+  int key = 0;
+  int64_t inputTime = 0;
+
+  MoveStack history;
+  bool archived = false;
+
+  bool vsCpu = false;
+  int cpuPlayer = PLAYER_O;
+  bool cpuMoved = false;
+  AiStats cpuStats;
+  uint64_t cpuAskedHash = 0;
+  AnalysisView analysis;
+
+  bool quit = false;
+  float fade = 0.0f;
+
+  InfiniteView infinite;
+  GravityView gravity;
+  NotaktoView notakto;
+  QuantumView quantum;
+  PuzzleView puzzle;
+  ReplayView replay;
+  BlitzView blitz;
+  VariantView variant;
+};
+
+// ============================================================================
+// STRUCT: InputEvent
+// ============================================================================
+// One left click or key press captured by the render thread (which owns the
+// window and therefore raylib's input polling) and handed to the logic
+// thread.
+//
+// MEMBER VARIABLES:
+//   pos  → mouse position at the time of a click
+//   key  → raylib key code of a key press, 0 for a click
+//   time → MonotonicNs() of the frame's input poll that delivered it; game
+//          clocks charge moves up to here, not up to when they are handled
+//
+struct InputEvent {
+  Vector2 pos;
+  int key;
+  int64_t time;
+};
+
+// ============================================================================
+// STRUCT: Snapshot
+// ============================================================================
+// One published frame: a GameState copy plus the dynamic HUD text and
+// scene data the logic thread prepared for it. Each of the TripleBuffer's
+// three slots owns its own arena, which the logic thread resets and refills
+// just before publishing the slot, so strings and arrays handed to the
+// render thread stay valid exactly as long as the snapshot that points at
+// them and never touch the heap.
+//
+// MEMBER VARIABLES:
+//   state      → the game state to draw
+//   arena      → owns this slot's strings and arrays
+//   cpuLine    → how the CPU found its last move, "" when there is nothing
+//                to show
+//   stones     → infinite mode: stones inside the viewport, in viewport
+//                cells (col, row), stoneCount of them
+//
+struct ViewStone {
+  int8_t col, row;
+  uint8_t player;
+};
+
+struct Snapshot {
+  GameState state;
+  LinearArena arena{1024};
+  const char *cpuLine = "";
+  const ViewStone *stones = nullptr;
+  int stoneCount = 0;
+};
+
+// ============================================================================
+// STRUCT: FrameLink
+// ============================================================================
+// Everything the render thread and the logic thread share. No member is
+// protected by a lock, so neither thread can ever stall the other:
+//
+//   input     → clicks, render thread → logic thread
+//   snapshots → immutable Snapshots, logic thread → render thread
+//   observed  → the live GameState for any number of observer threads
+//               (spectator overlay, metrics, debug UI); updated by the logic
+//               thread whenever the state changed, sampled without ever
+//               delaying it
+//   running   → cleared by the render thread when the window closes
+//
+struct FrameLink {
+  SpscQueue<InputEvent, 64> input;
+  TripleBuffer<Snapshot> snapshots;
+  SeqLock<GameState> observed;
+  std::atomic<bool> running{true};
+};
+
+// ============================================================================
+// AUDIO COMMANDS
+// ============================================================================
+// Game code never calls the raylib audio API. It posts commands to AudioLoop()
+// on the audio thread, which owns the audio device and every Sound; posting
+// is one wait-free SPSC push, so audio can never stall a logic step or frame.
+//
+//   Sfx          → the sound effects, by id (AudioLoop() holds the Sounds)
+//   Track        → the streamed background music, one track per scene
+//   AudioOp      → what to do: play / stop one effect, set its volume, set
+//                  the master volume, or crossfade to another music track
+//   AudioCommand → one queued operation; value is a volume in 0..1
+//   AudioLink    → the queue (logic thread → audio thread), the stop flag and
+//                  how many commands were dropped because the queue was full
+//
+enum Sfx { SFX_PRESS, SFX_PLACE, SFX_WIN, SFX_COUNT };
+
+enum Track { TRACK_NONE, TRACK_MENU, TRACK_GAME, TRACK_CREDITS, TRACK_COUNT };
+
+enum AudioOp {
+  AUDIO_PLAY,
+  AUDIO_STOP,
+  AUDIO_SFX_VOLUME,
+  AUDIO_MASTER_VOLUME,
+  AUDIO_MUSIC
+};
+
+struct AudioCommand {
+  AudioOp op;
+  Sfx sfx;
+  Track track;
+  float value;
+};
+
+struct AudioLink {
+  SpscQueue<AudioCommand, 64> commands;
+  std::atomic<bool> running{true};
+  std::atomic<uint64_t> dropped{0};
+
+  // Logic thread only. A full queue drops the command rather than wait: a
+  // missing click sound is better than a late frame.
+  bool Post(AudioOp op, Sfx sfx = SFX_PRESS, float value = 1.0f,
+            Track track = TRACK_NONE) {
+    if (commands.Push(AudioCommand{op, sfx, track, value}))
+      return true;
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+};
+
+// ============================================================================
+// ENUM: TextureId
+// ============================================================================
+// Every texture the game can draw, as an index into TEXTURE_FILES and a bit
+// in a scene's texture mask (see SceneDesc).
+//
+enum TextureId {
+  TEX_BG_LIGHT,
+  TEX_BG_DARK,
+  TEX_MENU_TITLE_LIGHT,
+  TEX_MENU_TITLE_DARK,
+  TEX_BUTTON_LIGHT,
+  TEX_BUTTON_DARK,
+  TEX_TILE_BLANK,
+  TEX_TILE_X,
+  TEX_TILE_O,
+  TEX_COUNT
+};
+
+constexpr uint32_t TextureBit(TextureId t) { return 1u << t; }
+
+// ============================================================================
+// STRUCT: GlyphQuads
+// ============================================================================
+// Atlas rectangles and metrics of the few characters the quantum board draws
+// as marks ("x", "o" and the digits), looked up once in raylib's default
+// font. DrawText() decodes UTF-8, searches the font's glyph list for every
+// character and measures as it goes; a mark drawn from here is one textured
+// quad per character, all from the same atlas, so a board full of marks
+// stays in a single raylib batch.
+//
+// MEMBER VARIABLES:
+//   atlas   → the font texture (owned by raylib)
+//   src     → atlas rectangle of each character, padding included
+//   offset  → glyph offset from the pen position, in font units
+//   advance → pen advance after the glyph, in font units
+//   base    → font height the metrics are for
+//
+struct GlyphQuads {
+  static constexpr int COUNT = 12; // x, o, 0..9
+
+  Texture2D atlas = {};
+  Rectangle src[COUNT] = {};
+  Vector2 offset[COUNT] = {};
+  float advance[COUNT] = {};
+  float base = 10;
+
+  static int Index(char ch) {
+    return ch == 'x' ? 0 : ch == 'o' ? 1 : 2 + (ch - '0');
+  }
+
+  // Render thread, after InitWindow() (which loads the default font).
+  void Build(Font font) {
+    static const char CHARS[COUNT + 1] = "xo0123456789";
+    atlas = font.texture;
+    base = (float)font.baseSize;
+    float pad = (float)font.glyphPadding;
+    for (int i = 0; i < COUNT; i++) {
+      int g = GetGlyphIndex(font, CHARS[i]);
+      Rectangle r = font.recs[g];
+      src[i] = {r.x - pad, r.y - pad, r.width + 2 * pad, r.height + 2 * pad};
+      offset[i] = {font.glyphs[g].offsetX - pad, font.glyphs[g].offsetY - pad};
+      advance[i] = font.glyphs[g].advanceX ? (float)font.glyphs[g].advanceX
+                                           : r.width;
+    }
+  }
+
+  // Draw `ch` with its pen at `pos` and text height `size`; returns the
+  // pen position for the next character (spacing as DrawText()).
+  float Draw(char ch, Vector2 pos, float size, Color tint) const {
+    int i = Index(ch);
+    float k = size / base;
+    DrawTexturePro(atlas, src[i],
+                   {pos.x + offset[i].x * k, pos.y + offset[i].y * k,
+                    src[i].width * k, src[i].height * k},
+                   {0, 0}, 0, tint);
+    return pos.x + (advance[i] + 1) * k;
+  }
 };
 
 // ============================================================================
 // STRUCT: Assets
 // ============================================================================
-// Holds **all loaded textures and sounds** used in the game.
-// Centralizing assets prevents scattering textures/sounds across the program.
+// Holds the textures of the scenes currently on screen and the way to play
+// sounds. Centralizing assets prevents scattering textures/sounds across the
+// program.
+//
+// Textures are reference-counted per scene: entering a scene acquires the
+// textures in its mask (loading those not yet resident), leaving it releases
+// them (unloading those no other scene holds). A texture that is not
+// resident has id 0, which raylib draws as nothing.
 //
 // MEMBER VARIABLES:
 //   bgLight / bgDark       → background images for themes
 //   menuTitleLight/Dark    → title images for menu
 //   buttonLight/Dark       → button textures
 //   tileBlank/X/O          → board tile textures
-//   sndPress / sndPlace / sndWin → audio effects
+//   glyphs                 → cached quads of the quantum board's marks
+//   refs[TEX_COUNT]        → how many entered scenes hold each texture
+//   audio                  → command queue of the audio thread, which owns
+//                            the sound effects (see PlaySfx())
 //
 struct Assets {
   Texture2D bgLight, bgDark;
   Texture2D menuTitleLight, menuTitleDark;
   Texture2D buttonLight, buttonDark;
   Texture2D tileBlank, tileX, tileO;
+  GlyphQuads glyphs;
+  int refs[TEX_COUNT] = {0};
+
+  AudioLink *audio = nullptr;
+};
+
+// Play a sound effect from game logic (logic thread; wait-free).
+void PlaySfx(const Assets &A, Sfx sfx) { A.audio->Post(AUDIO_PLAY, sfx); }
+
+// ============================================================================
+// TABLE: TEXTURE_FILES
+// ============================================================================
+// Which file under resources/ each texture comes from, indexed by TextureId.
+// AcquireTextures() loads from it and the --dev hot reloader uses it to find
+// the texture a changed file belongs to.
+//
+struct TextureFile {
+  const char *file;
+  Texture2D Assets::*texture;
+};
 
-  Sound sndPress, sndPlace, sndWin;
+static const TextureFile TEXTURE_FILES[TEX_COUNT] = {
+    // Theme backgrounds
+    {"BackgroundLight.png", &Assets::bgLight},
+    {"BackgroundDark.png", &Assets::bgDark},
+    // Menu titles
+    {"MenuTitleLight.png", &Assets::menuTitleLight},
+    {"MenuTitleDark.png", &Assets::menuTitleDark},
+    // Button skins
+    {"ButtonLight.png", &Assets::buttonLight},
+    {"ButtonDark.png", &Assets::buttonDark},
+    // Tile graphics
+    {"BlankTile.png", &Assets::tileBlank},
+    {"Cross.png", &Assets::tileX},
+    {"Circle.png", &Assets::tileO},
 };
 
 // ============================================================================
-// FUNCTION: LoadAssets
+// FUNCTIONS: AcquireTextures / ReleaseTextures
 // ============================================================================
 // ============= Objective =============
-// Load all textures and sound effects used in the game at startup.
+// Take or drop one reference on every texture in `mask`.
 //
 // ============= Input Parameters =============
-// None.
-//
-// ============= Output =============
-// Returns an Assets struct containing all loaded textures/sounds.
-//
-// ============= Return Value =============
-// Assets → holds all game textures and sound buffers
+// Assets &A     → textures and their reference counts
+// uint32_t mask → TextureBit()s of the textures a scene draws
 //
 // ============= Side Effects =============
-// - Loads textures from disk into GPU memory.
-// - Loads sound data into RAM.
-// - If files are missing or corrupt, raylib may crash or show missing textures.
+// - Acquire loads a texture from disk into GPU memory on its first
+//   reference; Release unloads it when the last reference goes.
+// - Render thread only (GL calls).
 //
 // ============= Approach =============
-// A single function returns a fully populated struct, making it easier to pass
-// assets around all scenes and keep code organized.
+// Callers acquire the next scene's textures before releasing the previous
+// scene's, so textures both scenes share (backgrounds, buttons) stay
+// resident across the switch.
 //
-Assets LoadAssets() {
-  Assets A;
-
-  // Load theme backgrounds
-  A.bgLight = LoadTexture("resources/BackgroundLight.png");
-  A.bgDark = LoadTexture("resources/BackgroundDark.png");
+void AcquireTextures(Assets &A, uint32_t mask) {
+  for (int t = 0; t < TEX_COUNT; t++)
+    if ((mask & TextureBit((TextureId)t)) && A.refs[t]++ == 0)
+      A.*TEXTURE_FILES[t].texture =
+          LoadTexture(TextFormat("resources/%s", TEXTURE_FILES[t].file));
+}
 
-  // Load menu titles
-  A.menuTitleLight = LoadTexture("resources/MenuTitleLight.png");
-  A.menuTitleDark = LoadTexture("resources/MenuTitleDark.png");
+void ReleaseTextures(Assets &A, uint32_t mask) {
+  for (int t = 0; t < TEX_COUNT; t++)
+    if ((mask & TextureBit((TextureId)t)) && --A.refs[t] == 0) {
+      UnloadTexture(A.*TEXTURE_FILES[t].texture);
+      A.*TEXTURE_FILES[t].texture = Texture2D{};
+    }
+}
 
-  // Load button skins
-  A.buttonLight = LoadTexture("resources/ButtonLight.png");
-  A.buttonDark = LoadTexture("resources/ButtonDark.png");
+// ============================================================================
+// FUNCTIONS: DecodeImageFile / ReleaseImage
+// ============================================================================
+// Decode and free callbacks for the --dev hot reloader. They run on its
+// watcher thread: LoadImage() only reads the file and decodes it into RAM,
+// no GL calls, so it is safe away from the render thread.
+//
+static bool DecodeImageFile(const char *path, Image *out) {
+  *out = LoadImage(path);
+  return IsImageValid(*out);
+}
 
-  // Load tile graphics
-  A.tileBlank = LoadTexture("resources/BlankTile.png");
-  A.tileX = LoadTexture("resources/Cross.png");
-  A.tileO = LoadTexture("resources/Circle.png");
+static void ReleaseImage(Image *image) { UnloadImage(*image); }
 
-  // Load sound effects
-  A.sndPress = LoadSound("resources/BtnPress.wav");
-  A.sndPlace = LoadSound("resources/Place.wav");
-  A.sndWin = LoadSound("resources/Win.wav");
+// ============================================================================
+// FUNCTION: ApplyHotReload
+// ============================================================================
+// ============= Objective =============
+// Install at most one re-decoded resource per frame (--dev mode).
+//
+// ============= Input Parameters =============
+// Assets &A                     → textures to update
+// HotReloader<Image> &reloader  → source of decoded images
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - Uploads one image to the GPU and frees the texture it replaces.
+//
+// ============= Approach =============
+// Called on the render thread between EndDrawing() and the next frame, so no
+// draw call can see a half-swapped texture, and the frame pays for a single
+// texture upload at most; decoding already happened on the watcher thread.
+// The logic thread shares Assets too, but only reads the audio pointer,
+// which this never touches.
+//
+void ApplyHotReload(Assets &A, HotReloader<Image> &reloader) {
+  HotReload<Image> r;
+  if (!reloader.Poll(r))
+    return;
 
-  return A;
+  for (int i = 0; i < TEX_COUNT; i++) {
+    const TextureFile &t = TEXTURE_FILES[i];
+    if (!TextIsEqual(r.name, t.file))
+      continue;
+    // Not resident: the next scene that needs it loads the new file anyway.
+    if (!A.refs[i])
+      break;
+    Texture2D fresh = LoadTextureFromImage(r.data);
+    if (IsTextureValid(fresh)) {
+      Texture2D old = A.*t.texture;
+      A.*t.texture = fresh;
+      UnloadTexture(old);
+      TraceLog(LOG_INFO, "HOTRELOAD: %s", r.name);
+    }
+    break;
+  }
+  UnloadImage(r.data);
 }
 
 // ============================================================================
@@ -168,6 +776,9 @@ void ResetBoard(GameState &G) {
   G.turn = PLAYER_X;
   G.winner = 0;
   G.gameOver = false;
+  G.cpuMoved = false;
+  G.history = MoveStack();
+  G.archived = false;
 }
 
 // ============================================================================
@@ -179,7 +790,6 @@ void ResetBoard(GameState &G) {
 //
 // ============= Input Parameters =============
 // GameState &G → game state holding board values and winner flags
-// const Assets &A → provides access to sound effects for win/draw
 //
 // ============= Output =============
 // Updates G.winner and G.gameOver when a win or draw is detected.
@@ -188,8 +798,8 @@ void ResetBoard(GameState &G) {
 // None.
 //
 // ============= Side Effects =============
-// - Plays sound A.sndWin on win or draw.
-// - Modifies G.board, G.winner, G.gameOver.
+// - Modifies G.winner, G.gameOver. Silent, so that redo and timeline jumps
+//   can replay moves; PlaceMark() plays the win sound.
 //
 // ============= Approach =============
 // - Define an array containing all 8 possible winning triplets.
@@ -198,7 +808,7 @@ void ResetBoard(GameState &G) {
 // - If found: set winner and trigger game over.
 // - If board is full and no winner exists: declare draw.
 // ----------------------------------------------------------------------------
-void CheckWinner(GameState &G, const Assets &A) {
+void CheckWinner(GameState &G) {
   // All 8 winning lines: 3 rows, 3 columns, 2 diagonals.
   const int WINS[8][3] = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}, {0, 3, 6},
                           {1, 4, 7}, {2, 5, 8}, {0, 4, 8}, {2, 4, 6}};
@@ -213,9 +823,6 @@ void CheckWinner(GameState &G, const Assets &A) {
       // Set winner to X or O depending on tile value.
       G.winner = G.board[a];
       G.gameOver = true;
-
-      // Play win sound.
-      PlaySound(A.sndWin);
       return;
     }
   }
@@ -229,148 +836,528 @@ void CheckWinner(GameState &G, const Assets &A) {
   if (full) {
     G.winner = 3; // 3 means draw
     G.gameOver = true;
-    PlaySound(A.sndWin);
   }
 }
 
 // ============================================================================
-// FUNCTION: HandleGameInput
+// STRUCT: GameBoard
+// ============================================================================
+// Adapter giving GameState the Make / Unmake / Result interface of the
+// engines' Board, so the game's undo, redo and timeline jumps use the same
+// MoveStack helpers (PlayMove, UndoMove, RedoMove, SeekPly from board.h) as
+// the search code. Every operation is O(1) on the 3×3 grid.
+//
+// G.winner uses the engines' result codes: 0 none, 1 X, 2 O, 3 draw.
+//
+struct GameBoard {
+  GameState &G;
+
+  int Result() const { return G.winner; }
+
+  void Make(int cell) {
+    G.board[cell] = G.turn;
+    G.turn = (G.turn == PLAYER_X ? PLAYER_O : PLAYER_X);
+    CheckWinner(G);
+  }
+
+  void Unmake(int cell, int prevWinner) {
+    G.board[cell] = EMPTY;
+    G.turn = (G.turn == PLAYER_X ? PLAYER_O : PLAYER_X);
+    G.winner = prevWinner;
+    G.gameOver = prevWinner != 0;
+  }
+};
+
+// ============================================================================
+// FUNCTION: PlaceMark
 // ============================================================================
 // ============= Objective =============
-// Handle tile-clicking input from the user during gameplay.
-// Allows players to place X or O on the board.
+// Place the current player's symbol on a cell and advance the game.
+// Shared by human clicks (HandleGameInput) and the CPU (HandleCpuTurn).
 //
 // ============= Input Parameters =============
-// GameState &G → reference to game state for board/turn updates
+// GameState &G → game state to update
 // const Assets &A → contains placement sound effect
+// int idx → board cell (0–8), must be EMPTY
 //
 // ============= Output =============
-// Directly modifies G.board, G.turn, G.pressed.
+// Directly modifies G.board, G.turn, G.history and (via CheckWinner)
+// G.winner/gameOver.
 //
 // ============= Return Value =============
 // None.
 //
 // ============= Side Effects =============
-// - Plays tile placement sound.
-// - Mutates global game state.
-// - Changes turn order.
+// - Plays tile placement sound (and win sound if the move ends the game).
+// - Discards any undone moves that could still have been redone.
+// - A game this move finishes is a new game for the archive.
 //
 // ============= Approach =============
-// - Prevent repeated clicks using G.pressed (debouncing).
-// - Detect which tile was clicked by matching mouse position to tile bounds.
-// - If clicked tile is empty: place symbol, switch turn.
-// - Call CheckWinner() to update game status.
+// Record the move on the move stack and apply it (place symbol, switch
+// turn, CheckWinner()) through GameBoard, then play the sounds.
 // ----------------------------------------------------------------------------
-void HandleGameInput(GameState &G, const Assets &A) {
-  // Clicking too quickly? Debounce.
-  if (G.pressed)
-    return;
+void PlaceMark(GameState &G, const Assets &A, int idx) {
+  // Place X or O and remember the move for undo.
+  GameBoard pos{G};
+  PlayMove(pos, G.history, idx);
+  G.archived = false;
 
-  // Must be an actual click.
-  if (!IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
-    return;
+  // Play tile placement sound.
+  PlaySfx(A, SFX_PLACE);
 
-  // Do not accept clicks after game ended.
+  // Play win sound if this move ended the game.
   if (G.gameOver)
-    return;
-
-  // Precomputed tile X positions for 3 columns.
-  float xs[3] = {12.5f, 112.5f, 212.5f};
-
-  // Precomputed tile Y positions for 3 rows.
-  float ys[3] = {62.5f, 162.5f, 262.5f};
-
-  // Loop through each cell of the 3×3 board.
-  for (int r = 0; r < 3; r++)
-    for (int c = 0; c < 3; c++) {
-      int idx = r * 3 + c;
-
-      float x = xs[c];
-      float y = ys[r];
-
-      // Check if mouse is inside this tile rectangle.
-      if (G.mousePos.x >= x && G.mousePos.x <= x + 75 && G.mousePos.y >= y &&
-          G.mousePos.y <= y + 75 && G.board[idx] == EMPTY) {
-        // Place X or O.
-        G.board[idx] = G.turn;
-
-        // Play tile placement sound.
-        PlaySound(A.sndPlace);
-
-        // Switch turn.
-        G.turn = (G.turn == PLAYER_X ? PLAYER_O : PLAYER_X);
-
-        // Check if this move wins the game.
-        CheckWinner(G, A);
-
-        // Mark click as consumed.
-        G.pressed = true;
-        return;
-      }
-    }
+    PlaySfx(A, SFX_WIN);
 }
 
 // ============================================================================
-// FUNCTION: DrawBoard
+// FUNCTION: HandleTimelineInput
 // ============================================================================
 // ============= Objective =============
-// Render the 3×3 grid of Tic-Tac-Toe tiles with their current states.
+// Undo, redo and jump to any ply of the current game.
 //
 // ============= Input Parameters =============
-// GameState &G → provides board layout
-// const Assets &A → provides tile textures
+// GameState &G → game state with the move history
+// const Assets &A → click sound
+// AiPlayer &ai → stopped from pondering on a position we left
+// EngineClient &engine → asked to stop if it is thinking
 //
 // ============= Output =============
-// Draws textures to the screen.
+// Moves G along its history; the board, turn and result follow.
 //
 // ============= Return Value =============
 // None.
 //
 // ============= Side Effects =============
-// - Renders textures directly to GPU buffer.
+// - Plays the click sound and marks the click as consumed.
 //
 // ============= Approach =============
-// - Convert board indices (0–8) into row/column.
-// - Compute drawing offsets.
-// - Draw texture depending on tile state.
+// - Keys: LEFT = undo, RIGHT = redo, HOME = start, END = latest move.
+// - Arrow buttons left and right of the board's bottom edge undo / redo.
+// - While the game runs, clicking the scrubber under the board jumps
+//   straight to the clicked ply (SeekPly, one O(1) step per ply).
+// - Viewing an earlier ply is a preview: nothing is discarded until a new
+//   mark is placed there, and the CPU waits (see HandleCpuTurn()).
 // ----------------------------------------------------------------------------
-void DrawBoard(GameState &G, const Assets &A) {
-  // Precomputed offsets relative to screen center.
-  float startX[3] = {-137.5f, -37.5f, 62.5f};
-  float startY[3] = {-137.5f, -37.5f, 62.5f};
+void HandleTimelineInput(GameState &G, const Assets &A, AiPlayer &ai,
+                         EngineClient &engine) {
+  MoveStack &h = G.history;
+  int target = h.ply;
 
-  // Draw each of the 9 tiles.
-  for (int i = 0; i < 9; i++) {
-    int r = i / 3; // row index
-    int c = i % 3; // column index
+  if (G.key == KEY_LEFT)
+    target = h.ply - 1;
+  else if (G.key == KEY_RIGHT)
+    target = h.ply + 1;
+  else if (G.key == KEY_HOME)
+    target = 0;
+  else if (G.key == KEY_END)
+    target = h.end;
 
-    float x = GetScreenWidth() / 2 + startX[c];
-    float y = GetScreenHeight() / 2 + startY[r];
+  if (G.clicked && !G.pressed && G.mousePos.y >= 345 && G.mousePos.y <= 395) {
+    float x = G.mousePos.x;
+    if (x >= 5 && x <= 45)
+      target = h.ply - 1; // undo arrow
+    else if (x >= 255 && x <= 295)
+      target = h.ply + 1; // redo arrow
+    else if (!G.gameOver && x >= 50 && x <= 250 && G.mousePos.y <= 375)
+      target = (int)((x - 60.0f) / 20.0f + 0.5f); // scrubber tick
+    else
+      return;
+    G.pressed = true;
+  }
 
-    // Draw empty tile.
-    if (G.board[i] == EMPTY)
-      DrawTexture(A.tileBlank, x, y, WHITE);
+  if (target < 0)
+    target = 0;
+  if (target > h.end)
+    target = h.end;
+  if (target == h.ply)
+    return;
 
-    // Draw X.
-    else if (G.board[i] == PLAYER_X)
-      DrawTexture(A.tileX, x, y, MAROON);
+  GameBoard pos{G};
+  SeekPly(pos, h, target);
 
-    // Draw O.
-    else
-      DrawTexture(A.tileO, x, y, BLUE);
-  }
+  // Whatever the CPU was thinking about is no longer the position.
+  ai.StopPondering();
+  if (engine.Busy())
+    engine.Stop();
+  PlaySfx(A, SFX_PRESS);
 }
 
 // ============================================================================
-// FUNCTION: DrawGameScene
+// FUNCTION: TileAt
+// ============================================================================
+// Index (0–8) of the 75×75 board tile under `pos`, -1 if none. Shared by the
+// classic and quantum modes, which draw the board with DrawBoard().
+// ----------------------------------------------------------------------------
+int TileAt(Vector2 pos) {
+  // Precomputed tile X positions for 3 columns.
+  float xs[3] = {12.5f, 112.5f, 212.5f};
+
+  // Precomputed tile Y positions for 3 rows.
+  float ys[3] = {62.5f, 162.5f, 262.5f};
+
+  for (int r = 0; r < 3; r++)
+    for (int c = 0; c < 3; c++)
+      if (pos.x >= xs[c] && pos.x <= xs[c] + 75 && pos.y >= ys[r] &&
+          pos.y <= ys[r] + 75)
+        return r * 3 + c;
+  return -1;
+}
+
+// ============================================================================
+// FUNCTION: HandleGameInput
 // ============================================================================
 // ============= Objective =============
-// Render the entire game screen: background, turn indicator, grid lines,
+// Handle tile-clicking input from the user during gameplay.
+// Allows players to place X or O on the board.
+//
+// ============= Input Parameters =============
+// GameState &G → reference to game state for board/turn updates
+// const Assets &A → contains placement sound effect
+//
+// ============= Output =============
+// Directly modifies G.board, G.turn, G.pressed.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - Plays tile placement sound.
+// - Mutates global game state.
+// - Changes turn order.
+//
+// ============= Approach =============
+// - Prevent repeated clicks using G.pressed (debouncing).
+// - Detect which tile was clicked by matching mouse position to tile bounds.
+// - If clicked tile is empty: place symbol via PlaceMark().
+// - Ignore clicks while it is the CPU's turn.
+// ----------------------------------------------------------------------------
+void HandleGameInput(GameState &G, const Assets &A) {
+  // Clicking too quickly? Debounce.
+  if (G.pressed)
+    return;
+
+  // The CPU is about to move; the human must wait.
+  if (G.vsCpu && G.turn == G.cpuPlayer)
+    return;
+
+  // Must be an actual click.
+  if (!G.clicked)
+    return;
+
+  // Do not accept clicks after game ended.
+  if (G.gameOver)
+    return;
+
+  // Which tile is under the mouse?
+  int idx = TileAt(G.mousePos);
+  if (idx >= 0 && G.board[idx] == EMPTY) {
+    // Place X or O, switch turn and check for a result.
+    PlaceMark(G, A, idx);
+
+    // Mark click as consumed.
+    G.pressed = true;
+  }
+}
+
+// ============================================================================
+// FUNCTION: HandleCpuTurn
+// ============================================================================
+// ============= Objective =============
+// Let the CPU opponent play its move when it is the CPU's turn.
+//
+// ============= Input Parameters =============
+// GameState &G → game state (board, turn, vsCpu flags)
+// const Assets &A → sounds played by PlaceMark()
+// AiPlayer &ai → built-in CPU opponent (book + search)
+// EngineClient &engine → external engine; used instead of `ai` when running
+//
+// ============= Output =============
+// Places one mark on G.board when it is the CPU's turn.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - Same as PlaceMark().
+//
+// ============= Approach =============
+// - Only act in VS CPU mode, while the game runs, on the CPU's turn and at
+//   the end of the timeline (not while the player previews an earlier ply).
+// - Convert G.board into an engine Board.
+// - External engine: send the position once, then poll every frame without
+//   blocking until "bestmove" arrives, so rendering never waits on it. A
+//   reply for a position we have since left through undo/redo is dropped.
+// - Built-in AI: ask for a cell directly. The opening book answers
+//   instantly; otherwise a short search runs.
+// ----------------------------------------------------------------------------
+void HandleCpuTurn(GameState &G, const Assets &A, AiPlayer &ai,
+                   EngineClient &engine) {
+  bool cpuToMove = G.vsCpu && !G.gameOver && G.turn == G.cpuPlayer &&
+                   !G.history.CanRedo();
+  if (!cpuToMove) {
+    // Drain a stale reply so it cannot be mistaken for a later one.
+    int stale;
+    if (engine.Busy())
+      engine.Poll(&stale);
+    return;
+  }
+
+  Board b = BoardFromCells(G.board, 3, 3);
+  int move = -1;
+
+  if (engine.Running()) {
+    if (!engine.Busy()) {
+      engine.Go(b, 500);
+      G.cpuAskedHash = b.hash;
+    }
+    if (!engine.Poll(&move))
+      return; // still thinking; check again next frame
+    if (b.hash != G.cpuAskedHash)
+      return; // answer to an earlier position; ask again next frame
+
+    // The engine reports its search through "info" lines.
+    unsigned long long nodes = 0;
+    G.cpuStats = AiStats();
+    sscanf(engine.LastInfo().c_str(), "info depth %d score %d nodes %llu",
+           &G.cpuStats.result.depth, &G.cpuStats.result.score, &nodes);
+    G.cpuStats.result.nodes = nodes;
+  } else {
+    move = ai.ChooseMove(b);
+    G.cpuStats = ai.LastStats();
+  }
+
+  if (move >= 0 && move < 9 && G.board[move] == EMPTY) {
+    G.cpuMoved = true;
+    PlaceMark(G, A, move);
+  }
+}
+
+// ============================================================================
+// FUNCTION: AnalysisTint
+// ============================================================================
+// Blank-tile tint for an analysis value: green for a win, red for a loss,
+// pale yellow for a draw. The sooner the game ends, the stronger the colour.
+// ----------------------------------------------------------------------------
+Color AnalysisTint(int value) {
+  if (value == 0)
+    return Color{250, 235, 160, 255};
+  float strength = 0.3f + 0.07f * (10 - AnalysisDistance(value));
+  return ColorLerp(WHITE, value > 0 ? GREEN : RED, strength);
+}
+
+// ============================================================================
+// FUNCTION: DrawBoard
+// ============================================================================
+// ============= Objective =============
+// Render the 3×3 grid of Tic-Tac-Toe tiles with their current states.
+//
+// ============= Input Parameters =============
+// const GameState &G → provides board layout
+// const Assets &A → provides tile textures
+// LinearArena &frame → per-frame arena for the draw list
+// const QuantumBoard *quantum → quantum mode: also draw its marks (optional)
+//
+// ============= Output =============
+// Draws textures to the screen.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - Renders textures directly to GPU buffer.
+//
+// ============= Approach =============
+// - Convert board indices (0–8) into row/column.
+// - Compute drawing offsets.
+// - Build a draw list in the frame arena, bucketed by texture (blank, X, O),
+//   then submit it in that order: raylib flushes its batch whenever the
+//   texture changes, so this costs at most 3 flushes instead of up to 9.
+// - Quantum mode: G.board holds the classical marks, which get their move
+//   number as a subscript; open tiles show their spooky marks ("x3") in a
+//   3×3 grid of 25 px slots, the mark waiting for a collapse in orange.
+//   Every character is a cached glyph quad from the font atlas (see
+//   GlyphQuads), so all marks together add one more batch.
+// - Analysis overlay (classic game): empty tiles are tinted by their value
+//   (AnalysisTint()) and a decided cell shows in how many plies the game
+//   ends, also as glyph quads. Tinting doesn't change the texture, so the
+//   blank tiles still share one batch. Values are only drawn when they
+//   belong to the board on screen.
+// ----------------------------------------------------------------------------
+void DrawBoard(const GameState &G, const Assets &A, LinearArena &frame,
+               const QuantumBoard *quantum = nullptr) {
+  // Precomputed offsets relative to screen center.
+  float startX[3] = {-137.5f, -37.5f, 62.5f};
+  float startY[3] = {-137.5f, -37.5f, 62.5f};
+
+  // Analysis values for this exact board?
+  const AnalysisView &an = G.analysis;
+  bool overlay = !quantum && an.on && an.key == AnalysisView::Key(G.board);
+
+  // One draw command per tile.
+  struct TileDraw {
+    Vector2 pos;
+    int state;
+    Color tint;
+  };
+  TileDraw *list = frame.Alloc<TileDraw>(9);
+  if (!list)
+    return;
+
+  // Counting sort by tile state: first index of each bucket.
+  int bucket[3] = {0, 0, 0};
+  for (int i = 0; i < 9; i++)
+    bucket[G.board[i]]++;
+  int next[3] = {0, bucket[0], bucket[0] + bucket[1]};
+
+  for (int i = 0; i < 9; i++) {
+    int r = i / 3; // row index
+    int c = i % 3; // column index
+
+    float x = GetScreenWidth() / 2 + startX[c];
+    float y = GetScreenHeight() / 2 + startY[r];
+    Color tint = overlay && an.value[i] != ANALYSIS_NONE
+                     ? AnalysisTint(an.value[i])
+                     : WHITE;
+    list[next[G.board[i]]++] = TileDraw{{x, y}, G.board[i], tint};
+  }
+
+  for (int i = 0; i < 9; i++) {
+    // Draw empty tile (tinted by the analysis overlay).
+    if (list[i].state == EMPTY)
+      DrawTexture(A.tileBlank, list[i].pos.x, list[i].pos.y, list[i].tint);
+
+    // Draw X.
+    else if (list[i].state == PLAYER_X)
+      DrawTexture(A.tileX, list[i].pos.x, list[i].pos.y, MAROON);
+
+    // Draw O.
+    else
+      DrawTexture(A.tileO, list[i].pos.x, list[i].pos.y, BLUE);
+  }
+
+  // Plies to the end of the game on every decided cell.
+  if (overlay)
+    for (int i = 0; i < 9; i++) {
+      int v = an.value[i];
+      if (v == ANALYSIS_NONE || v == 0)
+        continue;
+      float x = GetScreenWidth() / 2 + startX[i % 3];
+      float y = GetScreenHeight() / 2 + startY[i / 3];
+      A.glyphs.Draw((char)('0' + AnalysisDistance(v)), {x + 30, y + 22}, 30,
+                    Fade(BLACK, 0.55f));
+    }
+
+  if (!quantum)
+    return;
+  const GlyphQuads &glyphs = A.glyphs;
+  for (int i = 0; i < 9; i++) {
+    float x = GetScreenWidth() / 2 + startX[i % 3];
+    float y = GetScreenHeight() / 2 + startY[i / 3];
+
+    // Classical mark: its move number in the bottom-right corner.
+    if (int t = quantum->Classical(i)) {
+      glyphs.Draw((char)('0' + t), {x + 58, y + 52}, 20,
+                  G.board[i] == PLAYER_X ? MAROON : BLUE);
+      continue;
+    }
+
+    // Spooky marks, oldest first.
+    int slot = 0;
+    for (uint16_t m = quantum->Spooky(i); m; m &= m - 1, slot++) {
+      int t = __builtin_ctz(m);
+      Color ink = QuantumBoard::Owner(t) == RESULT_X ? MAROON : BLUE;
+      if (t == quantum->Pending())
+        ink = ORANGE;
+      Vector2 pen = {x + slot % 3 * 25 + 3, y + slot / 3 * 25 + 3};
+      pen.x = glyphs.Draw(t & 1 ? 'x' : 'o', pen, 20, ink);
+      glyphs.Draw((char)('0' + t), {pen.x, pen.y + 10}, 10, ink);
+    }
+  }
+}
+
+// ============================================================================
+// FUNCTION: DrawTimeline
+// ============================================================================
+// ============= Objective =============
+// Draw the undo / redo arrows and the move timeline scrubber.
+//
+// ============= Input Parameters =============
+// const GameState &G → move history and theme
+//
+// ============= Output =============
+// Arrows beside the bottom button area; while the game runs, one tick per
+// ply under the board with a knob on the ply being shown.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - Renders shapes to GPU buffer.
+//
+// ============= Approach =============
+// Hit areas match HandleTimelineInput(): arrows at x 5–45 / 255–295, ticks
+// 20 px apart starting at x = 60. Ticks past the recorded history are
+// hidden; undone (redoable) plies are drawn faded. Disabled arrows fade.
+// ----------------------------------------------------------------------------
+void DrawTimeline(const GameState &G) {
+  const MoveStack &h = G.history;
+  Color ink = G.darkMode ? WHITE : BLACK;
+  Color faded = Fade(ink, 0.25f);
+
+  // Undo arrow (pointing left) and redo arrow (pointing right).
+  DrawTriangle({15, 370}, {40, 385}, {40, 355}, h.CanUndo() ? ink : faded);
+  DrawTriangle({285, 370}, {260, 355}, {260, 385}, h.CanRedo() ? ink : faded);
+
+  if (G.gameOver)
+    return; // the PLAY AGAIN button occupies the middle
+
+  DrawLineEx({60, 360}, {60.0f + 20.0f * h.end, 360}, 2, faded);
+  for (int p = 0; p <= h.end; p++) {
+    Vector2 at = {60.0f + 20.0f * p, 360};
+    DrawCircleV(at, 4, p <= h.ply ? ink : faded);
+  }
+  DrawCircleV({60.0f + 20.0f * h.ply, 360}, 7,
+              G.turn == PLAYER_X ? MAROON : BLUE);
+}
+
+// ============================================================================
+// FUNCTION: DrawGrid
+// ============================================================================
+// The four bars between the 3×3 tiles, in the theme's colour.
+// ----------------------------------------------------------------------------
+void DrawGrid(const GameState &G) {
+  // Color depends on theme.
+  Color gridColor = G.darkMode ? GRAY : BLACK;
+
+  // Vertical Line 1
+  DrawRectangle(GetScreenWidth() / 2 - 55, GetScreenHeight() / 2 - 137, 10, 275,
+                gridColor);
+
+  // Vertical Line 2
+  DrawRectangle(GetScreenWidth() / 2 + 45, GetScreenHeight() / 2 - 137, 10, 275,
+                gridColor);
+
+  // Horizontal Line 1
+  DrawRectangle(GetScreenWidth() / 2 - 137, GetScreenHeight() / 2 - 55, 275, 10,
+                gridColor);
+
+  // Horizontal Line 2
+  DrawRectangle(GetScreenWidth() / 2 - 137, GetScreenHeight() / 2 + 45, 275, 10,
+                gridColor);
+}
+
+// ============================================================================
+// FUNCTION: DrawGameScene
+// ============================================================================
+// ============= Objective =============
+// Render the entire game screen: background, turn indicator, grid lines,
 // tiles, and "Play Again" button if game is finished.
 //
 // ============= Input Parameters =============
-// GameState &G → contains board, turn, winner, theme mode
+// const Snapshot &S → board, turn, winner, theme mode and HUD text
 // const Assets &A → provides textures/sounds for rendering
+// LinearArena &frame → per-frame arena, passed on to DrawBoard()
 //
 // ============= Output =============
 // Draws complete game scene to screen.
@@ -385,10 +1372,14 @@ void DrawBoard(GameState &G, const Assets &A) {
 // ============= Approach =============
 // - Draw background depending on dark/light mode.
 // - Draw turn text or winner text.
+// - While playing VS CPU, show how the CPU found its last move.
+// - Draw the undo/redo arrows and the timeline scrubber.
 // - Draw grid lines.
 // - Render all 9 tiles using DrawBoard().
 // ----------------------------------------------------------------------------
-void DrawGameScene(GameState &G, const Assets &A) {
+void DrawGameScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  const GameState &G = S.state;
+
   // Draw background theme.
   DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
 
@@ -404,6 +1395,11 @@ void DrawGameScene(GameState &G, const Assets &A) {
     else
       DrawText("O turn", 70, 5, 50, G.darkMode ? WHITE : BLACK);
 
+    // CPU diagnostics under the board, centered.
+    if (S.cpuLine[0])
+      DrawText(S.cpuLine, (GetScreenWidth() - MeasureText(S.cpuLine, 10)) / 2,
+               380, 10, G.darkMode ? LIGHTGRAY : DARKGRAY);
+
   } else {
     // Game over → show result.
 
@@ -423,42 +1419,29 @@ void DrawGameScene(GameState &G, const Assets &A) {
     DrawText("PLAY AGAIN", 60, 355, 30, G.darkMode ? WHITE : BLACK);
   }
 
+  // Undo/redo arrows and, while playing, the scrubber.
+  DrawTimeline(G);
+
   // ------------------------------------------------------------------------
   // Grid lines
   // ------------------------------------------------------------------------
-  // Color depends on theme.
-  Color gridColor = G.darkMode ? GRAY : BLACK;
-
-  // Vertical Line 1
-  DrawRectangle(GetScreenWidth() / 2 - 55, GetScreenHeight() / 2 - 137, 10, 275,
-                gridColor);
-
-  // Vertical Line 2
-  DrawRectangle(GetScreenWidth() / 2 + 45, GetScreenHeight() / 2 - 137, 10, 275,
-                gridColor);
-
-  // Horizontal Line 1
-  DrawRectangle(GetScreenWidth() / 2 - 137, GetScreenHeight() / 2 - 55, 275, 10,
-                gridColor);
-
-  // Horizontal Line 2
-  DrawRectangle(GetScreenWidth() / 2 - 137, GetScreenHeight() / 2 + 45, 275, 10,
-                gridColor);
+  DrawGrid(G);
 
   // ------------------------------------------------------------------------
   // Draw the 3×3 tiles
   // ------------------------------------------------------------------------
-  DrawBoard(G, A);
+  DrawBoard(G, A, frame);
 }
 
 // ============================================================================
 // FUNCTION: DrawMenu
 // ============================================================================
 // ============= Objective =============
-// Render the main menu with Play, Dark/Light Mode Toggle, Credits, and Exit.
+// Render the main menu with Play, VS CPU, Dark/Light Mode Toggle, Credits,
+// and Exit.
 //
 // ============= Input Parameters =============
-// GameState &G → for checking theme mode
+// const GameState &G → for checking theme mode
 // const Assets &A → contains menu textures
 //
 // ============= Output =============
@@ -473,9 +1456,9 @@ void DrawGameScene(GameState &G, const Assets &A) {
 // ============= Approach =============
 // - Draw light/dark theme background.
 // - Draw title texture.
-// - Draw 4 interactive buttons.
+// - Draw 5 interactive buttons.
 // ----------------------------------------------------------------------------
-void DrawMenu(GameState &G, const Assets &A) {
+void DrawMenu(const GameState &G, const Assets &A) {
   // Draw appropriate background.
   DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
 
@@ -489,24 +1472,30 @@ void DrawMenu(GameState &G, const Assets &A) {
   // -------------------------------
   // "PLAY" button
   // -------------------------------
-  DrawTexture(btn, 50, 100, WHITE);
-  DrawText("PLAY", 110, 112, 30, txt);
+  DrawTexture(btn, 50, 65, WHITE);
+  DrawText("PLAY", 110, 77, 30, txt);
+
+  // -------------------------------
+  // "VS CPU" button
+  // -------------------------------
+  DrawTexture(btn, 50, 130, WHITE);
+  DrawText("VS CPU", 97, 142, 30, txt);
 
   // -------------------------------
   // "DARK MODE" or "LIGHT MODE"
   // -------------------------------
-  DrawTexture(btn, 50, 175, WHITE);
+  DrawTexture(btn, 50, 195, WHITE);
 
   if (G.darkMode)
-    DrawText("LIGHT MODE", 60, 187, 30, txt);
+    DrawText("LIGHT MODE", 60, 207, 30, txt);
   else
-    DrawText("DARK MODE", 60, 187, 30, txt);
+    DrawText("DARK MODE", 60, 207, 30, txt);
 
   // -------------------------------
   // "CREDITS" button
   // -------------------------------
-  DrawTexture(btn, 50, 250, WHITE);
-  DrawText("CREDITS", 85, 262, 30, txt);
+  DrawTexture(btn, 50, 260, WHITE);
+  DrawText("CREDITS", 85, 272, 30, txt);
 
   // -------------------------------
   // "EXIT" button
@@ -515,70 +1504,116 @@ void DrawMenu(GameState &G, const Assets &A) {
   DrawText("EXIT", 113, 337, 30, txt);
 }
 
+// ============================================================================
+// SCRIPT: FadeToScene
+// ============================================================================
+// ============= Objective =============
+// Switch to another scene through a short fade out / fade in.
+//
+// ============= Input Parameters =============
+// GameState &G → the logic thread's state (outlives every script)
+// SceneName to → scene to switch to at the midpoint
+//
+// ============= Side Effects =============
+// - Steps G.fade up to 1, sets G.scene, steps it back down to 0. Input is
+//   ignored while G.fade > 0 (see UpdateScene()).
+//
+// ============= Approach =============
+// The first step runs inside ScriptRunner::Start(), so the click that starts
+// the transition also blocks any click queued behind it.
+// ----------------------------------------------------------------------------
+constexpr int FADE_STEPS = 8;
+constexpr double FADE_SECONDS = 0.12; // each way
+
+Script FadeToScene(GameState &G, SceneName to) {
+  for (int i = 1; i <= FADE_STEPS; i++) {
+    G.fade = (float)i / FADE_STEPS;
+    co_await Wait(FADE_SECONDS / FADE_STEPS);
+  }
+  G.scene = to;
+  for (int i = FADE_STEPS - 1; i >= 0; i--) {
+    co_await Wait(FADE_SECONDS / FADE_STEPS);
+    G.fade = (float)i / FADE_STEPS;
+  }
+}
+
 // ============================================================================
 // FUNCTION: HandleMenuInput
 // ============================================================================
 // ============= Objective =============
-// Handle clicks on the Main Menu buttons: Play, Theme Toggle, Credits, Exit.
+// Handle clicks on the Main Menu buttons: Play, VS CPU, Theme Toggle,
+// Credits, Exit.
 //
 // ============= Input Parameters =============
 // GameState &G → modifies selected menu option
 // const Assets &A → plays button press sounds
+// ScriptRunner &scripts → runs the scene transitions
 //
 // ============= Output =============
-// Updates G.scene or G.darkMode, or closes window.
+// Updates G.scene, G.vsCpu or G.darkMode, or requests exit via G.quit.
 //
 // ============= Return Value =============
 // None.
 //
 // ============= Side Effects =============
-// - Changes scene
+// - Starts a scene transition
 // - Toggles theme
-// - Closes the program window
+// - Requests program exit (the render thread closes the window)
 // - Plays click sounds
 //
 // ============= Approach =============
 // - Check if mouse click occurs inside known button rectangles.
 // - Perform associated action.
 // ----------------------------------------------------------------------------
-void HandleMenuInput(GameState &G, const Assets &A) {
+void HandleMenuInput(GameState &G, const Assets &A,
+                     ScriptRunner &scripts) {
   // Only react to actual left-click events.
-  if (!IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+  if (!G.clicked)
     return;
 
   float x = G.mousePos.x;
   float y = G.mousePos.y;
 
   // -------------------------------
-  // PLAY button (50,100)-(250,150)
+  // PLAY button (50,65)-(250,115): two humans, choose a game mode
+  // -------------------------------
+  if (x >= 50 && x <= 250 && y >= 65 && y <= 115) {
+    scripts.Start(FadeToScene(G, SCENE_MODES));
+    G.vsCpu = false;
+    PlaySfx(A, SFX_PRESS);
+  }
+
+  // -------------------------------
+  // VS CPU button (50,130)-(250,180): human X vs CPU O
   // -------------------------------
-  if (x >= 50 && x <= 250 && y >= 100 && y <= 150) {
-    G.scene = SCENE_GAME;
-    PlaySound(A.sndPress);
+  if (x >= 50 && x <= 250 && y >= 130 && y <= 180) {
+    scripts.Start(FadeToScene(G, SCENE_GAME));
+    G.vsCpu = true;
+    PlaySfx(A, SFX_PRESS);
   }
 
   // -------------------------------
   // DARK/LIGHT MODE button
   // -------------------------------
-  if (x >= 50 && x <= 250 && y >= 175 && y <= 225) {
+  if (x >= 50 && x <= 250 && y >= 195 && y <= 245) {
     G.darkMode = !G.darkMode; // toggle theme
-    PlaySound(A.sndPress);
+    PlaySfx(A, SFX_PRESS);
   }
 
   // -------------------------------
   // CREDITS button
   // -------------------------------
-  if (x >= 50 && x <= 250 && y >= 250 && y <= 300) {
-    G.scene = SCENE_CREDITS;
-    PlaySound(A.sndPress);
+  if (x >= 50 && x <= 250 && y >= 260 && y <= 310) {
+    scripts.Start(FadeToScene(G, SCENE_CREDITS));
+    PlaySfx(A, SFX_PRESS);
   }
 
   // -------------------------------
   // EXIT button
   // -------------------------------
   if (x >= 50 && x <= 250 && y >= 325 && y <= 375) {
-    PlaySound(A.sndPress);
-    CloseWindow(); // exits game loop
+    PlaySfx(A, SFX_PRESS);
+    G.quit = true; // render thread leaves its loop and closes the window
   }
 }
 
@@ -589,7 +1624,7 @@ void HandleMenuInput(GameState &G, const Assets &A) {
 // Render the Credits screen displaying acknowledgements and a “BACK” button.
 //
 // ============= Input Parameters =============
-// GameState &G → to determine theme mode
+// const GameState &G → to determine theme mode
 // const Assets &A → for textures used in credits UI
 //
 // ============= Output =============
@@ -606,7 +1641,7 @@ void HandleMenuInput(GameState &G, const Assets &A) {
 // - Draw BACK button.
 // - Draw credits text.
 // ----------------------------------------------------------------------------
-void DrawCredits(GameState &G, const Assets &A) {
+void DrawCredits(const GameState &G, const Assets &A) {
   // Draw background.
   DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
 
@@ -642,6 +1677,7 @@ void DrawCredits(GameState &G, const Assets &A) {
 // ============= Input Parameters =============
 // GameState &G → modified to change scene
 // const Assets &A → used to play sound effects
+// ScriptRunner &scripts → runs the scene transition
 //
 // ============= Output =============
 // Modifies G.scene depending on user actions.
@@ -651,7 +1687,7 @@ void DrawCredits(GameState &G, const Assets &A) {
 //
 // ============= Side Effects =============
 // - May open a URL in the default system browser.
-// - Changes the active scene.
+// - Starts a transition back to the menu.
 // - Plays click sounds.
 //
 // ============= Approach =============
@@ -659,9 +1695,10 @@ void DrawCredits(GameState &G, const Assets &A) {
 // - Check if click lies inside BACK button rectangle.
 // - Check if click lies inside raylib.com text area.
 // ----------------------------------------------------------------------------
-void HandleCreditsInput(GameState &G, const Assets &A) {
+void HandleCreditsInput(GameState &G, const Assets &A,
+                        ScriptRunner &scripts) {
   // Only process actual clicks.
-  if (!IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+  if (!G.clicked)
     return;
 
   float x = G.mousePos.x;
@@ -669,67 +1706,2660 @@ void HandleCreditsInput(GameState &G, const Assets &A) {
 
   // BACK button: returns to menu.
   if (x >= 50 && x <= 250 && y >= 325 && y <= 375) {
-    G.scene = SCENE_MENU;
-    PlaySound(A.sndPress);
+    scripts.Start(FadeToScene(G, SCENE_MENU));
+    PlaySfx(A, SFX_PRESS);
   }
 
   // Clickable raylib.com link.
   if (x >= 0 && x <= 400 && y >= 115 && y <= 135) {
     OpenURL("https://www.raylib.com/");
-    PlaySound(A.sndWin);
+    PlaySfx(A, SFX_WIN);
   }
 }
 
 // ============================================================================
-// FUNCTION: main
+// STRUCT: LogicContext
 // ============================================================================
-// ============= Objective =============
-// The central function that initializes the game, loads assets, enters the
-// main game loop, and handles scene switching among:
-//   - Main Menu
-//   - Game Scene
-//   - Credits Scene
+// Everything besides GameState that a scene's logic-thread entry points may
+// use, bundled so every scene shares one signature.
 //
-// ============= Input Parameters =============
-// None.
-//
-// ============= Output =============
-// Renders the entire game window frame-by-frame until the user closes it.
+//   A       → sounds (and the audio queue)
+//   ai      → built-in CPU opponent
+//   engine  → optional external engine
+//   scripts → runs timed sequences such as scene transitions
+//   infinite → stones of the infinite-board mode
+//   gravity  → gravity-mode solver (its transposition table is kept across
+//              moves and games)
+//   analyser → solved 3×3 positions behind the analysis overlay
+//   puzzles  → the mapped puzzle pack (empty if none was found)
+//   archive  → where finished classic games are appended
+//   replays  → streamer of the replay scene (open only while it is active)
+//   replayPath → archive the replay scene opens (--replay)
 //
-// ============= Return Value =============
-// int → returns 0 on normal, successful program termination.
+struct LogicContext {
+  const Assets &A;
+  AiPlayer &ai;
+  EngineClient &engine;
+  ScriptRunner &scripts;
+  InfiniteBoard &infinite;
+  GravitySolver &gravity;
+  Analyser &analyser;
+  const PuzzlePack &puzzles;
+  ArchiveWriter &archive;
+  ArchiveStreamer &replays;
+  const char *replayPath;
+};
+
+// ============================================================================
+// FUNCTION: UpdateAnalysis
+// ============================================================================
+// ============= Objective =============
+// Keep G.analysis in step with the board while the overlay is on.
 //
 // ============= Side Effects =============
-// - Opens a graphical window.
-// - Initializes audio hardware.
-// - Allocates GPU textures and sound buffers.
-// - Runs an infinite loop until CloseWindow() or OS close event occurs.
-// - Handles all gameplay, input, drawing, and state transitions.
-//
-// ============= Approach =============
-// - Initialize window & audio.
-// - Load all textures/sounds.
-// - Initialize GameState struct.
-// - Enter main loop:
-//       - Read mouse position
-//       - BeginDrawing()
-//       - Switch based on G.scene
-//       - Draw corresponding UI
-//       - Process input for that scene
-//       - EndDrawing()
-// - Exit when WindowShouldClose() becomes true.
-// ----------------------------------------------------------------------------
-int main() {
-  // ------------------------------------------------------------------------
-  // Window Initialization
-  // ------------------------------------------------------------------------
-  // Create the window with fixed width and height.
-  InitWindow(300, 400, "Tic Tac Toe");
+// - May solve positions into ctx.analyser's memo (only the first time a
+//   part of the game tree is needed).
+//
+// ============= Approach =============
+// Called every step, but does work only when the board differs from the one
+// the values were computed for: after a move, undo, redo or timeline jump,
+// or when the overlay is switched on. Revisited positions are memo hits.
+// ----------------------------------------------------------------------------
+void UpdateAnalysis(GameState &G, LogicContext &ctx) {
+  AnalysisView &V = G.analysis;
+  int key = AnalysisView::Key(G.board);
+  if (!V.on || key == V.key)
+    return;
+  ctx.analyser.Analyse(BoardFromCells(G.board, 3, 3), V.value);
+  V.key = key;
+}
 
-  // Initialize audio system so sound effects work.
-  InitAudioDevice();
+// ----------------------------------------------------------------------------
+// ArchiveFinishedGame: append the game to the archive once it has ended on
+// its latest move. Stepping through a finished game or redoing its last move
+// doesn't record it again; a new ending after an undo is a new game.
+// ----------------------------------------------------------------------------
+void ArchiveFinishedGame(GameState &G, LogicContext &ctx) {
+  const MoveStack &h = G.history;
+  if (!G.gameOver || G.archived || h.ply != h.end)
+    return;
+  uint8_t moves[9];
+  for (int i = 0; i < h.ply; i++)
+    moves[i] = h.moves[i].cell;
+  if (!ctx.archive.Append(moves, h.ply, G.winner))
+    TraceLog(LOG_WARNING, "ARCHIVE: could not record the game");
+  G.archived = true;
+}
 
-  // Limit the game loop to 60 frames per second.
+// ============================================================================
+// FUNCTION: UpdateGameScene
+// ============================================================================
+// ============= Objective =============
+// One logic step of the gameplay scene: timeline, tiles, CPU reply and the
+// "Play Again" button.
+//
+// ============= Input Parameters =============
+// GameState &G → the logic thread's mutable state
+// LogicContext &ctx → sounds, CPU opponent, engine
+//
+// ============= Side Effects =============
+// - Plays sounds, may run an AI search or talk to the engine process.
+// - A toggles the analysis overlay, which follows every board change.
+// - Appends every finished game to the game archive.
+// ----------------------------------------------------------------------------
+void UpdateGameScene(GameState &G, LogicContext &ctx) {
+  const Assets &A = ctx.A;
+
+  if (G.key == KEY_A)
+    G.analysis.on = !G.analysis.on;
+
+  // Undo / redo / scrubbing works both during and after the game.
+  HandleTimelineInput(G, A, ctx.ai, ctx.engine);
+
+  // --------------------------------------------------------------
+  // If the game is still running, accept tile inputs.
+  // --------------------------------------------------------------
+  if (!G.gameOver) {
+    // Detects clicking on tiles and placing X/O.
+    HandleGameInput(G, A);
+
+    // In VS CPU mode, let the CPU answer.
+    HandleCpuTurn(G, A, ctx.ai, ctx.engine);
+
+  } else {
+    // --------------------------------------------------------------
+    // GAME OVER → check for "Play Again" button click.
+    // --------------------------------------------------------------
+    if (G.clicked && G.mousePos.x >= 50 && G.mousePos.x <= 250 &&
+        G.mousePos.y >= 345 && G.mousePos.y <= 395) {
+      // Reset game board and game state.
+      ResetBoard(G);
+
+      // Stop the CPU from pondering on the finished game. Its
+      // transposition table is kept: the next game reuses it.
+      ctx.ai.StopPondering();
+      if (ctx.engine.Running())
+        ctx.engine.NewGame(3, 3);
+
+      // Play click sound.
+      PlaySfx(A, SFX_PRESS);
+    }
+  }
+
+  // Overlay values for whatever position is on the board now.
+  UpdateAnalysis(G, ctx);
+  ArchiveFinishedGame(G, ctx);
+}
+
+// ============================================================================
+// FUNCTION: PublishGameScene
+// ============================================================================
+// Snapshot data of the gameplay scene: the CPU diagnostics line.
+// ----------------------------------------------------------------------------
+void PublishGameScene(const GameState &G, LogicContext &, Snapshot &s) {
+  if (!G.vsCpu || !G.cpuMoved)
+    return;
+  const AiStats &st = G.cpuStats;
+  if (st.fromBook)
+    s.cpuLine = s.arena.Format("CPU: book move");
+  else
+    s.cpuLine = s.arena.Format("CPU: depth %d, score %+d, %llu nodes%s",
+                               st.result.depth, st.result.score,
+                               (unsigned long long)st.result.nodes,
+                               st.ponderHit ? " (ponder hit)" : "");
+}
+
+// ============================================================================
+// TABLE: MODES
+// ============================================================================
+// Rows of the game mode picker (SCENE_MODES), top to bottom, followed by a
+// BACK row. Each row switches to the scene that plays the mode.
+//
+struct ModeRow {
+  const char *label;
+  SceneName scene;
+};
+
+static const ModeRow MODES[] = {
+    {"CLASSIC 3x3", SCENE_GAME},
+    {"BLITZ 3x3", SCENE_BLITZ},
+    {"INFINITE", SCENE_INFINITE},
+    {"GRAVITY 7x6", SCENE_GRAVITY},
+    {"NOTAKTO", SCENE_NOTAKTO},
+    {"QUANTUM", SCENE_QUANTUM},
+    {"DAILY PUZZLE", SCENE_PUZZLE},
+    {"REPLAYS", SCENE_REPLAY},
+    {"VARIANTS", SCENE_VARIANT},
+};
+
+constexpr int MODE_COUNT = sizeof(MODES) / sizeof(MODES[0]);
+constexpr int MODE_TOP = 52, MODE_ROW = 34, MODE_HEIGHT = 30;
+
+// Row under y: 0..MODE_COUNT-1 for a mode, MODE_COUNT for BACK, -1 for none.
+int ModeRowAt(float x, float y) {
+  if (x < 50 || x > 250 || y < MODE_TOP)
+    return -1;
+  int row = (int)(y - MODE_TOP) / MODE_ROW;
+  if (row > MODE_COUNT || y - MODE_TOP - row * MODE_ROW > MODE_HEIGHT)
+    return -1;
+  return row;
+}
+
+// ============================================================================
+// FUNCTIONS: DrawModes / HandleModesInput
+// ============================================================================
+// ============= Objective =============
+// The game mode picker: one button per MODES row plus BACK.
+//
+// ============= Side Effects =============
+// - Draw: GPU draw calls (render thread).
+// - Input: starts a transition to the chosen scene and plays a click.
+// ----------------------------------------------------------------------------
+void DrawModes(const GameState &G, const Assets &A) {
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+  Color txt = G.darkMode ? WHITE : BLACK;
+  Texture2D btn = G.darkMode ? A.buttonDark : A.buttonLight;
+
+  DrawText("GAME MODE", (300 - MeasureText("GAME MODE", 30)) / 2, 15, 30, txt);
+  for (int i = 0; i <= MODE_COUNT; i++) {
+    const char *label = i < MODE_COUNT ? MODES[i].label : "BACK";
+    float y = (float)(MODE_TOP + i * MODE_ROW);
+    DrawTexturePro(btn, {0, 0, (float)btn.width, (float)btn.height},
+                   {50, y, 200, MODE_HEIGHT}, {0, 0}, 0.0f, WHITE);
+    DrawText(label, (300 - MeasureText(label, 20)) / 2,
+             (int)y + (MODE_HEIGHT - 20) / 2, 20, txt);
+  }
+}
+
+void HandleModesInput(GameState &G, LogicContext &ctx) {
+  if (!G.clicked)
+    return;
+  int row = ModeRowAt(G.mousePos.x, G.mousePos.y);
+  if (row < 0)
+    return;
+  ctx.scripts.Start(
+      FadeToScene(G, row < MODE_COUNT ? MODES[row].scene : SCENE_MENU));
+  PlaySfx(ctx.A, SFX_PRESS);
+}
+
+// ============================================================================
+// BUTTON ROWS
+// ============================================================================
+// The mode scenes end in one row of equal buttons across the window (NEW /
+// MENU, NEW / CPU / MENU...). A row is given by its top edge and its labels;
+// the buttons share the width between them.
+//
+constexpr int ROW_BTN_Y = 335, ROW_BTN_H = 45;
+constexpr float ROW_LEFT = 10, ROW_WIDTH = 280, ROW_GAP = 5;
+
+// Button i of a row of `count` whose top edge is at y.
+Rectangle RowButton(int i, int count, float y) {
+  float w = (ROW_WIDTH - ROW_GAP * (count - 1)) / count;
+  return {ROW_LEFT + i * (w + ROW_GAP), y, w, (float)ROW_BTN_H};
+}
+
+// ----------------------------------------------------------------------------
+// HandleButtonRow: the button of a `count` row at y that this step's click
+// hit, -1 if none. A hit plays the click sound and consumes the click.
+// ----------------------------------------------------------------------------
+int HandleButtonRow(GameState &G, LogicContext &ctx, float y, int count) {
+  float mx = G.mousePos.x, my = G.mousePos.y;
+  if (G.pressed || !G.clicked || my < y || my > y + ROW_BTN_H)
+    return -1;
+  for (int i = 0; i < count; i++) {
+    Rectangle r = RowButton(i, count, y);
+    if (mx >= r.x && mx <= r.x + r.width) {
+      PlaySfx(ctx.A, SFX_PRESS);
+      G.pressed = true;
+      return i;
+    }
+  }
+  return -1;
+}
+
+// ----------------------------------------------------------------------------
+// DrawButtonRow: `count` buttons at y with these labels; the label of button
+// `dimmed` (none by default) is grey.
+// ----------------------------------------------------------------------------
+void DrawButtonRow(const GameState &G, const Assets &A, float y,
+                   const char *const *labels, int count, int dimmed = -1) {
+  Texture2D btn = G.darkMode ? A.buttonDark : A.buttonLight;
+  Rectangle src = {0, 0, (float)btn.width, (float)btn.height};
+  for (int i = 0; i < count; i++) {
+    Rectangle r = RowButton(i, count, y);
+    DrawTexturePro(btn, src, r, {0, 0}, 0, WHITE);
+    int w = MeasureText(labels[i], 20);
+    DrawText(labels[i], (int)(r.x + r.width / 2) - w / 2, (int)y + 13, 20,
+             i == dimmed ? GRAY : G.darkMode ? WHITE : BLACK);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// HandleCpuButtonRow: the NEW / CPU on-off / MENU row of the modes with a
+// CPU opponent; `reset` starts a new game and the CPU always plays O.
+// Returns true if the click hit a button.
+// ----------------------------------------------------------------------------
+bool HandleCpuButtonRow(GameState &G, LogicContext &ctx,
+                        void (*reset)(GameState &, LogicContext &)) {
+  switch (HandleButtonRow(G, ctx, ROW_BTN_Y, 3)) {
+  case 0:
+    reset(G, ctx);
+    return true;
+  case 1:
+    G.vsCpu = !G.vsCpu;
+    G.cpuPlayer = PLAYER_O;
+    return true;
+  case 2:
+    ctx.scripts.Start(FadeToScene(G, SCENE_MENU));
+    return true;
+  }
+  return false;
+}
+
+// ============================================================================
+// INFINITE-BOARD MODE
+// ============================================================================
+// Two players alternate on an unbounded grid; INFINITE_WIN in a row wins.
+// The viewport shows INF_COLS × INF_ROWS cells of INF_CELL pixels below the
+// turn line; the arrow keys pan it and HOME centres it on the last stone.
+//
+constexpr int INFINITE_WIN = 5;
+constexpr int INF_CELL = 30, INF_COLS = 10, INF_ROWS = 9, INF_TOP = 50;
+
+// ----------------------------------------------------------------------------
+// EnterInfiniteScene: fresh board, camera centred on the origin.
+// ----------------------------------------------------------------------------
+void EnterInfiniteScene(GameState &G, LogicContext &ctx) {
+  ctx.infinite.Clear();
+  G.infinite = InfiniteView();
+  G.turn = PLAYER_X;
+  G.winner = 0;
+  G.gameOver = false;
+}
+
+// ----------------------------------------------------------------------------
+// UpdateInfiniteScene: pan keys, stone placement, NEW and MENU buttons.
+// ----------------------------------------------------------------------------
+void UpdateInfiniteScene(GameState &G, LogicContext &ctx) {
+  InfiniteView &V = G.infinite;
+
+  switch (G.key) {
+  case KEY_LEFT:
+    V.camX--;
+    break;
+  case KEY_RIGHT:
+    V.camX++;
+    break;
+  case KEY_UP:
+    V.camY--;
+    break;
+  case KEY_DOWN:
+    V.camY++;
+    break;
+  case KEY_HOME:
+    V.camX = V.lastX - INF_COLS / 2;
+    V.camY = V.lastY - INF_ROWS / 2;
+    break;
+  }
+
+  if (!G.clicked)
+    return;
+  float x = G.mousePos.x, y = G.mousePos.y;
+
+  // NEW / MENU buttons.
+  switch (HandleButtonRow(G, ctx, ROW_BTN_Y, 2)) {
+  case 0:
+    EnterInfiniteScene(G, ctx);
+    return;
+  case 1:
+    ctx.scripts.Start(FadeToScene(G, SCENE_MENU));
+    return;
+  }
+
+  // Stone placement inside the viewport.
+  if (G.gameOver || y < INF_TOP || y >= INF_TOP + INF_ROWS * INF_CELL ||
+      x < 0 || x >= INF_COLS * INF_CELL)
+    return;
+  int cx = V.camX + (int)x / INF_CELL;
+  int cy = V.camY + (int)(y - INF_TOP) / INF_CELL;
+  if (ctx.infinite.Get(cx, cy))
+    return;
+
+  bool won = ctx.infinite.Place(cx, cy, G.turn);
+  V.lastX = cx;
+  V.lastY = cy;
+  V.stones = (int)ctx.infinite.Stones();
+  PlaySfx(ctx.A, SFX_PLACE);
+  if (won) {
+    G.winner = G.turn;
+    G.gameOver = true;
+    PlaySfx(ctx.A, SFX_WIN);
+  } else {
+    G.turn = G.turn == PLAYER_X ? PLAYER_O : PLAYER_X;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// PublishInfiniteScene: copy the stones inside the viewport into the
+// snapshot. Only the chunks under the viewport are visited.
+// ----------------------------------------------------------------------------
+void PublishInfiniteScene(const GameState &G, LogicContext &ctx, Snapshot &s) {
+  const InfiniteView &V = G.infinite;
+  ViewStone *out = s.arena.Alloc<ViewStone>(INF_COLS * INF_ROWS);
+  if (!out)
+    return;
+  int n = 0;
+  ctx.infinite.ForEachStone(V.camX, V.camY, V.camX + INF_COLS - 1,
+                            V.camY + INF_ROWS - 1, [&](int x, int y, int p) {
+                              out[n++] = ViewStone{(int8_t)(x - V.camX),
+                                                   (int8_t)(y - V.camY),
+                                                   (uint8_t)p};
+                            });
+  s.stones = out;
+  s.stoneCount = n;
+}
+
+// ----------------------------------------------------------------------------
+// DrawInfiniteScene: turn line, viewport grid and stones, hint, buttons.
+// ----------------------------------------------------------------------------
+void DrawInfiniteScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  const GameState &G = S.state;
+  const InfiniteView &V = G.infinite;
+  Color txt = G.darkMode ? WHITE : BLACK;
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+
+  const char *title = !G.gameOver            ? (G.turn == PLAYER_X ? "X turn"
+                                                                   : "O turn")
+                      : G.winner == PLAYER_X ? "X wins"
+                                             : "O wins";
+  DrawText(title, (300 - MeasureText(title, 40)) / 2, 5, 40, txt);
+
+  // Grid.
+  Color grid = G.darkMode ? GRAY : DARKGRAY;
+  for (int c = 0; c <= INF_COLS; c++)
+    DrawLine(c * INF_CELL, INF_TOP, c * INF_CELL, INF_TOP + INF_ROWS * INF_CELL,
+             grid);
+  for (int r = 0; r <= INF_ROWS; r++)
+    DrawLine(0, INF_TOP + r * INF_CELL, INF_COLS * INF_CELL,
+             INF_TOP + r * INF_CELL, grid);
+
+  // Last stone, if on screen.
+  if (V.stones && V.lastX >= V.camX && V.lastX < V.camX + INF_COLS &&
+      V.lastY >= V.camY && V.lastY < V.camY + INF_ROWS)
+    DrawRectangle((V.lastX - V.camX) * INF_CELL + 1,
+                  INF_TOP + (V.lastY - V.camY) * INF_CELL + 1, INF_CELL - 1,
+                  INF_CELL - 1, Fade(GOLD, 0.4f));
+
+  // Stones.
+  for (int i = 0; i < S.stoneCount; i++) {
+    const ViewStone &st = S.stones[i];
+    const Texture2D &t = st.player == PLAYER_X ? A.tileX : A.tileO;
+    DrawTexturePro(t, {0, 0, (float)t.width, (float)t.height},
+                   {(float)(st.col * INF_CELL + 2),
+                    (float)(INF_TOP + st.row * INF_CELL + 2),
+                    (float)(INF_CELL - 4), (float)(INF_CELL - 4)},
+                   {0, 0}, 0.0f, WHITE);
+  }
+
+  // Where we are, and how to move.
+  const char *hint =
+      frame.Format("(%d, %d)  %d stones  arrows: pan  home: last", V.camX,
+                   V.camY, V.stones);
+  DrawText(hint, (300 - MeasureText(hint, 10)) / 2,
+           INF_TOP + INF_ROWS * INF_CELL + 4, 10,
+           G.darkMode ? LIGHTGRAY : DARKGRAY);
+
+  const char *labels[2] = {"NEW", "MENU"};
+  DrawButtonRow(G, A, ROW_BTN_Y, labels, 2);
+}
+
+// ============================================================================
+// GRAVITY MODE
+// ============================================================================
+// Seven columns of six cells; a stone dropped into a column lands on its
+// lowest free cell and four in a row wins. Clicking anywhere in a column
+// drops there. With the CPU switched on it plays O using GravitySolver:
+// perfect play whenever the solve fits in GRAVITY_NODE_BUDGET nodes (from
+// about the middle of the game on), its threat ordering otherwise.
+//
+constexpr int GRAV_CELL = 40, GRAV_LEFT = 10, GRAV_TOP = 55;
+constexpr int GRAV_BOTTOM = GRAV_TOP + GravityBoard::HEIGHT * GRAV_CELL;
+
+// Node budget per CPU move: about 15 ms, so a move never takes noticeably
+// longer than a frame (see tools/gravity_bench).
+constexpr uint64_t GRAVITY_NODE_BUDGET = 100000;
+
+// ----------------------------------------------------------------------------
+// EnterGravityScene: empty board, X to move. Keeps the CPU setting.
+// ----------------------------------------------------------------------------
+void EnterGravityScene(GameState &G, LogicContext &) {
+  G.gravity = GravityView();
+  G.turn = PLAYER_X;
+  G.winner = 0;
+  G.gameOver = false;
+}
+
+// ----------------------------------------------------------------------------
+// DropStone: play `col` for the side to move (human or CPU) and update the
+// shared turn / result fields. The column must not be full.
+// ----------------------------------------------------------------------------
+void DropStone(GameState &G, const Assets &A, int col) {
+  GravityBoard &b = G.gravity.board;
+  b.Play(col);
+  G.gravity.lastCol = col;
+  G.turn = b.SideToMove();
+  PlaySfx(A, SFX_PLACE);
+
+  G.winner = b.Result();
+  G.gameOver = G.winner != RESULT_NONE;
+  if (G.gameOver) // a draw ends the game with the same sound as a win
+    PlaySfx(A, SFX_WIN);
+}
+
+// ============================================================================
+// FUNCTION: HandleGravityInput
+// ============================================================================
+// ============= Objective =============
+// Column clicks and the NEW / CPU / MENU buttons of the gravity mode.
+//
+// ============= Input Parameters =============
+// GameState &G → board and flags
+// LogicContext &ctx → sounds and scene transitions
+//
+// ============= Side Effects =============
+// - Drops a stone, toggles the CPU or starts a transition; plays clicks.
+//
+// ============= Approach =============
+// Same guards as HandleGameInput() (debounce, CPU's turn, game over), but
+// the hit test only needs the column: x picks it, Possible() picks the row.
+// ----------------------------------------------------------------------------
+void HandleGravityInput(GameState &G, LogicContext &ctx) {
+  if (G.pressed || !G.clicked || HandleCpuButtonRow(G, ctx, EnterGravityScene))
+    return;
+  float x = G.mousePos.x, y = G.mousePos.y;
+
+  if (G.gameOver || (G.vsCpu && G.turn == G.cpuPlayer))
+    return;
+  if (y < GRAV_TOP || y >= GRAV_BOTTOM || x < GRAV_LEFT ||
+      x >= GRAV_LEFT + GravityBoard::WIDTH * GRAV_CELL)
+    return;
+
+  int col = (int)(x - GRAV_LEFT) / GRAV_CELL;
+  if (!G.gravity.board.CanPlay(col))
+    return;
+  DropStone(G, ctx.A, col);
+  G.pressed = true;
+}
+
+// ----------------------------------------------------------------------------
+// HandleGravityCpu: the CPU's move, when it is on and to move.
+// ----------------------------------------------------------------------------
+void HandleGravityCpu(GameState &G, LogicContext &ctx) {
+  if (!G.vsCpu || G.gameOver || G.turn != G.cpuPlayer)
+    return;
+  GravityMove m = ctx.gravity.BestMove(G.gravity.board, GRAVITY_NODE_BUDGET);
+  if (m.col < 0)
+    return;
+  G.gravity.cpu = m;
+  G.gravity.cpuMoved = true;
+  DropStone(G, ctx.A, m.col);
+}
+
+void UpdateGravityScene(GameState &G, LogicContext &ctx) {
+  HandleGravityInput(G, ctx);
+  HandleGravityCpu(G, ctx);
+}
+
+// ----------------------------------------------------------------------------
+// PublishGravityScene: what the CPU knew about its last move.
+// ----------------------------------------------------------------------------
+void PublishGravityScene(const GameState &G, LogicContext &, Snapshot &s) {
+  const GravityView &V = G.gravity;
+  if (!G.vsCpu || !V.cpuMoved)
+    return;
+  const GravityMove &m = V.cpu;
+  unsigned long long nodes = (unsigned long long)m.nodes;
+  if (!m.solved) {
+    s.cpuLine = s.arena.Format("CPU: unsolved, best threat (%llu nodes)",
+                               nodes);
+    return;
+  }
+
+  // The score is of the position the CPU moved from, one stone earlier.
+  if (m.score == 0)
+    s.cpuLine = s.arena.Format("CPU: solved, draw (%llu nodes)", nodes);
+  else
+    s.cpuLine = s.arena.Format(
+        "CPU: solved, %s in %d (%llu nodes)", m.score > 0 ? "wins" : "loses",
+        GravitySolver::StonesToWin(V.board.moves - 1, m.score), nodes);
+}
+
+// ============================================================================
+// FUNCTION: DrawGravityScene
+// ============================================================================
+// ============= Objective =============
+// Turn or result line, the board with its stones, the CPU line and the
+// NEW / CPU / MENU buttons.
+//
+// ============= Approach =============
+// One pass over the 42 cells straight from the bitboard: a hole or a
+// stone per cell, a gold ring on stones of a winning four (AlignedStones)
+// and a dot on the last stone dropped.
+// ----------------------------------------------------------------------------
+void DrawGravityScene(const Snapshot &S, const Assets &A, LinearArena &) {
+  const GameState &G = S.state;
+  const GravityBoard &b = G.gravity.board;
+  Color txt = G.darkMode ? WHITE : BLACK;
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+
+  const char *title = !G.gameOver            ? (G.turn == PLAYER_X ? "X turn"
+                                                                   : "O turn")
+                      : G.winner == PLAYER_X ? "X wins"
+                      : G.winner == PLAYER_O ? "O wins"
+                                             : "Draw";
+  DrawText(title, (300 - MeasureText(title, 40)) / 2, 5, 40, txt);
+
+  // Frame, then one hole or stone per cell (row 0 at the bottom).
+  DrawRectangle(GRAV_LEFT - 4, GRAV_TOP - 4,
+                GravityBoard::WIDTH * GRAV_CELL + 8,
+                GravityBoard::HEIGHT * GRAV_CELL + 8,
+                G.darkMode ? DARKGRAY : GRAY);
+  uint64_t four = G.winner == PLAYER_X || G.winner == PLAYER_O
+                      ? GravityBoard::AlignedStones(b.Stones(G.winner))
+                      : 0;
+  Color hole = G.darkMode ? BLACK : RAYWHITE;
+  for (int c = 0; c < GravityBoard::WIDTH; c++)
+    for (int r = 0; r < GravityBoard::HEIGHT; r++) {
+      Vector2 at = {GRAV_LEFT + (c + 0.5f) * GRAV_CELL,
+                    GRAV_BOTTOM - (r + 0.5f) * GRAV_CELL};
+      int p = b.Cell(c, r);
+      DrawCircleV(at, GRAV_CELL * 0.4f,
+                  p == PLAYER_X ? MAROON : p == PLAYER_O ? BLUE : hole);
+      if (four >> (c * GravityBoard::COLUMN_BITS + r) & 1)
+        DrawRing(at, GRAV_CELL * 0.3f, GRAV_CELL * 0.4f, 0, 360, 24, GOLD);
+    }
+  if (G.gravity.lastCol >= 0) {
+    int c = G.gravity.lastCol, r = b.Height(c) - 1;
+    DrawCircleV({GRAV_LEFT + (c + 0.5f) * GRAV_CELL,
+                 GRAV_BOTTOM - (r + 0.5f) * GRAV_CELL},
+                4, Fade(WHITE, 0.8f));
+  }
+
+  // CPU diagnostics under the board, centred.
+  if (S.cpuLine[0])
+    DrawText(S.cpuLine, (300 - MeasureText(S.cpuLine, 10)) / 2,
+             GRAV_BOTTOM + 12, 10, G.darkMode ? LIGHTGRAY : DARKGRAY);
+
+  const char *labels[3] = {"NEW", G.vsCpu ? "CPU: ON" : "CPU: OFF", "MENU"};
+  DrawButtonRow(G, A, ROW_BTN_Y, labels, 3);
+}
+
+// ============================================================================
+// NOTAKTO MODE
+// ============================================================================
+// Both players place X's on 1..NOTAKTO_MAX_BOARDS boards; three in a row
+// kills a board and whoever kills the last one loses. The CPU (O, the second
+// player) evaluates positions with the misère quotient, so it plays
+// perfectly and instantly however many boards there are.
+//
+// Boards are laid out in a square-ish grid between the board-count arrows
+// (y NK_COUNT_Y) and the button row.
+//
+constexpr int NK_COUNT_Y = 45, NK_COUNT_H = 25;
+constexpr int NK_TOP = 78, NK_BOTTOM = 322, NK_LEFT = 10, NK_RIGHT = 290;
+
+struct NotaktoLayout {
+  int cols;
+  float size; // side of one board including its margin
+  float left, top;
+
+  explicit NotaktoLayout(int boards) {
+    cols = 1;
+    while (cols * cols < boards)
+      cols++;
+    int rows = (boards + cols - 1) / cols;
+    size = std::min((float)(NK_RIGHT - NK_LEFT) / cols,
+                    (float)(NK_BOTTOM - NK_TOP) / rows);
+    left = NK_LEFT + ((NK_RIGHT - NK_LEFT) - size * cols) / 2;
+    top = NK_TOP + ((NK_BOTTOM - NK_TOP) - size * rows) / 2;
+  }
+
+  // Top-left corner and cell size of board b's 3×3 grid.
+  void Board(int b, float *x, float *y, float *cell) const {
+    float margin = size * 0.08f;
+    *x = left + (b % cols) * size + margin;
+    *y = top + (b / cols) * size + margin;
+    *cell = (size - 2 * margin) / 3;
+  }
+};
+
+// ----------------------------------------------------------------------------
+// EnterNotaktoScene: G.notakto.boards empty boards, player 1 to move.
+// ----------------------------------------------------------------------------
+void EnterNotaktoScene(GameState &G, LogicContext &) {
+  int boards = G.notakto.boards;
+  G.notakto = NotaktoView();
+  G.notakto.boards = boards;
+  G.notakto.pos.count = boards;
+  G.turn = PLAYER_X;
+  G.winner = 0;
+  G.gameOver = false;
+}
+
+// ----------------------------------------------------------------------------
+// PlaceX: the side to move (human or CPU) plays `cell` on board `b`.
+// ----------------------------------------------------------------------------
+void PlaceX(GameState &G, const Assets &A, int b, int cell) {
+  NotaktoView &V = G.notakto;
+  V.pos.Play(b, cell);
+  V.lastBoard = b;
+  V.lastCell = cell;
+  G.turn = G.turn == PLAYER_X ? PLAYER_O : PLAYER_X;
+  PlaySfx(A, SFX_PLACE);
+
+  // Killing the last board loses: the player now to move has won.
+  if (V.pos.Over()) {
+    G.winner = G.turn;
+    G.gameOver = true;
+    PlaySfx(A, SFX_WIN);
+  }
+}
+
+// ============================================================================
+// FUNCTION: HandleNotaktoInput
+// ============================================================================
+// ============= Objective =============
+// Cell clicks, the board-count arrows and the button row of Notakto.
+//
+// ============= Side Effects =============
+// - Places an X, changes the board count (starting a new game), toggles
+//   the CPU or leaves the scene; plays sounds.
+// ----------------------------------------------------------------------------
+void HandleNotaktoInput(GameState &G, LogicContext &ctx) {
+  if (G.pressed || !G.clicked || HandleCpuButtonRow(G, ctx, EnterNotaktoScene))
+    return;
+  NotaktoView &V = G.notakto;
+  float x = G.mousePos.x, y = G.mousePos.y;
+
+  // < N BOARDS >
+  if (y >= NK_COUNT_Y && y <= NK_COUNT_Y + NK_COUNT_H) {
+    int boards = V.boards;
+    if (x >= 40 && x <= 80)
+      boards = std::max(1, boards - 1);
+    else if (x >= 220 && x <= 260)
+      boards = std::min(NOTAKTO_MAX_BOARDS, boards + 1);
+    if (boards != V.boards) {
+      V.boards = boards;
+      EnterNotaktoScene(G, ctx);
+      PlaySfx(ctx.A, SFX_PRESS);
+      G.pressed = true;
+    }
+    return;
+  }
+
+  if (G.gameOver || (G.vsCpu && G.turn == G.cpuPlayer))
+    return;
+  NotaktoLayout L(V.pos.count);
+  for (int b = 0; b < V.pos.count; b++) {
+    float bx, by, cell;
+    L.Board(b, &bx, &by, &cell);
+    if (x < bx || y < by || x >= bx + 3 * cell || y >= by + 3 * cell)
+      continue;
+    int c = (int)((y - by) / cell) * 3 + (int)((x - bx) / cell);
+    if (V.pos.CanPlay(b, c)) {
+      PlaceX(G, ctx.A, b, c);
+      G.pressed = true;
+    }
+    return;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// HandleNotaktoCpu: O's move when the CPU is on. One pass over the boards.
+// ----------------------------------------------------------------------------
+void HandleNotaktoCpu(GameState &G, LogicContext &ctx) {
+  NotaktoView &V = G.notakto;
+  if (!G.vsCpu || G.gameOver || G.turn != G.cpuPlayer)
+    return;
+  int b, c;
+  V.cpuValue = V.pos.Value();
+  V.cpuWon = V.pos.BestMove(&b, &c);
+  if (b < 0)
+    return;
+  V.cpuMoved = true;
+  PlaceX(G, ctx.A, b, c);
+}
+
+void UpdateNotaktoScene(GameState &G, LogicContext &ctx) {
+  HandleNotaktoInput(G, ctx);
+  HandleNotaktoCpu(G, ctx);
+}
+
+void PublishNotaktoScene(const GameState &G, LogicContext &, Snapshot &s) {
+  const NotaktoView &V = G.notakto;
+  if (!G.vsCpu || !V.cpuMoved)
+    return;
+  s.cpuLine = s.arena.Format(
+      "CPU: position %s, %s", NOTAKTO_NAMES[V.cpuValue],
+      V.cpuWon ? "moved to a P-position" : "no winning move, stalling");
+}
+
+// ============================================================================
+// FUNCTION: DrawNotaktoScene
+// ============================================================================
+// ============= Objective =============
+// Turn or result line, board-count arrows, every board with its X's (dead
+// boards faded, the last X highlighted), the CPU line and the button row.
+//
+// ============= Approach =============
+// All X's are one texture, so drawing them back to back keeps them in a
+// single raylib batch.
+// ----------------------------------------------------------------------------
+void DrawNotaktoScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  const GameState &G = S.state;
+  const NotaktoView &V = G.notakto;
+  Color txt = G.darkMode ? WHITE : BLACK;
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+
+  const char *title = !G.gameOver            ? (G.turn == PLAYER_X ? "P1 turn"
+                                                                   : "P2 turn")
+                      : G.winner == PLAYER_X ? "P1 wins"
+                                             : "P2 wins";
+  DrawText(title, (300 - MeasureText(title, 36)) / 2, 5, 36, txt);
+
+  const char *count =
+      frame.Format("%d BOARD%s", V.boards, V.boards == 1 ? "" : "S");
+  DrawText(count, (300 - MeasureText(count, 20)) / 2, NK_COUNT_Y + 3, 20, txt);
+  float mid = NK_COUNT_Y + NK_COUNT_H / 2.0f;
+  DrawTriangle({45, mid}, {75, NK_COUNT_Y + NK_COUNT_H}, {75, NK_COUNT_Y}, txt);
+  DrawTriangle({255, mid}, {225, NK_COUNT_Y}, {225, NK_COUNT_Y + NK_COUNT_H},
+               txt);
+
+  NotaktoLayout L(V.pos.count);
+  Color grid = G.darkMode ? LIGHTGRAY : DARKGRAY;
+  for (int b = 0; b < V.pos.count; b++) {
+    float x, y, cell;
+    L.Board(b, &x, &y, &cell);
+    Color ink = V.pos.Live(b) ? grid : Fade(grid, 0.3f);
+    for (int i = 1; i < 3; i++) {
+      DrawLineV({x + i * cell, y}, {x + i * cell, y + 3 * cell}, ink);
+      DrawLineV({x, y + i * cell}, {x + 3 * cell, y + i * cell}, ink);
+    }
+    if (b == V.lastBoard)
+      DrawRectangleV({x + V.lastCell % 3 * cell, y + V.lastCell / 3 * cell},
+                     {cell, cell}, Fade(GOLD, 0.4f));
+  }
+
+  Rectangle src = {0, 0, (float)A.tileX.width, (float)A.tileX.height};
+  for (int b = 0; b < V.pos.count; b++) {
+    float x, y, cell;
+    L.Board(b, &x, &y, &cell);
+    Color tint = V.pos.Live(b) ? MAROON : Fade(MAROON, 0.35f);
+    for (int c = 0; c < 9; c++)
+      if (V.pos.boards[b] >> c & 1)
+        DrawTexturePro(A.tileX, src,
+                       {x + c % 3 * cell + 1, y + c / 3 * cell + 1, cell - 2,
+                        cell - 2},
+                       {0, 0}, 0, tint);
+  }
+
+  if (S.cpuLine[0])
+    DrawText(S.cpuLine, (300 - MeasureText(S.cpuLine, 10)) / 2, NK_BOTTOM, 10,
+             G.darkMode ? LIGHTGRAY : DARKGRAY);
+
+  const char *labels[3] = {"NEW", G.vsCpu ? "CPU: ON" : "CPU: OFF", "MENU"};
+  DrawButtonRow(G, A, ROW_BTN_Y, labels, 3);
+}
+
+// ============================================================================
+// QUANTUM MODE
+// ============================================================================
+// Quantum tic-tac-toe for two players (rules in src/quantum.h). A move is
+// two clicks on two open tiles; clicking the first tile again takes it back.
+// When a move closes a cycle, the other player clicks which of its two tiles
+// the orange mark lands on and the whole cycle collapses into classical
+// marks, which DrawBoard() shows as X / O tiles with their move number.
+//
+// Bottom buttons: NEW (left) and MENU (right), under the board.
+constexpr int QT_BTN_Y = 345;
+
+// ----------------------------------------------------------------------------
+// EnterQuantumScene: empty board, X to move.
+// ----------------------------------------------------------------------------
+void EnterQuantumScene(GameState &G, LogicContext &) {
+  G.quantum = QuantumView();
+  for (int &cell : G.board)
+    cell = EMPTY;
+  G.turn = PLAYER_X;
+  G.winner = 0;
+  G.gameOver = false;
+}
+
+// ----------------------------------------------------------------------------
+// SyncQuantum: mirror the classical marks, the player who acts next and the
+// result into the shared GameState fields.
+// ----------------------------------------------------------------------------
+void SyncQuantum(GameState &G, const Assets &A) {
+  const QuantumBoard &q = G.quantum.board;
+  for (int i = 0; i < 9; i++)
+    G.board[i] = q.Classical(i) ? QuantumBoard::Owner(q.Classical(i)) : EMPTY;
+  G.turn = q.SideToMove();
+  if (q.Result() != RESULT_NONE) {
+    G.winner = q.Result();
+    G.gameOver = true;
+    PlaySfx(A, SFX_WIN);
+  }
+}
+
+// ============================================================================
+// FUNCTION: UpdateQuantumScene
+// ============================================================================
+// ============= Objective =============
+// Tile clicks (first and second cell of a move, collapse choice, the last
+// classical mark) and the NEW / MENU buttons of the quantum mode.
+//
+// ============= Side Effects =============
+// - Places marks, collapses cycles, starts a new game or leaves the scene;
+//   plays sounds.
+// ----------------------------------------------------------------------------
+void UpdateQuantumScene(GameState &G, LogicContext &ctx) {
+  if (G.pressed || !G.clicked)
+    return;
+
+  // NEW / MENU buttons.
+  switch (HandleButtonRow(G, ctx, QT_BTN_Y, 2)) {
+  case 0:
+    EnterQuantumScene(G, ctx);
+    return;
+  case 1:
+    ctx.scripts.Start(FadeToScene(G, SCENE_MENU));
+    return;
+  }
+
+  int cell = TileAt(G.mousePos);
+  if (G.gameOver || cell < 0)
+    return;
+  QuantumView &V = G.quantum;
+  QuantumBoard &q = V.board;
+
+  if (q.Pending()) {
+    if (!q.CanCollapse(cell))
+      return;
+    q.Collapse(cell);
+  } else if (cell == q.LastCell()) {
+    q.PlaceLast();
+  } else if (V.pick == cell) {
+    V.pick = -1;
+    return;
+  } else if (V.pick < 0) {
+    if (!q.Classical(cell)) {
+      V.pick = cell;
+      PlaySfx(ctx.A, SFX_PRESS);
+    }
+    return;
+  } else if (q.CanPlace(V.pick, cell)) {
+    q.Place(V.pick, cell);
+    V.pick = -1;
+  } else {
+    return;
+  }
+  PlaySfx(ctx.A, SFX_PLACE);
+  G.pressed = true;
+  SyncQuantum(G, ctx.A);
+}
+
+// ============================================================================
+// FUNCTION: DrawQuantumScene
+// ============================================================================
+// ============= Objective =============
+// Turn or result line, a hint for the current step, the board with its
+// marks (see DrawBoard()), gold frames on the picked tile, the two collapse
+// candidates or the winning line, and the NEW / MENU buttons.
+// ----------------------------------------------------------------------------
+void DrawQuantumScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  const GameState &G = S.state;
+  const QuantumView &V = G.quantum;
+  const QuantumBoard &q = V.board;
+  Color txt = G.darkMode ? WHITE : BLACK;
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+
+  const char *who = G.turn == PLAYER_X ? "X" : "O";
+  const char *title;
+  if (!G.gameOver)
+    title = frame.Format(q.Pending() ? "%s collapses" : "%s turn", who);
+  else
+    title = G.winner == RESULT_DRAW ? "Draw"
+            : G.winner == PLAYER_X  ? "X wins"
+                                    : "O wins";
+  DrawText(title, (300 - MeasureText(title, 36)) / 2, 5, 36, txt);
+
+  const char *hint;
+  if (G.gameOver)
+    hint = frame.Format("%d moves", q.Moves());
+  else if (q.Pending())
+    hint = frame.Format("cycle: pick the tile mark %d lands on", q.Pending());
+  else if (q.LastCell() >= 0)
+    hint = "one tile left: a classical mark";
+  else if (V.pick >= 0)
+    hint = "pick a second tile (same tile: undo)";
+  else
+    hint = "pick two tiles for a spooky mark";
+  DrawText(hint, (300 - MeasureText(hint, 10)) / 2, 46, 10,
+           G.darkMode ? LIGHTGRAY : DARKGRAY);
+
+  DrawGrid(G);
+  DrawBoard(G, A, frame, &q);
+
+  for (int i = 0; i < 9; i++)
+    if (i == V.pick || q.CanCollapse(i) || (q.WinningCells() >> i & 1))
+      DrawRectangleLinesEx({12.5f + i % 3 * 100, 62.5f + i / 3 * 100, 75, 75},
+                           3, GOLD);
+
+  const char *labels[2] = {"NEW", "MENU"};
+  DrawButtonRow(G, A, QT_BTN_Y, labels, 2);
+}
+
+// ============================================================================
+// PUZZLE MODE
+// ============================================================================
+// One "win in N" position a day from the pack tools/puzzle_miner writes
+// (make puzzles): the player clicks the cell they think forces the win and
+// the answer is checked against the pack with one compare. NEXT moves on to
+// the following puzzle of the pack, wrapping round.
+//
+// The 7×7 board fills the screen between the hint line and the buttons.
+constexpr int PUZZLE_SIDE = 7, PUZZLE_WIN = 4;
+constexpr int PZ_CELL = 40, PZ_LEFT = 10, PZ_TOP = 55;
+constexpr int PZ_BTN_Y = 345;
+
+// ----------------------------------------------------------------------------
+// ShowPuzzle: copy puzzle `index` out of the pack and clear the attempts.
+// ----------------------------------------------------------------------------
+void ShowPuzzle(GameState &G, const PuzzlePack &pack, uint32_t index) {
+  G.puzzle = PuzzleView();
+  if (!pack.Count())
+    return;
+  G.puzzle.index = (int)(index % pack.Count());
+  G.puzzle.count = (int)pack.Count();
+  G.puzzle.puzzle = pack.At(G.puzzle.index);
+}
+
+// ----------------------------------------------------------------------------
+// EnterPuzzleScene: today's puzzle from the shipped pack, the same for
+// everyone on a given day.
+// ----------------------------------------------------------------------------
+void EnterPuzzleScene(GameState &G, LogicContext &ctx) {
+  using namespace std::chrono;
+  int64_t days =
+      duration_cast<hours>(system_clock::now().time_since_epoch()).count() /
+      24;
+  ShowPuzzle(G, ctx.puzzles, (uint32_t)days);
+}
+
+// ============================================================================
+// FUNCTION: UpdatePuzzleScene
+// ============================================================================
+// ============= Objective =============
+// Answer clicks on the board and the NEXT / MENU buttons of the puzzle mode.
+//
+// ============= Side Effects =============
+// - Records the answer (right or wrong), shows the next puzzle or leaves
+//   the scene; plays sounds.
+//
+// ============= Approach =============
+// No search at all: PuzzlePack::Solves() compares the cell with the stored
+// answer, so checking costs the same however deep the win is.
+// ----------------------------------------------------------------------------
+void UpdatePuzzleScene(GameState &G, LogicContext &ctx) {
+  if (G.pressed || !G.clicked)
+    return;
+  float x = G.mousePos.x, y = G.mousePos.y;
+  PuzzleView &V = G.puzzle;
+
+  // NEXT / MENU buttons.
+  switch (HandleButtonRow(G, ctx, PZ_BTN_Y, 2)) {
+  case 0:
+    if (V.index >= 0)
+      ShowPuzzle(G, ctx.puzzles, V.index + 1);
+    return;
+  case 1:
+    ctx.scripts.Start(FadeToScene(G, SCENE_MENU));
+    return;
+  }
+
+  if (V.index < 0 || V.solved || x < PZ_LEFT || y < PZ_TOP ||
+      x >= PZ_LEFT + PUZZLE_SIDE * PZ_CELL ||
+      y >= PZ_TOP + PUZZLE_SIDE * PZ_CELL)
+    return;
+  int cell = (int)(y - PZ_TOP) / PZ_CELL * PUZZLE_SIDE +
+             (int)(x - PZ_LEFT) / PZ_CELL;
+  if ((V.puzzle.stones[0] | V.puzzle.stones[1]) >> cell & 1)
+    return;
+
+  V.tried = cell;
+  V.solved = PuzzlePack::Solves(V.puzzle, cell);
+  if (V.solved) {
+    PlaySfx(ctx.A, SFX_WIN);
+  } else {
+    V.misses++;
+    PlaySfx(ctx.A, SFX_PLACE);
+  }
+  G.pressed = true;
+}
+
+// ============================================================================
+// FUNCTION: DrawPuzzleScene
+// ============================================================================
+// ============= Objective =============
+// The task ("X to move: win in 2"), a hint or verdict line, the board with
+// its stones, the last answer (gold and played once right, red while
+// wrong) and the NEXT / MENU buttons. Without a pack, how to build one.
+// ----------------------------------------------------------------------------
+void DrawPuzzleScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  const GameState &G = S.state;
+  const PuzzleView &V = G.puzzle;
+  const PuzzleEntry &P = V.puzzle;
+  Color txt = G.darkMode ? WHITE : BLACK;
+  Color dim = G.darkMode ? LIGHTGRAY : DARKGRAY;
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+
+  if (V.index >= 0) {
+    int toMove = __builtin_popcountll(P.stones[0]) >
+                         __builtin_popcountll(P.stones[1])
+                     ? PLAYER_O
+                     : PLAYER_X;
+    const char *title = frame.Format("%s to move: win in %d",
+                                     toMove == PLAYER_X ? "X" : "O", P.moves);
+    DrawText(title, (300 - MeasureText(title, 24)) / 2, 8, 24, txt);
+
+    const char *hint;
+    if (V.solved)
+      hint = V.misses ? frame.Format("Solved after %d misses", V.misses)
+                      : "Solved first time!";
+    else if (V.tried >= 0)
+      hint = "Not that one: it doesn't force the win";
+    else
+      hint = frame.Format("Puzzle %d of %d: find the only winning move",
+                          V.index + 1, V.count);
+    DrawText(hint, (300 - MeasureText(hint, 10)) / 2, 38, 10, dim);
+
+    // Grid, then the answer's highlight, then the stones.
+    for (int i = 0; i <= PUZZLE_SIDE; i++) {
+      float at = (float)(i * PZ_CELL);
+      DrawLineV({PZ_LEFT + at, PZ_TOP},
+                {PZ_LEFT + at, PZ_TOP + PUZZLE_SIDE * PZ_CELL}, dim);
+      DrawLineV({PZ_LEFT, PZ_TOP + at},
+                {PZ_LEFT + PUZZLE_SIDE * PZ_CELL, PZ_TOP + at}, dim);
+    }
+    uint64_t stones[2] = {P.stones[0], P.stones[1]};
+    if (V.tried >= 0) {
+      DrawRectangle(PZ_LEFT + V.tried % PUZZLE_SIDE * PZ_CELL + 1,
+                    PZ_TOP + V.tried / PUZZLE_SIDE * PZ_CELL + 1, PZ_CELL - 1,
+                    PZ_CELL - 1, Fade(V.solved ? GOLD : RED, 0.4f));
+      if (V.solved)
+        stones[toMove - 1] |= 1ull << V.tried;
+    }
+    for (int p = 0; p < 2; p++) {
+      const Texture2D &t = p == 0 ? A.tileX : A.tileO;
+      for (uint64_t m = stones[p]; m; m &= m - 1) {
+        int c = __builtin_ctzll(m);
+        DrawTexturePro(t, {0, 0, (float)t.width, (float)t.height},
+                       {(float)(PZ_LEFT + c % PUZZLE_SIDE * PZ_CELL + 2),
+                        (float)(PZ_TOP + c / PUZZLE_SIDE * PZ_CELL + 2),
+                        (float)(PZ_CELL - 4), (float)(PZ_CELL - 4)},
+                       {0, 0}, 0.0f, WHITE);
+      }
+    }
+  } else {
+    const char *none = "No puzzle pack";
+    DrawText(none, (300 - MeasureText(none, 30)) / 2, 140, 30, txt);
+    const char *how = "build one with: make puzzles";
+    DrawText(how, (300 - MeasureText(how, 10)) / 2, 180, 10, dim);
+  }
+
+  const char *labels[2] = {"NEXT", "MENU"};
+  DrawButtonRow(G, A, PZ_BTN_Y, labels, 2, V.index < 0 ? 0 : -1);
+}
+
+// ============================================================================
+// REPLAY MODE
+// ============================================================================
+// Pages through a game archive (src/archive.h): the classic games by default,
+// any archive given with --replay. Opening the scene starts the archive's
+// streamer thread and leaving it stops the thread again.
+//
+// Keys: UP / DOWN previous / next game, PAGE UP / PAGE DOWN 100 games back
+// or on, LEFT / RIGHT one move, HOME / END the start / end of the game (held
+// keys repeat). Buttons: PREV, NEXT and MENU.
+//
+// Navigation only moves ReplayView::want and tells the streamer; the game
+// appears as soon as Fetch() finds it decoded, which for neighbouring games
+// is at once. A new game opens on its final position.
+//
+// The board fills the width between the hint line and the buttons.
+constexpr int RP_TOP = 48, RP_LEFT = 10, RP_SIDE = 280;
+constexpr int RP_PAGE = 100;
+
+// ----------------------------------------------------------------------------
+// EnterReplayScene / ExitReplayScene: open and close the archive stream.
+// ----------------------------------------------------------------------------
+void EnterReplayScene(GameState &G, LogicContext &ctx) {
+  G.replay = ReplayView();
+  if (!ctx.replays.Open(ctx.replayPath)) {
+    TraceLog(LOG_INFO, "REPLAY: no archive at %s", ctx.replayPath);
+    return;
+  }
+  G.replay.count = ctx.replays.Count();
+  G.replay.size = ctx.replays.Size();
+}
+
+void ExitReplayScene(GameState &, LogicContext &ctx) { ctx.replays.Close(); }
+
+// ============================================================================
+// FUNCTION: UpdateReplayScene
+// ============================================================================
+// ============= Objective =============
+// Game and move navigation (keys and the PREV / NEXT / MENU buttons) and
+// picking up the wanted game once the streamer has decoded it.
+//
+// ============= Side Effects =============
+// - Moves the streamer's window, leaves the scene; plays clicks.
+//
+// ============= Approach =============
+// Runs every step, with or without input, so a game that was not decoded
+// yet when it was asked for shows up on a later step by itself. Fetch()
+// copies one record under the streamer's lock and never waits on the file.
+// ----------------------------------------------------------------------------
+void UpdateReplayScene(GameState &G, LogicContext &ctx) {
+  ReplayView &V = G.replay;
+  int64_t want = V.want;
+  int ply = V.ply;
+
+  switch (G.key) {
+  case KEY_UP:
+    want--;
+    break;
+  case KEY_DOWN:
+    want++;
+    break;
+  case KEY_PAGE_UP:
+    want -= RP_PAGE;
+    break;
+  case KEY_PAGE_DOWN:
+    want += RP_PAGE;
+    break;
+  case KEY_LEFT:
+    ply--;
+    break;
+  case KEY_RIGHT:
+    ply++;
+    break;
+  case KEY_HOME:
+    ply = 0;
+    break;
+  case KEY_END:
+    ply = V.game.plies;
+    break;
+  }
+
+  // PREV / NEXT / MENU buttons.
+  switch (HandleButtonRow(G, ctx, ROW_BTN_Y, 3)) {
+  case 0:
+    want--;
+    break;
+  case 1:
+    want++;
+    break;
+  case 2:
+    ctx.scripts.Start(FadeToScene(G, SCENE_MENU));
+    break;
+  }
+  if (!V.count)
+    return;
+
+  if (want < 0)
+    want = 0;
+  if (want >= V.count)
+    want = V.count - 1;
+  if (want != V.want) {
+    V.want = (uint32_t)want;
+    ctx.replays.Seek(V.want);
+  }
+  V.ply = ply < 0 ? 0 : ply > V.game.plies ? V.game.plies : ply;
+
+  if ((!V.shown || V.game.index != V.want) &&
+      ctx.replays.Fetch(V.want, &V.game)) {
+    V.shown = true;
+    V.ply = V.game.plies;
+  }
+}
+
+// ============================================================================
+// FUNCTION: DrawReplayScene
+// ============================================================================
+// ============= Objective =============
+// Game number, result and ply, the position after V.ply moves with the
+// last of them highlighted, the buttons and a key reminder. Without an
+// archive, where games come from.
+// ----------------------------------------------------------------------------
+void DrawReplayScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  const GameState &G = S.state;
+  const ReplayView &V = G.replay;
+  const ArchivedGame &g = V.game;
+  Color txt = G.darkMode ? WHITE : BLACK;
+  Color dim = G.darkMode ? LIGHTGRAY : DARKGRAY;
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+
+  if (!V.count) {
+    const char *none = "No games yet";
+    DrawText(none, (300 - MeasureText(none, 30)) / 2, 140, 30, txt);
+    const char *how = "finish a classic game, or run tournament --archive";
+    DrawText(how, (300 - MeasureText(how, 10)) / 2, 180, 10, dim);
+  } else {
+    const char *title = frame.Format("Game %u / %u", V.want + 1, V.count);
+    DrawText(title, (300 - MeasureText(title, 24)) / 2, 6, 24, txt);
+
+    const char *hint;
+    if (!V.shown || g.index != V.want)
+      hint = "reading...";
+    else if (!g.valid)
+      hint = "damaged record";
+    else
+      hint = frame.Format("%s  -  move %d of %d",
+                          g.result == RESULT_DRAW ? "Draw"
+                          : g.result == RESULT_X  ? "X wins"
+                                                  : "O wins",
+                          V.ply, g.plies);
+    DrawText(hint, (300 - MeasureText(hint, 10)) / 2, 33, 10, dim);
+
+    // Grid, last move, stones (X on even plies).
+    float cell = (float)RP_SIDE / V.size;
+    for (int i = 0; i <= V.size; i++) {
+      float at = i * cell;
+      DrawLineV({RP_LEFT + at, RP_TOP}, {RP_LEFT + at, RP_TOP + RP_SIDE}, dim);
+      DrawLineV({RP_LEFT, RP_TOP + at}, {RP_LEFT + RP_SIDE, RP_TOP + at}, dim);
+    }
+    if (V.shown && g.valid) {
+      for (int i = 0; i < V.ply; i++) {
+        int c = g.moves[i];
+        Rectangle r = {RP_LEFT + c % V.size * cell, RP_TOP + c / V.size * cell,
+                       cell, cell};
+        if (i == V.ply - 1)
+          DrawRectangleRec({r.x + 1, r.y + 1, cell - 1, cell - 1},
+                           Fade(GOLD, 0.4f));
+        const Texture2D &t = i % 2 == 0 ? A.tileX : A.tileO;
+        DrawTexturePro(t, {0, 0, (float)t.width, (float)t.height},
+                       {r.x + cell * 0.1f, r.y + cell * 0.1f, cell * 0.8f,
+                        cell * 0.8f},
+                       {0, 0}, 0.0f, WHITE);
+      }
+    }
+
+    if (!V.recording) {
+      const char *keys = "UP/DOWN game  PGUP/PGDN 100  LEFT/RIGHT move";
+      DrawText(keys, (300 - MeasureText(keys, 10)) / 2,
+               ROW_BTN_Y + ROW_BTN_H + 6, 10, dim);
+    }
+  }
+  if (V.recording)
+    return;
+
+  const char *labels[3] = {"PREV", "NEXT", "MENU"};
+  DrawButtonRow(G, A, ROW_BTN_Y, labels, 3);
+}
+
+// ============================================================================
+// BLITZ MODE
+// ============================================================================
+// The classic 3×3 game for two players against the clock: each starts with
+// the preset's base time and gains its increment after every move; whoever
+// runs out first loses. X's first move is free; O's clock starts with it.
+//
+// Every move is charged up to G.inputTime, the moment the render thread
+// polled the click, so a dropped frame or a slow logic step never costs the
+// player time. Flag fall is checked at the same timestamps.
+//
+struct BlitzPreset {
+  const char *label;
+  int base, increment; // seconds
+};
+
+static const BlitzPreset BLITZ_PRESETS[] = {
+    {"5+1", 5, 1}, {"15+2", 15, 2}, {"60+5", 60, 5}};
+
+constexpr int BLITZ_PRESET_COUNT =
+    sizeof(BLITZ_PRESETS) / sizeof(BLITZ_PRESETS[0]);
+
+// Bottom buttons (NEW, time control, MENU) under the board.
+constexpr int BZ_BTN_Y = 348;
+
+// ----------------------------------------------------------------------------
+// ResetBlitz: empty board, both clocks full and stopped. Keeps the preset.
+// ----------------------------------------------------------------------------
+void ResetBlitz(GameState &G) {
+  ResetBoard(G);
+  BlitzView &B = G.blitz;
+  const BlitzPreset &p = BLITZ_PRESETS[B.preset];
+  B.clock.Reset(p.base * NS_PER_SECOND, p.increment * NS_PER_SECOND);
+  B.flagged = 0;
+  B.lagWorst = 0;
+}
+
+void EnterBlitzScene(GameState &G, LogicContext &) { ResetBlitz(G); }
+
+// ----------------------------------------------------------------------------
+// EndBlitz: stop the clocks at `at` and log their ledger: what both players
+// were charged must add up to the length of the game.
+// ----------------------------------------------------------------------------
+void EndBlitz(GameState &G, int64_t at) {
+  GameClock &c = G.blitz.clock;
+  if (c.Running() < 0 && !G.blitz.flagged)
+    return; // ended before the clock started
+  c.Stop(at);
+  int64_t end = G.blitz.flagged ? c.Started() + c.Used(0) + c.Used(1) : at;
+  TraceLog(LOG_INFO,
+           "BLITZ: X %.3f s + O %.3f s charged over %.3f s (%lld ns "
+           "unaccounted); moves waited up to %.1f ms uncharged",
+           c.Used(0) * 1e-9, c.Used(1) * 1e-9, (end - c.Started()) * 1e-9,
+           (long long)(end - c.Started() - c.Used(0) - c.Used(1)),
+           G.blitz.lagWorst * 1e-6);
+}
+
+// ============================================================================
+// FUNCTION: UpdateBlitzScene
+// ============================================================================
+// ============= Objective =============
+// Moves, clocks and the NEW / time control / MENU buttons of the blitz mode.
+//
+// ============= Side Effects =============
+// - Presses the clock on every move, ends the game on flag fall, plays
+//   sounds and logs the clock ledger when a game ends.
+//
+// ============= Approach =============
+// The flag is checked at G.inputTime before a click is handled, so a move
+// polled in time counts even if the logic thread reaches it late; the step
+// without input checks it at the current time.
+// ----------------------------------------------------------------------------
+void UpdateBlitzScene(GameState &G, LogicContext &ctx) {
+  BlitzView &B = G.blitz;
+  int64_t at = G.inputTime;
+
+  if (!G.gameOver && B.clock.Flagged(at) >= 0) {
+    B.flagged = B.clock.Flagged(at) == 0 ? PLAYER_X : PLAYER_O;
+    G.winner = B.flagged == PLAYER_X ? PLAYER_O : PLAYER_X;
+    G.gameOver = true;
+    PlaySfx(ctx.A, SFX_WIN);
+    EndBlitz(G, at);
+  }
+  if (G.pressed || !G.clicked)
+    return;
+
+  // NEW / time control / MENU buttons.
+  switch (HandleButtonRow(G, ctx, BZ_BTN_Y, 3)) {
+  case 0:
+    ResetBlitz(G);
+    return;
+  case 1:
+    B.preset = (B.preset + 1) % BLITZ_PRESET_COUNT;
+    ResetBlitz(G);
+    return;
+  case 2:
+    ctx.scripts.Start(FadeToScene(G, SCENE_MENU));
+    return;
+  }
+
+  int idx = TileAt(G.mousePos);
+  if (G.gameOver || idx < 0 || G.board[idx] != EMPTY)
+    return;
+  PlaceMark(G, ctx.A, idx);
+  G.pressed = true;
+  if (B.clock.Running() < 0)
+    B.clock.Start(1, at);
+  else
+    B.clock.Press(at);
+  int64_t lag = MonotonicNs() - at;
+  B.lagWorst = lag > B.lagWorst ? lag : B.lagWorst;
+  if (G.gameOver)
+    EndBlitz(G, at);
+}
+
+// ============================================================================
+// FUNCTION: DrawBlitzScene
+// ============================================================================
+// ============= Objective =============
+// Both clocks (the running one bright, a fallen flag red), a status line,
+// the board and the buttons.
+//
+// ============= Approach =============
+// The time shown is computed from the snapshot's clock and the current
+// time, so it counts down smoothly at any frame rate and is right on the
+// first frame after a stall.
+// ----------------------------------------------------------------------------
+void DrawBlitzScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  const GameState &G = S.state;
+  const BlitzView &B = G.blitz;
+  Color txt = G.darkMode ? WHITE : BLACK;
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+
+  int64_t now = MonotonicNs();
+  for (int side = 0; side < 2; side++) {
+    int player = side == 0 ? PLAYER_X : PLAYER_O;
+    int64_t ms = B.clock.Remaining(side, now) / NS_PER_MS;
+    const char *shown =
+        ms < 20000 ? frame.Format("%s %lld.%lld", side ? "O" : "X",
+                                  (long long)(ms / 1000),
+                                  (long long)(ms / 100 % 10))
+                   : frame.Format("%s %lld:%02lld", side ? "O" : "X",
+                                  (long long)(ms / 60000),
+                                  (long long)(ms / 1000 % 60));
+    bool toMove = B.clock.Running() == side ||
+                  (B.clock.Running() < 0 && !G.gameOver && side == 0);
+    Color c = B.flagged == player ? RED : toMove ? txt : GRAY;
+    int w = MeasureText(shown, 30);
+    DrawText(shown, side ? 290 - w : 10, 8, 30, c);
+  }
+
+  const char *status;
+  if (!G.gameOver)
+    status = B.clock.Running() < 0 ? "X moves first; the clocks start then"
+                                   : "";
+  else if (B.flagged)
+    status = G.winner == PLAYER_X ? "X wins on time" : "O wins on time";
+  else
+    status = G.winner == RESULT_DRAW ? "Draw"
+             : G.winner == PLAYER_X  ? "X wins"
+                                     : "O wins";
+  DrawText(status, (300 - MeasureText(status, 10)) / 2, 44, 10,
+           G.darkMode ? LIGHTGRAY : DARKGRAY);
+
+  DrawGrid(G);
+  DrawBoard(G, A, frame);
+
+  const char *labels[3] = {"NEW", BLITZ_PRESETS[B.preset].label, "MENU"};
+  DrawButtonRow(G, A, BZ_BTN_Y, labels, 3);
+}
+
+// ============================================================================
+// RULE VARIANTS
+// ============================================================================
+// Wild 3×3, misère 3×3 and Order and Chaos for two players, each on its own
+// VariantBoard<Rules> from src/variants.h. The scene picks the variant's
+// functions from the VARIANTS table once per click; the board code behind
+// them is compiled separately for every rules policy.
+//
+constexpr float VR_SIDE = 280, VR_LEFT = 10, VR_TOP = 56;
+constexpr int VR_BTN_Y = 348;
+
+// ----------------------------------------------------------------------------
+// VariantOps: the scene's view of one variant, instantiated per rules policy
+// and the VariantView member holding its board.
+// ----------------------------------------------------------------------------
+template <class Rules, VariantBoard<Rules> VariantView::*Member>
+struct VariantOps {
+  using Position = VariantBoard<Rules>;
+
+  static void Reset(VariantView &V) { V.*Member = Position(); }
+
+  // Put `mark` (the mover's own one unless the rules allow either) in
+  // `cell`. Returns false if that is not a legal move.
+  static bool Play(VariantView &V, int cell, int mark) {
+    Position &b = V.*Member;
+    if (!Rules::EITHER_MARK)
+      mark = b.side;
+    if (!b.Legal(cell, mark))
+      return false;
+    b.Make(Position::Move(cell, mark));
+    return true;
+  }
+
+  // Side to move (0 / 1), result and the completed line.
+  static void Status(const VariantView &V, int *side, int *result,
+                     uint64_t *line) {
+    const Position &b = V.*Member;
+    *side = b.side;
+    *result = b.winner;
+    *line = b.line;
+  }
+
+  // Grid, marks and the completed line.
+  static void Draw(const VariantView &V, const Assets &A, Color grid) {
+    const Position &b = V.*Member;
+    float cell = VR_SIDE / Rules::SIZE;
+    for (int i = 0; i <= Rules::SIZE; i++) {
+      float at = i * cell;
+      DrawLineV({VR_LEFT + at, VR_TOP}, {VR_LEFT + at, VR_TOP + VR_SIDE},
+                grid);
+      DrawLineV({VR_LEFT, VR_TOP + at}, {VR_LEFT + VR_SIDE, VR_TOP + at},
+                grid);
+    }
+    for (int c = 0; c < Position::CELLS; c++) {
+      Rectangle r = {VR_LEFT + c % Rules::SIZE * cell,
+                     VR_TOP + c / Rules::SIZE * cell, cell, cell};
+      if (b.line >> c & 1)
+        DrawRectangleRec({r.x + 1, r.y + 1, cell - 1, cell - 1},
+                         Fade(GOLD, 0.4f));
+      if (!b.At(c))
+        continue;
+      const Texture2D &t = b.At(c) == RESULT_X ? A.tileX : A.tileO;
+      DrawTexturePro(t, {0, 0, (float)t.width, (float)t.height},
+                     {r.x + cell * 0.1f, r.y + cell * 0.1f, cell * 0.8f,
+                      cell * 0.8f},
+                     {0, 0}, 0.0f, WHITE);
+    }
+  }
+};
+
+// ============================================================================
+// TABLE: VARIANTS
+// ============================================================================
+// One row per variant, in the order the RULES button cycles through them.
+//
+// MEMBER VARIABLES:
+//   name    → title of the scene
+//   rules   → one-line summary under it
+//   players → what the first and second player are called
+//   size    → board side, for mapping clicks to cells
+//   either  → players choose the mark (the mark button is live)
+//   reset / play / status / draw → the VariantOps of the variant
+//
+struct VariantDesc {
+  const char *name;
+  const char *rules;
+  const char *players[2];
+  int size;
+  bool either;
+  void (*reset)(VariantView &V);
+  bool (*play)(VariantView &V, int cell, int mark);
+  void (*status)(const VariantView &V, int *side, int *result,
+                 uint64_t *line);
+  void (*draw)(const VariantView &V, const Assets &A, Color grid);
+};
+
+template <class Rules, VariantBoard<Rules> VariantView::*Member>
+constexpr VariantDesc MakeVariant(const char *name, const char *rules,
+                                  const char *first, const char *second) {
+  using Ops = VariantOps<Rules, Member>;
+  return {name, rules, {first, second}, Rules::SIZE, Rules::EITHER_MARK,
+          Ops::Reset, Ops::Play, Ops::Status, Ops::Draw};
+}
+
+static const VariantDesc VARIANTS[] = {
+    MakeVariant<WildRules, &VariantView::wild>(
+        "Wild 3x3", "place X or O; three of a kind in a row wins",
+        "Player 1", "Player 2"),
+    MakeVariant<MisereRules, &VariantView::misere>(
+        "Misere 3x3", "three of your own in a row loses", "X", "O"),
+    MakeVariant<OrderChaosRules, &VariantView::orderChaos>(
+        "Order & Chaos", "Order needs five in a row; Chaos fills the board",
+        "Order", "Chaos"),
+};
+
+constexpr int VARIANT_COUNT = sizeof(VARIANTS) / sizeof(VARIANTS[0]);
+
+// ----------------------------------------------------------------------------
+// EnterVariantScene: a fresh board of the variant last played.
+// ----------------------------------------------------------------------------
+void EnterVariantScene(GameState &G, LogicContext &) {
+  VARIANTS[G.variant.variant].reset(G.variant);
+}
+
+// ============================================================================
+// FUNCTION: UpdateVariantScene
+// ============================================================================
+// ============= Objective =============
+// Moves and the NEW / RULES / mark / MENU buttons of the variant scene.
+//
+// ============= Side Effects =============
+// - Plays the move on the variant's board, switches variants, plays sounds.
+// ----------------------------------------------------------------------------
+void UpdateVariantScene(GameState &G, LogicContext &ctx) {
+  if (G.pressed || !G.clicked)
+    return;
+  float x = G.mousePos.x, y = G.mousePos.y;
+  VariantView &V = G.variant;
+  const VariantDesc &d = VARIANTS[V.variant];
+
+  // NEW / RULES / mark / MENU buttons.
+  switch (HandleButtonRow(G, ctx, VR_BTN_Y, 4)) {
+  case 0:
+    d.reset(V);
+    return;
+  case 1:
+    V.variant = (V.variant + 1) % VARIANT_COUNT;
+    VARIANTS[V.variant].reset(V);
+    return;
+  case 2:
+    if (d.either)
+      V.mark ^= 1;
+    return;
+  case 3:
+    ctx.scripts.Start(FadeToScene(G, SCENE_MENU));
+    return;
+  }
+
+  float cell = VR_SIDE / d.size;
+  if (x < VR_LEFT || y < VR_TOP || x >= VR_LEFT + VR_SIDE ||
+      y >= VR_TOP + VR_SIDE)
+    return;
+  int at = (int)((y - VR_TOP) / cell) * d.size + (int)((x - VR_LEFT) / cell);
+  if (!d.play(V, at, V.mark))
+    return;
+  int side, result;
+  uint64_t line;
+  d.status(V, &side, &result, &line);
+  PlaySfx(ctx.A, result == RESULT_NONE ? SFX_PLACE : SFX_WIN);
+  G.pressed = true;
+}
+
+// ============================================================================
+// FUNCTION: DrawVariantScene
+// ============================================================================
+// ============= Objective =============
+// Turn or result line, the rules summary, the board and the buttons; the
+// mark button shows the mark the next move places (dimmed when the rules
+// fix it).
+// ----------------------------------------------------------------------------
+void DrawVariantScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  const GameState &G = S.state;
+  const VariantView &V = G.variant;
+  const VariantDesc &d = VARIANTS[V.variant];
+  Color txt = G.darkMode ? WHITE : BLACK;
+  Color dim = G.darkMode ? LIGHTGRAY : DARKGRAY;
+  DrawTexture(G.darkMode ? A.bgDark : A.bgLight, 0, 0, WHITE);
+
+  int side, result;
+  uint64_t line;
+  d.status(V, &side, &result, &line);
+  const char *title;
+  if (result == RESULT_NONE)
+    title = frame.Format("%s to move", d.players[side]);
+  else if (result == RESULT_DRAW)
+    title = "Draw";
+  else
+    title = frame.Format("%s wins", d.players[result == RESULT_X ? 0 : 1]);
+  DrawText(title, (300 - MeasureText(title, 26)) / 2, 4, 26, txt);
+  DrawText(d.name, (300 - MeasureText(d.name, 10)) / 2, 32, 10, txt);
+  DrawText(d.rules, (300 - MeasureText(d.rules, 10)) / 2, 44, 10, dim);
+
+  d.draw(V, A, dim);
+
+  int mark = d.either ? V.mark : side;
+  const char *labels[4] = {"NEW", "RULES", mark ? "O" : "X", "MENU"};
+  DrawButtonRow(G, A, VR_BTN_Y, labels, 4, d.either ? -1 : 2);
+}
+
+// ============================================================================
+// TABLE: SCENES
+// ============================================================================
+// The scene registry. Each entry declares everything the loops need to know
+// about one scene, so neither loop switches on the scene and adding a scene
+// is one enum value plus one row here.
+//
+// MEMBER VARIABLES:
+//   name     → for logs
+//   textures → TextureBit()s drawn by the scene; acquired by the render
+//              thread when the scene appears, released when it goes
+//   music    → background track while the scene is active
+//   enter    → logic thread, once when the scene becomes active (optional)
+//   exit     → logic thread, once when another scene takes over (optional)
+//   update   → logic thread, one step (input, AI...); never draws
+//   publish  → logic thread, adds scene data to a snapshot (optional)
+//   draw     → render thread, one frame from a snapshot
+//
+struct SceneDesc {
+  const char *name;
+  uint32_t textures;
+  Track music;
+  void (*enter)(GameState &G, LogicContext &ctx);
+  void (*exit)(GameState &G, LogicContext &ctx);
+  void (*update)(GameState &G, LogicContext &ctx);
+  void (*publish)(const GameState &G, LogicContext &ctx, Snapshot &s);
+  void (*draw)(const Snapshot &S, const Assets &A, LinearArena &frame);
+};
+
+// Backgrounds and buttons appear in every scene.
+constexpr uint32_t COMMON_TEXTURES =
+    TextureBit(TEX_BG_LIGHT) | TextureBit(TEX_BG_DARK) |
+    TextureBit(TEX_BUTTON_LIGHT) | TextureBit(TEX_BUTTON_DARK);
+
+static const SceneDesc SCENES[] = {
+    // SCENE_MENU: Play, VS CPU, Theme Toggle, Credits, Exit.
+    {"menu",
+     COMMON_TEXTURES | TextureBit(TEX_MENU_TITLE_LIGHT) |
+         TextureBit(TEX_MENU_TITLE_DARK),
+     TRACK_MENU, nullptr, nullptr,
+     [](GameState &G, LogicContext &ctx) {
+       HandleMenuInput(G, ctx.A, ctx.scripts);
+     },
+     nullptr,
+     [](const Snapshot &S, const Assets &A, LinearArena &) {
+       DrawMenu(S.state, A);
+     }},
+
+    // SCENE_GAME: every entry starts a fresh round; leaving stops pondering.
+    {"game",
+     COMMON_TEXTURES | TextureBit(TEX_TILE_BLANK) | TextureBit(TEX_TILE_X) |
+         TextureBit(TEX_TILE_O),
+     TRACK_GAME,
+     [](GameState &G, LogicContext &ctx) {
+       ResetBoard(G);
+       if (ctx.engine.Running())
+         ctx.engine.NewGame(3, 3);
+     },
+     [](GameState &, LogicContext &ctx) {
+       ctx.ai.StopPondering();
+       if (ctx.engine.Running())
+         ctx.engine.Stop();
+     },
+     UpdateGameScene, PublishGameScene, DrawGameScene},
+
+    // SCENE_CREDITS: BACK button and raylib.com link.
+    {"credits", COMMON_TEXTURES, TRACK_CREDITS, nullptr, nullptr,
+     [](GameState &G, LogicContext &ctx) {
+       HandleCreditsInput(G, ctx.A, ctx.scripts);
+     },
+     nullptr,
+     [](const Snapshot &S, const Assets &A, LinearArena &) {
+       DrawCredits(S.state, A);
+     }},
+
+    // SCENE_MODES: one button per MODES row, plus BACK.
+    {"modes", COMMON_TEXTURES, TRACK_MENU, nullptr, nullptr, HandleModesInput,
+     nullptr,
+     [](const Snapshot &S, const Assets &A, LinearArena &) {
+       DrawModes(S.state, A);
+     }},
+
+    // SCENE_INFINITE: a fresh unbounded board on every entry.
+    {"infinite",
+     COMMON_TEXTURES | TextureBit(TEX_TILE_X) | TextureBit(TEX_TILE_O),
+     TRACK_GAME, EnterInfiniteScene, nullptr, UpdateInfiniteScene,
+     PublishInfiniteScene, DrawInfiniteScene},
+
+    // SCENE_GRAVITY: a fresh 7×6 board on every entry.
+    {"gravity", COMMON_TEXTURES, TRACK_GAME, EnterGravityScene, nullptr,
+     UpdateGravityScene, PublishGravityScene, DrawGravityScene},
+
+    // SCENE_NOTAKTO: fresh boards on every entry, keeping the board count.
+    {"notakto", COMMON_TEXTURES | TextureBit(TEX_TILE_X), TRACK_GAME,
+     EnterNotaktoScene, nullptr, UpdateNotaktoScene, PublishNotaktoScene,
+     DrawNotaktoScene},
+
+    // SCENE_QUANTUM: an empty board on every entry.
+    {"quantum",
+     COMMON_TEXTURES | TextureBit(TEX_TILE_BLANK) | TextureBit(TEX_TILE_X) |
+         TextureBit(TEX_TILE_O),
+     TRACK_GAME, EnterQuantumScene, nullptr, UpdateQuantumScene, nullptr,
+     DrawQuantumScene},
+
+    // SCENE_PUZZLE: today's puzzle on every entry.
+    {"puzzle",
+     COMMON_TEXTURES | TextureBit(TEX_TILE_X) | TextureBit(TEX_TILE_O),
+     TRACK_GAME, EnterPuzzleScene, nullptr, UpdatePuzzleScene, nullptr,
+     DrawPuzzleScene},
+
+    // SCENE_REPLAY: the archive is streamed only while the scene is active.
+    {"replay",
+     COMMON_TEXTURES | TextureBit(TEX_TILE_X) | TextureBit(TEX_TILE_O),
+     TRACK_GAME, EnterReplayScene, ExitReplayScene, UpdateReplayScene, nullptr,
+     DrawReplayScene},
+
+    // SCENE_BLITZ: an empty board and full clocks on every entry.
+    {"blitz",
+     COMMON_TEXTURES | TextureBit(TEX_TILE_BLANK) | TextureBit(TEX_TILE_X) |
+         TextureBit(TEX_TILE_O),
+     TRACK_GAME, EnterBlitzScene, nullptr, UpdateBlitzScene, nullptr,
+     DrawBlitzScene},
+
+    // SCENE_VARIANT: a fresh board of the current variant on every entry.
+    {"variant",
+     COMMON_TEXTURES | TextureBit(TEX_TILE_X) | TextureBit(TEX_TILE_O),
+     TRACK_GAME, EnterVariantScene, nullptr, UpdateVariantScene, nullptr,
+     DrawVariantScene},
+};
+
+static_assert(sizeof(SCENES) / sizeof(SCENES[0]) == SCENE_COUNT - SCENE_MENU,
+              "one SCENES row per SceneName");
+
+const SceneDesc &SceneOf(SceneName scene) { return SCENES[scene - SCENE_MENU]; }
+
+// ============================================================================
+// FUNCTION: UpdateScene
+// ============================================================================
+// ============= Objective =============
+// Run one logic step for the active scene. Never draws anything.
+//
+// ============= Input Parameters =============
+// GameState &G → the logic thread's mutable state
+// LogicContext &ctx → sounds, CPU opponent, engine, scripts
+//
+// ============= Output =============
+// Mutates G according to the scene's rules.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - Whatever the scene's update entry point does.
+//
+// ============= Approach =============
+// Nothing happens while a transition is fading (G.fade > 0): the scene is
+// about to change under the player's click.
+// ----------------------------------------------------------------------------
+void UpdateScene(GameState &G, LogicContext &ctx) {
+  if (G.fade > 0.0f)
+    return;
+  SceneOf(G.scene).update(G, ctx);
+}
+
+// ============================================================================
+// FUNCTION: DrawScene
+// ============================================================================
+// ============= Objective =============
+// Draw one frame of the scene described by a snapshot.
+//
+// ============= Input Parameters =============
+// const Snapshot &S → immutable snapshot published by the logic thread
+// const Assets &A → textures
+// LinearArena &frame → render thread's per-frame arena
+//
+// ============= Output =============
+// Draws the menu, game or credits UI.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - GPU draw calls; must run on the render thread between
+//   BeginDrawing() and EndDrawing().
+//
+// ============= Approach =============
+// Call the snapshot scene's draw entry point, then cover it with the
+// transition fade, if one is running.
+// ----------------------------------------------------------------------------
+void DrawScene(const Snapshot &S, const Assets &A, LinearArena &frame) {
+  SceneOf(S.state.scene).draw(S, A, frame);
+
+  if (S.state.fade > 0.0f)
+    DrawRectangle(0, 0, 300, 400, Fade(BLACK, S.state.fade));
+}
+
+// ============================================================================
+// FUNCTION: ShowScene
+// ============================================================================
+// ============= Objective =============
+// Make the textures of the scene the render thread is about to draw
+// resident, and release the ones of the scene it drew before.
+//
+// ============= Input Parameters =============
+// Assets &A → textures and reference counts
+// int &shown → scene drawn last frame (0 before the first frame); updated
+// SceneName next → scene of the snapshot about to be drawn
+//
+// ============= Side Effects =============
+// - Loads / unloads textures on scene changes (render thread only).
+//
+// ============= Approach =============
+// Acquire before release, so shared textures never reload. Scene changes
+// happen at the darkest point of a fade, which hides the load.
+// ----------------------------------------------------------------------------
+void ShowScene(Assets &A, int &shown, SceneName next) {
+  if (shown == next)
+    return;
+  TraceLog(LOG_INFO, "SCENE: %s", SceneOf(next).name);
+  AcquireTextures(A, SceneOf(next).textures);
+  if (shown)
+    ReleaseTextures(A, SceneOf((SceneName)shown).textures);
+  shown = next;
+}
+
+// ============================================================================
+// FUNCTION: PublishSnapshot
+// ============================================================================
+// ============= Objective =============
+// Hand the render thread a copy of G together with the data the scene's
+// publish hook prepares (HUD text, visible stones...).
+//
+// ============= Input Parameters =============
+// const GameState &G → state to publish
+// LogicContext &ctx → logic-thread objects the publish hook may read
+// FrameLink &link → owner of the snapshot triple buffer
+//
+// ============= Output =============
+// Fills the writer's slot and publishes it.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - None beyond the slot; no heap allocation.
+//
+// ============= Approach =============
+// The writer's slot is not visible to the render thread until Publish(), so
+// its arena can be reset and refilled here without any locking.
+// ----------------------------------------------------------------------------
+void PublishSnapshot(const GameState &G, LogicContext &ctx, FrameLink &link) {
+  Snapshot &s = link.snapshots.Write();
+  s.state = G;
+  s.arena.Reset();
+  s.cpuLine = "";
+  s.stones = nullptr;
+  s.stoneCount = 0;
+
+  if (SceneOf(G.scene).publish)
+    SceneOf(G.scene).publish(G, ctx, s);
+
+  link.snapshots.Publish();
+}
+
+// ============================================================================
+// FUNCTION: LogicLoop
+// ============================================================================
+// ============= Objective =============
+// Body of the logic thread: consume clicks, advance the game and publish a
+// snapshot of the renderable state after every step.
+//
+// ============= Input Parameters =============
+// GameState &G → the only mutable GameState; owned by this thread
+// const Assets &A → audio queue for sound effects
+// FrameLink &link → input queue, snapshot buffer and running flag
+// AiPlayer &ai → built-in CPU opponent
+// EngineClient &engine → optional external engine
+// const char *replayPath → archive shown by the replay scene
+//
+// ============= Output =============
+// Publishes GameState snapshots until link.running is cleared or the player
+// presses EXIT.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - Everything UpdateScene() does.
+// - Runs the scenes' enter / exit hooks.
+//
+// ============= Approach =============
+// - Advance running scripts (transitions) to the current time.
+// - Each queued click (or key) is handled in its own step with G.clicked
+//   (or G.key) set, exactly
+//   like one frame of the old single-threaded loop.
+// - One extra step without a click lets the CPU and external engine act.
+// - When G.scene changed, run the old scene's exit hook and the new one's
+//   enter hook, and ask the audio thread for the new scene's music.
+// - Publish the new state (and, if it changed, the observers' copy), then
+//   sleep briefly. A slow step (AI search, I/O) only delays the next
+//   snapshot; the render thread keeps drawing the previous one at full
+//   frame rate.
+// ----------------------------------------------------------------------------
+void LogicLoop(GameState &G, const Assets &A, FrameLink &link, AiPlayer &ai,
+               EngineClient &engine, const char *replayPath) {
+  ScriptRunner scripts;
+  InfiniteBoard infinite(INFINITE_WIN);
+  GravitySolver gravity;
+  Analyser analyser;
+  PuzzlePack puzzles;
+  char puzzlePath[128];
+  PuzzlePath(puzzlePath, sizeof(puzzlePath), PUZZLE_SIDE, PUZZLE_WIN);
+  if (!puzzles.Open(puzzlePath, PUZZLE_SIDE, PUZZLE_WIN))
+    TraceLog(LOG_INFO, "PUZZLE: no pack at %s (make puzzles)", puzzlePath);
+  ArchiveWriter archive;
+  char archivePath[128];
+  ArchivePath(archivePath, sizeof(archivePath), 3, 3);
+  if (!archive.Open(archivePath, 3, 3))
+    TraceLog(LOG_WARNING, "ARCHIVE: cannot append to %s", archivePath);
+  ArchiveStreamer replays;
+  LogicContext ctx{A,        ai,      engine,   scripts, infinite, gravity,
+                   analyser, puzzles, archive, replays,  replayPath};
+  int entered = 0; // scene whose enter hook ran last
+  bool musicPosted = false;
+  GameState observed = G; // last state given to link.observed
+  link.observed.Store(G);
+  const auto start = std::chrono::steady_clock::now();
+  while (link.running.load(std::memory_order_relaxed)) {
+    // Resume scripts whose wait is over before handling new input.
+    scripts.Tick(std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count());
+
+    InputEvent ev;
+    while (link.input.Pop(ev)) {
+      G.inputTime = ev.time;
+      if (ev.key) {
+        G.key = ev.key;
+      } else {
+        G.mousePos = ev.pos;
+        G.clicked = true;
+      }
+      UpdateScene(G, ctx);
+
+      // CLICK DEBOUNCING RESET: the click or key has been consumed.
+      G.clicked = false;
+      G.key = 0;
+      G.pressed = false;
+    }
+    G.inputTime = MonotonicNs();
+    UpdateScene(G, ctx);
+
+    // Scene change (also the first step): exit / enter hooks, then music.
+    if (entered != G.scene) {
+      if (entered && SceneOf((SceneName)entered).exit)
+        SceneOf((SceneName)entered).exit(G, ctx);
+      entered = G.scene;
+      if (SceneOf(G.scene).enter)
+        SceneOf(G.scene).enter(G, ctx);
+      musicPosted = false;
+    }
+    // Retried on later steps if the audio queue was full.
+    if (!musicPosted)
+      musicPosted = A.audio->Post(AUDIO_MUSIC, SFX_PRESS, 1.0f,
+                                  SceneOf(G.scene).music);
+
+    // Hand an immutable copy to the render thread.
+    PublishSnapshot(G, ctx, link);
+
+    // Observers only see a new version when something actually changed.
+    // Byte-wise on both sides, so padding can't cause spurious versions.
+    if (memcmp(&observed, &G, sizeof(GameState)) != 0) {
+      memcpy(&observed, &G, sizeof(GameState));
+      link.observed.Store(G);
+    }
+
+    if (G.quit)
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+}
+
+// ============================================================================
+// FUNCTION: ObserverLoop
+// ============================================================================
+// ============= Objective =============
+// Example observer (--observe): a metrics exporter that logs every move and
+// result by sampling the published GameState ten times a second.
+//
+// ============= Input Parameters =============
+// const FrameLink &link → observed state and running flag
+//
+// ============= Side Effects =============
+// - Writes "OBSERVE:" lines to the log.
+//
+// ============= Approach =============
+// Version() tells cheaply whether anything changed; Load() then copies a
+// consistent state. Neither ever makes the logic thread wait, however many
+// observers run.
+// ----------------------------------------------------------------------------
+void ObserverLoop(const FrameLink &link) {
+  uint64_t seen = 0;
+  int lastPly = -1, lastWinner = 0;
+  while (link.running.load(std::memory_order_relaxed)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (link.observed.Version() == seen)
+      continue;
+    seen = link.observed.Version();
+
+    GameState G = link.observed.Load();
+    if (G.history.ply != lastPly && G.history.ply > 0) {
+      const MoveRecord &m = G.history.moves[G.history.ply - 1];
+      TraceLog(LOG_INFO, "OBSERVE: ply %d, %c on cell %d", G.history.ply,
+               G.history.ply % 2 ? 'X' : 'O', m.cell);
+    }
+    if (G.winner && G.winner != lastWinner)
+      TraceLog(LOG_INFO, "OBSERVE: %s", G.winner == 3 ? "draw"
+                                         : G.winner == PLAYER_X ? "X wins"
+                                                                : "O wins");
+    lastPly = G.history.ply;
+    lastWinner = G.winner;
+  }
+}
+
+// ============================================================================
+// STRUCT: MusicPlayer
+// ============================================================================
+// Background music for AudioLoop(): streams one compressed track per scene
+// and crossfades between them. Audio thread only.
+//
+// A raylib Music stream keeps just the decoder state and a small ring of PCM
+// sub-buffers; every Update() decodes the next chunk of the file into
+// whichever sub-buffer the mixer has finished playing. Memory therefore
+// depends on MUSIC_BUFFER_FRAMES, not on track length, and at the end of a
+// track the decoder seeks back and keeps filling the same sub-buffer, so
+// loops are gapless.
+//
+// A scene change moves the playing track to the `outgoing` deck and fades it
+// out while the new track fades in on `incoming`. A track whose file is
+// missing is silence.
+//
+// MEMBER VARIABLES:
+//   incoming / outgoing → the two decks; `loaded` marks a valid stream
+//   current             → track on the incoming deck
+//   outgoingGain        → volume the outgoing deck had when the fade began
+//   fadeStart           → when the current crossfade began
+//
+static const char *TRACK_FILES[TRACK_COUNT] = {
+    nullptr, "resources/music/menu.ogg", "resources/music/game.ogg",
+    "resources/music/credits.ogg"};
+
+// Stereo 16-bit at 44.1 kHz: 4096 frames × 2 sub-buffers = 32 KB per deck.
+constexpr int MUSIC_BUFFER_FRAMES = 4096;
+constexpr float CROSSFADE_SECONDS = 1.5f;
+
+struct MusicDeck {
+  Music music{};
+  bool loaded = false;
+};
+
+struct MusicPlayer {
+  MusicDeck incoming, outgoing;
+  Track current = TRACK_NONE;
+  float outgoingGain = 0.0f;
+  std::chrono::steady_clock::time_point fadeStart;
+
+  // Start crossfading to `track`.
+  void Play(Track track) {
+    if (track == current)
+      return;
+    // A third change during a fade drops the oldest track at once.
+    Unload(outgoing);
+    outgoingGain = FadeIn();
+    outgoing = incoming;
+    incoming = MusicDeck();
+    current = track;
+    fadeStart = std::chrono::steady_clock::now();
+
+    const char *file = TRACK_FILES[track];
+    if (!file || !FileExists(file))
+      return;
+    incoming.music = LoadMusicStream(file);
+    incoming.loaded = IsMusicValid(incoming.music);
+    if (!incoming.loaded)
+      return;
+    incoming.music.looping = true;
+    SetMusicVolume(incoming.music, 0.0f);
+    PlayMusicStream(incoming.music);
+  }
+
+  // Advance the fade and decode whatever the mixer has consumed.
+  void Update() {
+    float in = FadeIn();
+    if (incoming.loaded) {
+      SetMusicVolume(incoming.music, in);
+      UpdateMusicStream(incoming.music);
+    }
+    if (outgoing.loaded) {
+      if (in >= 1.0f) {
+        Unload(outgoing);
+      } else {
+        SetMusicVolume(outgoing.music, outgoingGain * (1.0f - in));
+        UpdateMusicStream(outgoing.music);
+      }
+    }
+  }
+
+  void Stop() {
+    Unload(incoming);
+    Unload(outgoing);
+  }
+
+private:
+  // Fade-in progress of the incoming deck, 0..1.
+  float FadeIn() const {
+    float t = std::chrono::duration<float>(std::chrono::steady_clock::now() -
+                                           fadeStart)
+                  .count();
+    return t >= CROSSFADE_SECONDS ? 1.0f : t / CROSSFADE_SECONDS;
+  }
+
+  static void Unload(MusicDeck &deck) {
+    if (deck.loaded) {
+      StopMusicStream(deck.music);
+      UnloadMusicStream(deck.music);
+    }
+    deck = MusicDeck();
+  }
+};
+
+// ============================================================================
+// FUNCTION: AudioLoop
+// ============================================================================
+// ============= Objective =============
+// Body of the audio thread: own the audio device, the sound effects and the
+// background music, and execute the commands game logic posts through
+// PlaySfx() / AudioLink.
+//
+// ============= Input Parameters =============
+// AudioLink &audio → command queue and running flag
+//
+// ============= Output =============
+// Plays sounds and music until audio.running is cleared.
+//
+// ============= Return Value =============
+// None.
+//
+// ============= Side Effects =============
+// - Initializes and closes the audio device.
+// - Loads sound data into RAM and frees it on exit.
+// - Streams music files from resources/music/.
+//
+// ============= Approach =============
+// Every raylib audio call in the game happens here, so mixer locks, device
+// work and music decoding never run on the render or logic thread. Commands
+// posted before the sounds finish loading simply wait in the queue. Each
+// pass drains the queue, tops up the music streams and naps for a
+// millisecond: far below what a player can hear, and far inside the ~90 ms
+// one music sub-buffer lasts.
+// ----------------------------------------------------------------------------
+void AudioLoop(AudioLink &audio) {
+  InitAudioDevice();
+  SetAudioStreamBufferSizeDefault(MUSIC_BUFFER_FRAMES);
+
+  Sound sounds[SFX_COUNT];
+  sounds[SFX_PRESS] = LoadSound("resources/BtnPress.wav");
+  sounds[SFX_PLACE] = LoadSound("resources/Place.wav");
+  sounds[SFX_WIN] = LoadSound("resources/Win.wav");
+  MusicPlayer music;
+
+  while (audio.running.load(std::memory_order_relaxed)) {
+    AudioCommand c;
+    while (audio.commands.Pop(c)) {
+      switch (c.op) {
+      case AUDIO_PLAY:
+        PlaySound(sounds[c.sfx]);
+        break;
+      case AUDIO_STOP:
+        StopSound(sounds[c.sfx]);
+        break;
+      case AUDIO_SFX_VOLUME:
+        SetSoundVolume(sounds[c.sfx], c.value);
+        break;
+      case AUDIO_MASTER_VOLUME:
+        SetMasterVolume(c.value);
+        break;
+      case AUDIO_MUSIC:
+        music.Play(c.track);
+        break;
+      }
+    }
+    music.Update();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  music.Stop();
+  for (Sound &snd : sounds)
+    UnloadSound(snd);
+  CloseAudioDevice();
+}
+
+// ============================================================================
+// REPLAY EXPORT
+// ============================================================================
+// --export FILE renders archived games to an animated GIF (or, through
+// ffmpeg, any video format) without showing a window:
+//
+//   render   → each distinct position is drawn once by DrawScene() (the
+//              replay scene's own drawing) into an offscreen render texture
+//   readback → PixelReadback copies the texture into one of two pixel-pack
+//              buffers; the GPU finishes the copy while the next frame is
+//              drawn, and the buffer is only mapped a frame later, so the
+//              render loop never waits for a synchronous glReadPixels()
+//   encode   → the pixels go into a FrameEncoder buffer together with how
+//              long the position stays on screen, and the encoder thread
+//              writes them out; its bounded queue is the only back-pressure
+//
+// Nothing is paced to the frame rate: a position held for a second costs
+// one render, one readback and one encode, so exports run many times faster
+// than they play back.
+//
+constexpr int EXPORT_FPS = 30;
+constexpr int EXPORT_PLY_FRAMES = 15; // half a second per move
+constexpr int EXPORT_END_FRAMES = 60; // two seconds on the final position
+
+// ============================================================================
+// CLASS: PixelReadback
+// ============================================================================
+// Double-buffered asynchronous glReadPixels() through pixel-pack buffers.
+// Start() queues a copy of a render texture into the free buffer with a
+// fence behind it; Finish() maps the oldest queued buffer, waiting on its
+// fence only if the GPU is still behind (counted in Stalls()). Calling
+// Finish() only once both buffers are queued keeps one frame in flight.
+//
+class PixelReadback {
+public:
+  void Init(int width, int height) {
+    w = width;
+    h = height;
+    glGenBuffers(2, pbo);
+    for (GLuint b : pbo) {
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, b);
+      glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)w * h * 4, nullptr,
+                   GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+
+  void Free() {
+    for (GLsync &f : fence)
+      if (f)
+        glDeleteSync(f);
+    glDeleteBuffers(2, pbo);
+  }
+
+  int Pending() const { return pending; }
+  uint64_t Stalls() const { return stalls; }
+
+  // Queue a copy of `target` (pending must be below 2).
+  void Start(const RenderTexture2D &target) {
+    int i = (oldest + pending) % 2;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+    glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    fence[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    pending++;
+  }
+
+  // Copy the oldest queued frame (rows bottom-up) into `out`.
+  bool Finish(uint8_t *out) {
+    if (!pending)
+      return false;
+    int i = oldest;
+    if (glClientWaitSync(fence[i], 0, 0) == GL_TIMEOUT_EXPIRED) {
+      stalls++;
+      glClientWaitSync(fence[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    }
+    glDeleteSync(fence[i]);
+    fence[i] = nullptr;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+    const void *p = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                     (GLsizeiptr)w * h * 4, GL_MAP_READ_BIT);
+    if (p)
+      memcpy(out, p, (size_t)w * h * 4);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    oldest ^= 1;
+    pending--;
+    return p != nullptr;
+  }
+
+private:
+  int w = 0, h = 0;
+  GLuint pbo[2] = {0, 0};
+  GLsync fence[2] = {nullptr, nullptr};
+  int oldest = 0, pending = 0;
+  uint64_t stalls = 0;
+};
+
+// ============================================================================
+// FUNCTION: ExportReplays
+// ============================================================================
+// ============= Objective =============
+// Render games [first, first + games) of an archive to a video file.
+//
+// ============= Input Parameters =============
+// const char *out         → output file; *.gif is written directly, other
+//                           extensions are encoded by ffmpeg
+// const char *archivePath → game archive (see src/archive.h)
+// uint32_t first, games   → range of games, 0-based, clipped to the archive
+//
+// ============= Return Value =============
+// int → process exit code: 0 on success, 1 on any error.
+//
+// ============= Side Effects =============
+// - Needs an OpenGL context (InitWindow(), hidden); loads and frees the
+//   replay scene's textures. Logs throughput when done.
+//
+// ============= Approach =============
+// See REPLAY EXPORT above. The games are read through ArchiveStreamer, so
+// the next game is already decoded when the last frame of one is drawn.
+// Each submitted frame's hold time travels in a two-entry FIFO next to the
+// readback, which hands frames out one step late.
+// ----------------------------------------------------------------------------
+int ExportReplays(const char *out, const char *archivePath, uint32_t first,
+                  uint32_t games) {
+  ArchiveStreamer archive;
+  if (!archive.Open(archivePath)) {
+    TraceLog(LOG_ERROR, "EXPORT: no archive at %s", archivePath);
+    return 1;
+  }
+  uint32_t end = first + games < archive.Count() ? first + games
+                                                 : archive.Count();
+  if (first >= end) {
+    TraceLog(LOG_ERROR, "EXPORT: %s has only %u games", archivePath,
+             archive.Count());
+    return 1;
+  }
+
+  FrameEncoder encoder;
+  if (!encoder.Open(out, 300, 400, EXPORT_FPS)) {
+    TraceLog(LOG_ERROR, "EXPORT: cannot write %s", out);
+    return 1;
+  }
+
+  Assets A;
+  A.glyphs.Build(GetFontDefault());
+  int shown = 0;
+  ShowScene(A, shown, SCENE_REPLAY);
+  RenderTexture2D target = LoadRenderTexture(300, 400);
+  PixelReadback readback;
+  readback.Init(300, 400);
+  LinearArena frame(16 * 1024);
+
+  Snapshot S;
+  S.state.scene = SCENE_REPLAY;
+  ReplayView &V = S.state.replay;
+  V.count = archive.Count();
+  V.size = archive.Size();
+  V.shown = true;
+  V.recording = true;
+
+  int holds[2] = {0, 0}; // frames each queued readback stays on screen
+  uint64_t rendered = 0, videoFrames = 0;
+  auto Hand = [&]() {
+    uint8_t *pixels = encoder.Acquire();
+    int hold = holds[0];
+    holds[0] = holds[1];
+    readback.Finish(pixels);
+    encoder.Submit(pixels, hold);
+    videoFrames += hold;
+  };
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t g = first; g < end; g++) {
+    archive.Seek(g);
+    while (!archive.Fetch(g, &V.game))
+      std::this_thread::yield();
+    V.want = g;
+    for (int ply = 0; ply <= V.game.plies; ply++) {
+      V.ply = ply;
+      BeginTextureMode(target);
+      DrawScene(S, A, frame);
+      EndTextureMode();
+      frame.Reset();
+
+      holds[readback.Pending()] =
+          ply == V.game.plies ? EXPORT_END_FRAMES : EXPORT_PLY_FRAMES;
+      readback.Start(target);
+      rendered++;
+      if (readback.Pending() == 2)
+        Hand();
+    }
+  }
+  while (readback.Pending())
+    Hand();
+  bool ok = encoder.Close();
+  double secs = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - t0)
+                    .count();
+
+  TraceLog(LOG_INFO,
+           "EXPORT: %u games, %llu frames rendered, %.1f s of video in "
+           "%.2f s (%.0fx real time); %llu readback stalls, encoder queue "
+           "full %llu times",
+           end - first, (unsigned long long)rendered,
+           (double)videoFrames / EXPORT_FPS, secs,
+           videoFrames / (double)EXPORT_FPS / secs,
+           (unsigned long long)readback.Stalls(),
+           (unsigned long long)encoder.Waits());
+  readback.Free();
+  UnloadRenderTexture(target);
+  ReleaseTextures(A, SceneOf(SCENE_REPLAY).textures);
+  if (!ok)
+    TraceLog(LOG_ERROR, "EXPORT: writing %s failed", out);
+  return ok ? 0 : 1;
+}
+
+// ============================================================================
+// FUNCTION: main
+// ============================================================================
+// ============= Objective =============
+// The central function that initializes the game, loads assets, starts the
+// logic thread and runs the render loop for:
+//   - Main Menu
+//   - Game Scene
+//   - Credits Scene
+//
+// ============= Input Parameters =============
+// int argc, char **argv → command line. Supported options:
+//   --engine "<command>" → play VS CPU against an external TTTP engine
+//                          process (see src/protocol.h) instead of the
+//                          built-in AI.
+//   --dev                → watch resources/ and reload edited textures
+//                          while the game runs.
+//   --observe            → log moves from an observer thread that samples
+//                          the published GameState.
+//   --replay FILE        → game archive for the replay scene (default: the
+//                          classic games, resources/games_3x3_k3.bin).
+//   --export OUT         → don't play: render archived games to OUT (*.gif,
+//                          or any format ffmpeg knows) and exit. Picks the
+//                          games with --export-from N (1-based, default 1)
+//                          and --export-games N (default 1).
+//
+// ============= Output =============
+// Renders the entire game window frame-by-frame until the user closes it.
+//
+// ============= Return Value =============
+// int → returns 0 on normal, successful program termination.
+//
+// ============= Side Effects =============
+// - Opens a graphical window.
+// - Loads and frees GPU textures as scenes come and go.
+// - Starts the audio and logic threads and joins them on exit.
+// - Runs a loop until the EXIT button or an OS close event.
+//
+// ============= Approach =============
+// - --export: ExportReplays() in a hidden window, then exit.
+// - Initialize the window (this thread owns the GL context and the OS
+//   event queue, so it is the render + input thread).
+// - Start AudioLoop() on its own thread; it owns the audio device.
+// - Start LogicLoop() on its own thread with the one mutable GameState.
+// - Enter render loop:
+//       - Forward left clicks and timeline keys to the logic thread
+//       - Take the newest snapshot (never waits for logic)
+//       - ShowScene(): swap texture sets when the snapshot's scene changed
+//       - BeginDrawing() / DrawScene() / EndDrawing()
+//       - Reset the per-frame arena
+//       - --dev: install at most one reloaded texture
+// - Log how many frames touched the heap (should be none).
+// - Exit when WindowShouldClose() becomes true or the snapshot asks to quit.
+// ----------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  // Archive of the replay scene and --export.
+  char replayPath[256];
+  ArchivePath(replayPath, sizeof(replayPath), 3, 3);
+  const char *exportPath = nullptr;
+  uint32_t exportFrom = 1, exportGames = 1;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (TextIsEqual(argv[i], "--replay"))
+      snprintf(replayPath, sizeof(replayPath), "%s", argv[i + 1]);
+    else if (TextIsEqual(argv[i], "--export"))
+      exportPath = argv[i + 1];
+    else if (TextIsEqual(argv[i], "--export-from"))
+      exportFrom = (uint32_t)atoi(argv[i + 1]);
+    else if (TextIsEqual(argv[i], "--export-games"))
+      exportGames = (uint32_t)atoi(argv[i + 1]);
+  }
+
+  // ------------------------------------------------------------------------
+  // Offscreen export: a hidden window for the GL context, no other threads.
+  // ------------------------------------------------------------------------
+  if (exportPath) {
+    signal(SIGPIPE, SIG_IGN); // a failing ffmpeg fails the export instead
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(300, 400, "Tic Tac Toe");
+    int rc = ExportReplays(exportPath, replayPath,
+                           exportFrom > 0 ? exportFrom - 1 : 0, exportGames);
+    CloseWindow();
+    return rc;
+  }
+
+  // ------------------------------------------------------------------------
+  // Window Initialization
+  // ------------------------------------------------------------------------
+  // Create the window with fixed width and height.
+  InitWindow(300, 400, "Tic Tac Toe");
+
+  // Limit the render loop to 60 frames per second.
   SetTargetFPS(60);
 
   // ------------------------------------------------------------------------
@@ -738,107 +4368,138 @@ int main() {
   GameState G; // Defaults to menu scene, X turn, board empty.
 
   // ------------------------------------------------------------------------
-  // Load all assets (textures & sounds) at startup.
+  // Audio thread: owns the audio device and loads the sound effects.
+  // ------------------------------------------------------------------------
+  AudioLink audioLink;
+  std::thread audio(AudioLoop, std::ref(audioLink));
+
+  // ------------------------------------------------------------------------
+  // Textures are loaded per scene by ShowScene() in the render loop.
+  // ------------------------------------------------------------------------
+  Assets A;
+  A.audio = &audioLink;
+  A.glyphs.Build(GetFontDefault());
+
+  // ------------------------------------------------------------------------
+  // CPU opponent for VS CPU mode (maps the 3×3 opening book if present).
+  // ------------------------------------------------------------------------
+  AiPlayer ai(3, 3, SearchLimits(), 1 << 16);
+
+  // External engine, only started when requested on the command line.
+  EngineClient engine;
+  for (int i = 1; i + 1 < argc; i++)
+    if (TextIsEqual(argv[i], "--engine")) {
+      signal(SIGPIPE, SIG_IGN); // a dead engine must not kill the game
+      if (!engine.Start(argv[i + 1], 3, 3))
+        TraceLog(LOG_WARNING, "Could not start engine: %s", argv[i + 1]);
+    }
+
+  // Development mode: reload textures when artists save resources/*.png.
+  HotReloader<Image> reloader;
+  for (int i = 1; i < argc; i++)
+    if (TextIsEqual(argv[i], "--dev") &&
+        !reloader.Start("resources", ".png", DecodeImageFile, ReleaseImage))
+      TraceLog(LOG_WARNING, "Could not watch resources/ for changes");
+
+  // ------------------------------------------------------------------------
+  // Start the logic thread. From here on only it touches G, ai and engine.
   // ------------------------------------------------------------------------
-  Assets A = LoadAssets();
+  FrameLink link; // all slots start as a default (menu) snapshot, like G
+  std::thread logic(LogicLoop, std::ref(G), std::cref(A), std::ref(link),
+                    std::ref(ai), std::ref(engine), (const char *)replayPath);
+
+  // Optional example observer of the published state.
+  std::thread observer;
+  for (int i = 1; i < argc; i++)
+    if (TextIsEqual(argv[i], "--observe"))
+      observer = std::thread(ObserverLoop, std::cref(link));
 
   // =========================================================================
-  // MAIN GAME LOOP
+  // RENDER LOOP
   // =========================================================================
   // This loop continues running until:
   // - The user closes the window (clicking X)
-  // - Or CloseWindow() is called explicitly (Exit button)
+  // - Or the EXIT button sets quit in a published snapshot
   // WindowShouldClose() queries OS events to know if the window must shut.
+  //
+  // Transient per-frame data (draw lists, layout) comes from `frame`, which
+  // is reset at the end of every iteration; the heap counters check that an
+  // iteration never falls back to the general heap.
+  LinearArena frame(16 * 1024);
+  uint64_t frames = 0, heapFrames = 0;
+  int shownScene = 0; // no scene textures resident yet
   while (!WindowShouldClose()) {
-    // ---------------------------------------------------------------------
-    // Update: Read current mouse position for this frame.
-    // ---------------------------------------------------------------------
-    G.mousePos = GetMousePosition();
+    uint64_t heapBefore = HeapCounters::ThreadAllocations();
 
     // ---------------------------------------------------------------------
-    // Begin drawing the new frame.
+    // Input: forward this frame's clicks and keys to the logic thread,
+    // stamped with the time EndDrawing() polled them.
     // ---------------------------------------------------------------------
-    BeginDrawing();
+    int64_t polled = MonotonicNs();
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+      link.input.Push(InputEvent{GetMousePosition(), 0, polled});
+    // Held navigation keys repeat, so the replay scene can flip through
+    // games as fast as the key repeat goes.
+    for (int key : {KEY_LEFT, KEY_RIGHT, KEY_UP, KEY_DOWN, KEY_HOME, KEY_END,
+                    KEY_PAGE_UP, KEY_PAGE_DOWN, KEY_A})
+      if (IsKeyPressed(key) || (key != KEY_A && IsKeyPressedRepeat(key)))
+        link.input.Push(InputEvent{GetMousePosition(), key, polled});
 
     // ---------------------------------------------------------------------
-    // SCENE SWITCHING LOGIC
+    // Newest complete state; stays untouched while we draw it.
     // ---------------------------------------------------------------------
-    switch (G.scene) {
-    // =====================================================================
-    // SCENE: MAIN MENU
-    // =====================================================================
-    case SCENE_MENU:
-      // Draw the menu UI (buttons, background, title).
-      DrawMenu(G, A);
-
-      // Handle input for menu: Play, Theme Toggle, Credits, Exit.
-      HandleMenuInput(G, A);
+    const Snapshot &S = link.snapshots.Read();
+    if (S.state.quit)
       break;
-
-    // =====================================================================
-    // SCENE: GAMEPLAY SCENE
-    // =====================================================================
-    case SCENE_GAME:
-
-      // Draw the entire game interface:
-      // - background
-      // - current turn OR winner text
-      // - grid lines
-      // - tiles
-      DrawGameScene(G, A);
-
-      // --------------------------------------------------------------
-      // If the game is still running, accept tile inputs.
-      // --------------------------------------------------------------
-      if (!G.gameOver) {
-        // Detects clicking on tiles and placing X/O.
-        HandleGameInput(G, A);
-
-      } else {
-        // --------------------------------------------------------------
-        // GAME OVER → check for "Play Again" button click.
-        // --------------------------------------------------------------
-        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && G.mousePos.x >= 50 &&
-            G.mousePos.x <= 250 && G.mousePos.y >= 345 && G.mousePos.y <= 395) {
-          // Reset game board and game state.
-          ResetBoard(G);
-
-          // Play click sound.
-          PlaySound(A.sndPress);
-        }
-      }
-      break;
-
-    // =====================================================================
-    // SCENE: CREDITS
-    // =====================================================================
-    case SCENE_CREDITS:
-
-      // Draw credits UI (background, text, LINK, back button).
-      DrawCredits(G, A);
-
-      // Handle clicks: BACK or raylib.com link.
-      HandleCreditsInput(G, A);
-      break;
-    }
+    ShowScene(A, shownScene, S.state.scene);
 
     // ---------------------------------------------------------------------
-    // End drawing for the frame. All draw calls now appear on screen.
+    // Draw the frame. All draw calls appear on screen at EndDrawing().
     // ---------------------------------------------------------------------
+    BeginDrawing();
+    DrawScene(S, A, frame);
     EndDrawing();
 
     // ---------------------------------------------------------------------
-    // CLICK DEBOUNCING RESET
+    // Release everything this frame allocated in one step.
     // ---------------------------------------------------------------------
-    // If left mouse button is no longer down,
-    // reset G.pressed so new clicks can be registered.
-    if (!IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
-      G.pressed = false;
+    frame.Reset();
+    frames++;
+    if (HeapCounters::ThreadAllocations() != heapBefore)
+      heapFrames++;
+
+    // ---------------------------------------------------------------------
+    // Between frames: swap in one edited texture (--dev only).
+    // ---------------------------------------------------------------------
+    if (reloader.Running())
+      ApplyHotReload(A, reloader);
   }
+  TraceLog(LOG_INFO,
+           "FRAME: %llu frames, %llu touched the heap, arena peak %zu bytes, "
+           "%llu overflows",
+           (unsigned long long)frames, (unsigned long long)heapFrames,
+           frame.Peak(), (unsigned long long)frame.Overflows());
 
   // =========================================================================
   // CLEAN EXIT
   // =========================================================================
-  // When the game loop ends, returning 0 signals successful termination.
+  // Stop the logic thread (the only one posting audio commands), then the
+  // audio thread, which releases the audio device, then free the last
+  // scene's textures and close the window.
+  link.running.store(false, std::memory_order_relaxed);
+  logic.join();
+  if (observer.joinable())
+    observer.join();
+  reloader.Stop();
+  audioLink.running.store(false, std::memory_order_relaxed);
+  audio.join();
+  if (shownScene)
+    ReleaseTextures(A, SceneOf((SceneName)shownScene).textures);
+  if (uint64_t dropped = audioLink.dropped.load())
+    TraceLog(LOG_WARNING, "AUDIO: %llu commands dropped (queue full)",
+             (unsigned long long)dropped);
+  CloseWindow();
+
+  // Returning 0 signals successful termination.
   return 0;
 }
@@ -0,0 +1,205 @@
+// ============================================================================
+// ai.h — CPU opponent: opening book first, search second
+// ============================================================================
+// AiPlayer glues the opening book (book.h) and the alpha-beta searcher
+// (search.h) together behind one call the game loop can make:
+//
+//   int move = ai.ChooseMove(board);
+//
+// A book hit costs one canonical hash and two memory reads; only positions
+// outside the book start a search.
+//
+// PONDERING: after answering, the AI predicts the human's reply and keeps
+// searching the resulting position on a background thread while the human
+// thinks. If the human plays the predicted move ("ponder hit") the running
+// search gets what is left of the normal budget, counted from when pondering
+// started, and its result is used: a human who thought longer than the
+// budget gets the answer at once. Otherwise it is stopped, and the fresh
+// search still benefits from the warmed-up TT. tools/ponder_bench measures
+// the move latency both ways.
+#pragma once
+
+#include "board.h"
+#include "book.h"
+#include "search.h"
+
+#include <thread>
+
+// ============================================================================
+// STRUCT: AiStats
+// ============================================================================
+// Diagnostics for the most recent ChooseMove() call.
+//
+//   fromBook  → true if the move came from the opening book
+//   ponderHit → true if the human played the predicted move and the
+//               background search was reused
+//   result    → search result (only meaningful when fromBook is false)
+//
+struct AiStats {
+  bool fromBook = false;
+  bool ponderHit = false;
+  SearchResult result;
+};
+
+// ============================================================================
+// CLASS: AiPlayer
+// ============================================================================
+// CPU opponent for one board shape. Owns its book mapping, searcher and
+// ponder thread, so it should be created once and kept alive for the whole
+// session. All public methods must be called from one (game logic) thread.
+//
+class AiPlayer {
+public:
+  // ==========================================================================
+  // FUNCTION: AiPlayer (constructor)
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // int size, int winLen → board shape this player is for
+  // SearchLimits limits  → depth/time budget per move when out of book
+  // size_t ttEntries     → transposition table size
+  // bool ponder          → search on the opponent's time
+  // int threads          → Lazy SMP search threads (1 = single-threaded)
+  //
+  // ============= Side Effects =============
+  // Maps resources/book_<size>x<size>_k<winLen>.bin if it exists. A missing
+  // book is not an error; every move is then searched.
+  //
+  AiPlayer(int size, int winLen, SearchLimits limits = SearchLimits(),
+           size_t ttEntries = 1 << 20, bool ponder = true, int threads = 1)
+      : size(size), winLen(winLen), limits(limits), ponder(ponder),
+        searcher(ttEntries, threads) {
+    char path[128];
+    BookPath(path, sizeof(path), size, winLen);
+    book.Open(path, size, winLen);
+  }
+
+  ~AiPlayer() { StopPondering(); }
+  AiPlayer(const AiPlayer &) = delete;
+  AiPlayer &operator=(const AiPlayer &) = delete;
+
+  bool HasBook() const { return book.Loaded(); }
+  const AiStats &LastStats() const { return stats; }
+  Searcher &GetSearcher() { return searcher; }
+
+  // ==========================================================================
+  // FUNCTION: ChooseMove
+  // ==========================================================================
+  // ============= Objective =============
+  // Pick a move for the side to move in `b`.
+  //
+  // ============= Return Value =============
+  // int → cell index, or -1 if the game is already over.
+  //
+  // ============= Approach =============
+  // - Probe the book; on a hit return immediately (no search at all).
+  // - If pondering on exactly this position, give the background search the
+  //   rest of the normal time budget (less the time it has already searched)
+  //   and wait for it.
+  // - Otherwise stop any pondering and run iterative deepening.
+  // - Finally start pondering on the predicted reply to the chosen move.
+  //
+  int ChooseMove(const Board &b) {
+    stats = AiStats();
+    int move;
+    if (book.Probe(b, &move)) {
+      StopPondering();
+      stats.fromBook = true;
+    } else if (pondering && SamePosition(b, ponderBoard)) {
+      searcher.SetDeadline(limits.timeMs -
+                           (SteadyNowNs() - ponderStartNs) * 1e-6);
+      ponderThread.join();
+      pondering = false;
+      stats.ponderHit = true;
+      stats.result = ponderResult;
+      move = ponderResult.move;
+    } else {
+      StopPondering();
+      searcher.ClearStop();
+      stats.result = searcher.Search(b, limits);
+      move = stats.result.move;
+    }
+
+    if (ponder && move >= 0) {
+      Board next = b;
+      next.Make(move);
+      StartPondering(next);
+    }
+    return move;
+  }
+
+  // ==========================================================================
+  // FUNCTION: StopPondering
+  // ==========================================================================
+  // Abort the background search, if any, and wait for its thread. Call when
+  // the game ends or is reset so no CPU time is spent on a dead position.
+  //
+  void StopPondering() {
+    if (!pondering)
+      return;
+    searcher.Stop();
+    ponderThread.join();
+    pondering = false;
+  }
+
+private:
+  static bool SamePosition(const Board &a, const Board &b) {
+    return a.stones[0] == b.stones[0] && a.stones[1] == b.stones[1] &&
+           a.side == b.side;
+  }
+
+  // -------------------------------------------------------------------------
+  // StartPondering: guess the human's reply in `afterOurMove` and search the
+  // resulting position open-ended on a background thread.
+  // -------------------------------------------------------------------------
+  // The guess is the TT best move from the search we just finished (i.e. the
+  // reply our principal variation expects), falling back to the first
+  // generated move. Positions that are over or in the book are not pondered.
+  void StartPondering(const Board &afterOurMove) {
+    if (afterOurMove.Over())
+      return;
+
+    int reply = -1;
+    TTEntry e;
+    if (searcher.Table().Probe(afterOurMove.hash, e) &&
+        e.move < afterOurMove.Cells() &&
+        (afterOurMove.Empty() & (1ull << e.move)))
+      reply = e.move;
+    if (reply < 0) {
+      uint8_t moves[MAX_CELLS];
+      if (GenerateMoves(afterOurMove, moves) == 0)
+        return;
+      reply = moves[0];
+    }
+
+    ponderBoard = afterOurMove;
+    ponderBoard.Make(reply);
+    int unused;
+    if (ponderBoard.Over() || book.Probe(ponderBoard, &unused))
+      return;
+
+    // Open-ended until ChooseMove() sets a real deadline on a ponder hit.
+    searcher.ClearStop();
+    searcher.SetDeadline(1e12);
+    SearchLimits open = limits;
+    open.timeMs = -1;
+
+    pondering = true;
+    ponderStartNs = SteadyNowNs();
+    ponderThread = std::thread([this, open] {
+      ponderResult = searcher.Search(ponderBoard, open);
+    });
+  }
+
+  int size, winLen;
+  SearchLimits limits;
+  bool ponder;
+  Book book;
+  Searcher searcher;
+  AiStats stats;
+
+  bool pondering = false;
+  int64_t ponderStartNs = 0;
+  Board ponderBoard;
+  SearchResult ponderResult;
+  std::thread ponderThread;
+};
@@ -0,0 +1,402 @@
+// ============================================================================
+// archive.h — Append-only game archive and a read-ahead streamer over it
+// ============================================================================
+// Finished games are appended to an archive file (the classic game records
+// every game it finishes, tools/tournament with --archive every game it
+// runs); the replay scene pages through it.
+//
+//   ArchiveWriter   → opens or creates an archive and appends one game per
+//                     call
+//   ArchiveStreamer → a background thread that keeps a small ring of decoded
+//                     games around the game being viewed, so moving to the
+//                     next or previous game never waits for the disk
+//
+// FILE LAYOUT (little-endian, 8-byte aligned):
+//
+//   ArchiveHeader                   → magic, shape, record size
+//   record games[]                  → one fixed-size record per game
+//
+// A record is the ply count, the result and the cells played in order,
+// zero-padded to recordSize (16 bytes on 3×3, 72 on 8×8). Fixed-size
+// records make game i a single pread() at a computed offset: no index to
+// build, and the game count follows from the file size, so appending never
+// rewrites the header. Only the window around the viewed game is ever in
+// memory, whatever the size of the file.
+#pragma once
+
+#include "board.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// ============================================================================
+// ON-DISK STRUCTS
+// ============================================================================
+constexpr uint32_t ARCHIVE_MAGIC = 0x41475454; // "TTGA"
+constexpr uint32_t ARCHIVE_VERSION = 1;
+
+struct ArchiveHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint8_t size;
+  uint8_t winLen;
+  uint16_t recordSize;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(ArchiveHeader) == 16, "archive header layout changed");
+
+// Bytes per game record: plies, result, one byte per cell, 8-byte aligned.
+constexpr int ArchiveRecordSize(int size) {
+  return (2 + size * size + 7) & ~7;
+}
+
+// ----------------------------------------------------------------------------
+// Conventional location of the archive for a board shape.
+// ----------------------------------------------------------------------------
+inline void ArchivePath(char *out, size_t cap, int size, int winLen) {
+  snprintf(out, cap, "resources/games_%dx%d_k%d.bin", size, size, winLen);
+}
+
+// ============================================================================
+// STRUCT: ArchivedGame
+// ============================================================================
+// One decoded game, trivially copyable so it can live in a GameState.
+//
+// MEMBER VARIABLES:
+//   index  → position in the archive
+//   valid  → the record replays legally and ends as recorded
+//   plies  → moves played
+//   result → RESULT_X / RESULT_O / RESULT_DRAW; a win by forfeit is stored
+//            with the game unfinished on the board
+//   moves  → cells in the order they were played
+//
+struct ArchivedGame {
+  uint32_t index = 0;
+  bool valid = false;
+  uint8_t plies = 0;
+  uint8_t result = RESULT_NONE;
+  uint8_t moves[MAX_CELLS] = {0};
+};
+
+// ----------------------------------------------------------------------------
+// DecodeGame: parse and check one record (see the file comment).
+// ----------------------------------------------------------------------------
+inline void DecodeGame(const uint8_t *rec, uint32_t index, int size,
+                       int winLen, ArchivedGame *out) {
+  *out = ArchivedGame();
+  out->index = index;
+  Board b(size, winLen);
+  int plies = rec[0], result = rec[1];
+  if (plies > b.Cells() || result < RESULT_X || result > RESULT_DRAW)
+    return;
+  for (int i = 0; i < plies; i++) {
+    int c = rec[2 + i];
+    if (b.Over() || c >= b.Cells() || !(b.Empty() >> c & 1))
+      return;
+    b.Make(c);
+    out->moves[i] = (uint8_t)c;
+  }
+  if (b.Over() ? b.Result() != result : result == RESULT_DRAW)
+    return;
+  out->plies = (uint8_t)plies;
+  out->result = (uint8_t)result;
+  out->valid = true;
+}
+
+// ============================================================================
+// CLASS: ArchiveWriter
+// ============================================================================
+class ArchiveWriter {
+public:
+  ArchiveWriter() = default;
+  ~ArchiveWriter() { Close(); }
+  ArchiveWriter(const ArchiveWriter &) = delete;
+  ArchiveWriter &operator=(const ArchiveWriter &) = delete;
+
+  // ==========================================================================
+  // FUNCTION: Open
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // const char *path  → archive to append to; created if missing
+  // int size, winLen  → board shape; an existing file must match it
+  //
+  // ============= Return Value =============
+  // bool → false if the file can't be opened or holds another shape.
+  //
+  // ============= Side Effects =============
+  // - Cuts off a partly written last record (a crash mid-append), so later
+  //   records stay aligned.
+  //
+  bool Open(const char *path, int size, int winLen) {
+    Close();
+    ArchiveHeader h = {};
+    f = fopen(path, "r+b");
+    if (f) {
+      struct stat st;
+      if (fread(&h, sizeof(h), 1, f) != 1 || h.magic != ARCHIVE_MAGIC ||
+          h.version != ARCHIVE_VERSION || h.size != size ||
+          h.winLen != winLen || h.recordSize != ArchiveRecordSize(size) ||
+          fstat(fileno(f), &st) != 0) {
+        Close();
+        return false;
+      }
+      off_t whole = (st.st_size - (off_t)sizeof(h)) / h.recordSize;
+      if (ftruncate(fileno(f), (off_t)sizeof(h) + whole * h.recordSize) != 0 ||
+          fseek(f, 0, SEEK_END) != 0) {
+        Close();
+        return false;
+      }
+    } else {
+      f = fopen(path, "w+b");
+      if (!f)
+        return false;
+      h.magic = ARCHIVE_MAGIC;
+      h.version = ARCHIVE_VERSION;
+      h.size = (uint8_t)size;
+      h.winLen = (uint8_t)winLen;
+      h.recordSize = (uint16_t)ArchiveRecordSize(size);
+      if (fwrite(&h, sizeof(h), 1, f) != 1) {
+        Close();
+        return false;
+      }
+    }
+    recordSize = h.recordSize;
+    return true;
+  }
+
+  // Append one game and flush it, so a reader sees it straight away.
+  bool Append(const uint8_t *moves, int plies, int result) {
+    if (!f)
+      return false;
+    uint8_t rec[ArchiveRecordSize(MAX_SIDE)] = {0};
+    rec[0] = (uint8_t)plies;
+    rec[1] = (uint8_t)result;
+    memcpy(rec + 2, moves, plies);
+    return fwrite(rec, recordSize, 1, f) == 1 && fflush(f) == 0;
+  }
+
+  void Close() {
+    if (f)
+      fclose(f);
+    f = nullptr;
+  }
+
+  bool Opened() const { return f != nullptr; }
+
+private:
+  FILE *f = nullptr;
+  int recordSize = 0;
+};
+
+// ============================================================================
+// CLASS: ArchiveStreamer
+// ============================================================================
+// Read-ahead over an archive for a viewer that moves one game at a time.
+//
+// The viewer calls Seek() with the game it wants and Fetch() to copy it
+// out; neither touches the file. The streamer thread keeps the RING games
+// of the window [cursor - BEHIND, cursor - BEHIND + RING) decoded: game i
+// lives in slot i % RING, so moving the cursor by one invalidates exactly
+// one slot, and the thread refills every missing slot of the window with
+// one pread() of the records between them. It also asks the kernel to
+// prefetch the READ_AHEAD records past the window, so even a fast flip
+// through a cold archive finds its records in the page cache.
+//
+// A jump far outside the window (PAGE UP / DOWN) misses once: Fetch()
+// returns false and the viewer keeps showing the previous game until the
+// thread has caught up, typically in well under a frame.
+//
+class ArchiveStreamer {
+public:
+  static constexpr uint32_t RING = 32;        // decoded games kept
+  static constexpr uint32_t BEHIND = 8;       // of which before the cursor
+  static constexpr uint32_t READ_AHEAD = 512; // records prefetched past it
+
+  ArchiveStreamer() = default;
+  ~ArchiveStreamer() { Close(); }
+  ArchiveStreamer(const ArchiveStreamer &) = delete;
+  ArchiveStreamer &operator=(const ArchiveStreamer &) = delete;
+
+  // ==========================================================================
+  // FUNCTION: Open
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // const char *path → archive to stream (any board shape)
+  //
+  // ============= Return Value =============
+  // bool → false if the file is missing or not an archive.
+  //
+  // ============= Side Effects =============
+  // - Starts the streamer thread with the cursor on game 0.
+  //
+  bool Open(const char *path) {
+    Close();
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+    ArchiveHeader h;
+    struct stat st;
+    if (pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) ||
+        h.magic != ARCHIVE_MAGIC || h.version != ARCHIVE_VERSION ||
+        h.size < 3 || h.size > MAX_SIDE || h.winLen > h.size ||
+        h.recordSize != ArchiveRecordSize(h.size) || fstat(fd, &st) != 0) {
+      close(fd);
+      fd = -1;
+      return false;
+    }
+    size = h.size;
+    winLen = h.winLen;
+    recordSize = h.recordSize;
+    count = (uint32_t)((st.st_size - (off_t)sizeof(h)) / recordSize);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    cursor = 0;
+    stop = false;
+    reads = 0;
+    for (Slot &s : slots)
+      s.filled = false;
+    worker = std::thread([this] { Run(); });
+    return true;
+  }
+
+  // Stop the thread and close the file.
+  void Close() {
+    if (worker.joinable()) {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+      }
+      wake.notify_one();
+      worker.join();
+    }
+    if (fd >= 0)
+      close(fd);
+    fd = -1;
+    count = 0;
+  }
+
+  bool Loaded() const { return fd >= 0; }
+  uint32_t Count() const { return count; }
+  int Size() const { return size; }
+  int WinLen() const { return winLen; }
+
+  // Number of pread() calls so far (for benchmarks).
+  uint64_t Reads() {
+    std::lock_guard<std::mutex> guard(lock);
+    return reads;
+  }
+
+  // Viewer thread: make `index` the centre of the window. Never blocks on
+  // I/O; the thread refills the ring behind the call.
+  void Seek(uint32_t index) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      if (index == cursor)
+        return;
+      cursor = index;
+    }
+    wake.notify_one();
+  }
+
+  // Viewer thread: copy game `index` out if it is decoded. Returns false
+  // (and leaves *out alone) if it is not ready yet.
+  bool Fetch(uint32_t index, ArchivedGame *out) {
+    std::lock_guard<std::mutex> guard(lock);
+    const Slot &s = slots[index % RING];
+    if (!s.filled || s.game.index != index)
+      return false;
+    *out = s.game;
+    return true;
+  }
+
+private:
+  struct Slot {
+    bool filled = false;
+    ArchivedGame game;
+  };
+
+  // Window of games kept around `at`: [*first, *last).
+  void Window(uint32_t at, uint32_t *first, uint32_t *last) const {
+    *first = at - (at < BEHIND ? at : BEHIND);
+    *last = *first + RING < count ? *first + RING : count;
+  }
+
+  bool Has(uint32_t i) const {
+    const Slot &s = slots[i % RING];
+    return s.filled && s.game.index == i;
+  }
+
+  // -------------------------------------------------------------------------
+  // Run: body of the streamer thread.
+  // -------------------------------------------------------------------------
+  void Run() {
+    std::vector<uint8_t> buffer(RING * recordSize);
+    ArchivedGame decoded[RING];
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+      // Sleep until the window has a hole (or we are told to stop).
+      uint32_t first, last, lo = 0, hi = 0;
+      for (;;) {
+        if (stop)
+          return;
+        Window(cursor, &first, &last);
+        lo = first;
+        while (lo < last && Has(lo))
+          lo++;
+        hi = last;
+        while (hi > lo && Has(hi - 1))
+          hi--;
+        if (lo < hi)
+          break;
+        wake.wait(guard);
+      }
+      reads++;
+      guard.unlock();
+
+      // One read for every record between the first and last hole.
+      size_t bytes = (size_t)(hi - lo) * recordSize;
+      off_t at = (off_t)sizeof(ArchiveHeader) + (off_t)lo * recordSize;
+      ssize_t got = pread(fd, buffer.data(), bytes, at);
+      for (uint32_t i = lo; i < hi; i++) {
+        size_t offset = (size_t)(i - lo) * recordSize;
+        if (got >= 0 && offset + recordSize <= (size_t)got) {
+          DecodeGame(&buffer[offset], i, size, winLen, &decoded[i - lo]);
+        } else {
+          decoded[i - lo] = ArchivedGame(); // unreadable: shown as invalid
+          decoded[i - lo].index = i;
+        }
+      }
+      posix_fadvise(fd, at + (off_t)bytes, (off_t)READ_AHEAD * recordSize,
+                    POSIX_FADV_WILLNEED);
+
+      // Keep whatever is still in the (possibly moved) window.
+      guard.lock();
+      Window(cursor, &first, &last);
+      for (uint32_t i = lo; i < hi; i++)
+        if (i >= first && i < last) {
+          slots[i % RING].game = decoded[i - lo];
+          slots[i % RING].filled = true;
+        }
+    }
+  }
+
+  int fd = -1;
+  int size = 3, winLen = 3, recordSize = ArchiveRecordSize(3);
+  uint32_t count = 0;
+
+  std::mutex lock; // guards everything below
+  std::condition_variable wake;
+  uint32_t cursor = 0;
+  bool stop = false;
+  uint64_t reads = 0;
+  Slot slots[RING];
+  std::thread worker;
+};
@@ -0,0 +1,165 @@
+// ============================================================================
+// arena.h — Linear (bump-pointer) arenas for per-frame and per-search data
+// ============================================================================
+// Transient data (formatted text, draw lists, per-search bookkeeping) is
+// carved out of one block allocated up front and released in bulk by
+// resetting a single offset, so the frame and search loops never touch the
+// general heap.
+//
+//   LinearArena → one fixed block; Allocate/Alloc/Format bump an offset,
+//                 Reset() frees everything at once
+//   HeapCounters → optional global operator new/delete counters used to
+//                 verify that a loop really is allocation-free
+//
+// Running out of space is not fatal: Allocate() returns nullptr, Format()
+// returns "" and Overflows() counts how often it happened, so an undersized
+// arena shows up in diagnostics instead of crashing a frame.
+#pragma once
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// ============================================================================
+// CLASS: LinearArena
+// ============================================================================
+// Not thread-safe; every arena has exactly one owning thread at a time.
+//
+class LinearArena {
+public:
+  explicit LinearArena(size_t capacity) : base(new unsigned char[capacity]),
+                                          capacity(capacity) {}
+
+  LinearArena(const LinearArena &) = delete;
+  LinearArena &operator=(const LinearArena &) = delete;
+
+  // Raw storage, nullptr when the arena is full.
+  void *Allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+    size_t at = (used + align - 1) & ~(align - 1);
+    if (at + bytes > capacity) {
+      overflows++;
+      return nullptr;
+    }
+    used = at + bytes;
+    if (used > peak)
+      peak = used;
+    return base.get() + at;
+  }
+
+  // `count` value-initialized objects. Only trivially destructible types:
+  // Reset() never runs destructors.
+  template <typename T> T *Alloc(size_t count = 1) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "arena objects are never destroyed");
+    void *p = Allocate(sizeof(T) * count, alignof(T));
+    if (!p)
+      return nullptr;
+    T *items = static_cast<T *>(p);
+    for (size_t i = 0; i < count; i++)
+      new (items + i) T();
+    return items;
+  }
+
+  // printf into the arena. The string lives until the next Reset().
+  const char *Format(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    size_t room = capacity - used;
+    char *out = reinterpret_cast<char *>(base.get() + used);
+    int n = vsnprintf(out, room, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n + 1 > room) {
+      overflows++;
+      return "";
+    }
+    used += (size_t)n + 1;
+    if (used > peak)
+      peak = used;
+    return out;
+  }
+
+  void Reset() { used = 0; }
+
+  size_t Used() const { return used; }
+  size_t Peak() const { return peak; }
+  size_t Capacity() const { return capacity; }
+  uint64_t Overflows() const { return overflows; }
+
+private:
+  std::unique_ptr<unsigned char[]> base;
+  size_t capacity;
+  size_t used = 0;
+  size_t peak = 0;
+  uint64_t overflows = 0;
+};
+
+// ============================================================================
+// STRUCT: HeapCounters
+// ============================================================================
+// Global operator new / delete counts. They only move in a program that
+// defines ARENA_COUNT_HEAP before including this header in exactly one
+// translation unit (which then replaces the global operators); elsewhere
+// they stay zero.
+//
+struct HeapCounters {
+  static inline std::atomic<uint64_t> allocations{0};
+  static inline std::atomic<uint64_t> frees{0};
+  static inline thread_local uint64_t threadAllocations = 0;
+
+  // Process-wide operator new calls.
+  static uint64_t Allocations() {
+    return allocations.load(std::memory_order_relaxed);
+  }
+
+  // operator new calls made by the calling thread only.
+  static uint64_t ThreadAllocations() { return threadAllocations; }
+};
+
+#ifdef ARENA_COUNT_HEAP
+void *operator new(size_t bytes) {
+  HeapCounters::allocations.fetch_add(1, std::memory_order_relaxed);
+  HeapCounters::threadAllocations++;
+  if (void *p = malloc(bytes ? bytes : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(size_t bytes, std::align_val_t align) {
+  HeapCounters::allocations.fetch_add(1, std::memory_order_relaxed);
+  HeapCounters::threadAllocations++;
+  size_t a = (size_t)align;
+  if (void *p = aligned_alloc(a, (bytes + a - 1) / a * a))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t bytes) { return operator new(bytes); }
+void *operator new[](size_t bytes, std::align_val_t align) {
+  return operator new(bytes, align);
+}
+
+void operator delete(void *p) noexcept {
+  if (p)
+    HeapCounters::frees.fetch_add(1, std::memory_order_relaxed);
+  free(p);
+}
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+void operator delete(void *p, std::align_val_t) noexcept { operator delete(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+  operator delete(p);
+}
+void operator delete[](void *p) noexcept { operator delete(p); }
+void operator delete[](void *p, size_t) noexcept { operator delete(p); }
+void operator delete[](void *p, std::align_val_t) noexcept {
+  operator delete(p);
+}
+void operator delete[](void *p, size_t, std::align_val_t) noexcept {
+  operator delete(p);
+}
+#endif
@@ -0,0 +1,371 @@
+// ============================================================================
+// board.h — Bitboard representation of an N×N k-in-a-row board
+// ============================================================================
+// The on-screen game keeps its 3×3 grid in GameState::board[9], which is
+// perfect for drawing but far too slow to search on larger boards. This file
+// provides the compact board used by every engine component:
+//
+//   Geometry → static, per (size, winLen) tables: winning lines, Zobrist keys,
+//              the 8 square symmetries and neighbourhood masks.
+//   Board    → two 64-bit stone masks plus incremental hash, side to move and
+//              result. Moves are applied/undone in O(lines through one cell).
+//
+// Boards are limited to 8×8 so every cell maps onto one bit of a uint64_t.
+// Cell indices are row-major (idx = r * size + c), exactly like the game's
+// board[9], so a cell index can be passed between UI and engine unchanged.
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// ============================================================================
+// CONSTANTS
+// ============================================================================
+constexpr int MAX_SIDE = 8;
+constexpr int MAX_CELLS = MAX_SIDE * MAX_SIDE;
+constexpr int SYMMETRIES = 8;
+
+// Results stored in Board::winner. These match the values GameState::winner
+// uses (PLAYER_X = 1, PLAYER_O = 2, draw = 3) so they can be copied across.
+constexpr int RESULT_NONE = 0;
+constexpr int RESULT_X = 1;
+constexpr int RESULT_O = 2;
+constexpr int RESULT_DRAW = 3;
+
+// ============================================================================
+// FUNCTION: SplitMix64
+// ============================================================================
+// Small, fast 64-bit mixer. Used to derive deterministic Zobrist keys (so
+// hashes are stable across runs and can be stored in book files) and as the
+// hash function of the opening book's perfect hash.
+inline uint64_t SplitMix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+// ============================================================================
+// STRUCT: Geometry
+// ============================================================================
+// Immutable lookup tables for one board shape. Built once on first use by
+// GetGeometry() and shared by every Board of the same shape.
+//
+// MEMBER VARIABLES:
+//   size, winLen, cells → side length, stones needed in a row, size * size
+//   full                → mask with every valid cell set
+//   lines               → every winning line as a bit mask
+//   linesThrough[c]     → indices into `lines` of the lines containing cell c
+//   near[c]             → cells within Chebyshev distance 2 of cell c
+//   sym[s][c]           → image of cell c under symmetry s (0 = identity)
+//   invSym[s][c]        → inverse mapping of sym[s]
+//   zobrist[p][c]       → hash key for a stone of colour p on cell c
+//   zobristSide         → hash key toggled when O is to move
+//
+struct Geometry {
+  int size = 3;
+  int winLen = 3;
+  int cells = 9;
+  uint64_t full = 0;
+
+  std::vector<uint64_t> lines;
+  std::vector<int> linesThrough[MAX_CELLS];
+  uint64_t near[MAX_CELLS] = {0};
+
+  uint8_t sym[SYMMETRIES][MAX_CELLS] = {{0}};
+  uint8_t invSym[SYMMETRIES][MAX_CELLS] = {{0}};
+
+  uint64_t zobrist[2][MAX_CELLS] = {{0}};
+  uint64_t zobristSide = 0;
+};
+
+// ----------------------------------------------------------------------------
+// FUNCTION: BuildGeometry
+// ----------------------------------------------------------------------------
+// Fill every table of a Geometry for the requested shape. Only called by
+// GetGeometry(); kept separate so the caching logic stays readable.
+inline void BuildGeometry(Geometry &g, int size, int winLen) {
+  g.size = size;
+  g.winLen = winLen;
+  g.cells = size * size;
+  g.full = g.cells == 64 ? ~0ull : ((1ull << g.cells) - 1);
+
+  // Winning lines: start at every cell and walk winLen steps in each of the
+  // four directions (→, ↓, ↘, ↙), keeping those that stay on the board.
+  const int DR[4] = {0, 1, 1, 1};
+  const int DC[4] = {1, 0, 1, -1};
+  for (int r = 0; r < size; r++)
+    for (int c = 0; c < size; c++)
+      for (int d = 0; d < 4; d++) {
+        int er = r + DR[d] * (winLen - 1);
+        int ec = c + DC[d] * (winLen - 1);
+        if (er < 0 || er >= size || ec < 0 || ec >= size)
+          continue;
+
+        uint64_t mask = 0;
+        for (int k = 0; k < winLen; k++)
+          mask |= 1ull << ((r + DR[d] * k) * size + (c + DC[d] * k));
+
+        int id = (int)g.lines.size();
+        g.lines.push_back(mask);
+        for (int k = 0; k < winLen; k++)
+          g.linesThrough[(r + DR[d] * k) * size + (c + DC[d] * k)].push_back(id);
+      }
+
+  // Neighbourhood masks used to prune move generation on large boards.
+  for (int r = 0; r < size; r++)
+    for (int c = 0; c < size; c++) {
+      uint64_t m = 0;
+      for (int dr = -2; dr <= 2; dr++)
+        for (int dc = -2; dc <= 2; dc++) {
+          int nr = r + dr, nc = c + dc;
+          if (nr >= 0 && nr < size && nc >= 0 && nc < size)
+            m |= 1ull << (nr * size + nc);
+        }
+      g.near[r * size + c] = m;
+    }
+
+  // The 8 symmetries of the square (dihedral group D4).
+  int n = size - 1;
+  for (int r = 0; r < size; r++)
+    for (int c = 0; c < size; c++) {
+      int img[SYMMETRIES][2] = {{r, c},         {c, n - r},     {n - r, n - c},
+                                {n - c, r},     {r, n - c},     {n - r, c},
+                                {c, r},         {n - c, n - r}};
+      for (int s = 0; s < SYMMETRIES; s++) {
+        int from = r * size + c;
+        int to = img[s][0] * size + img[s][1];
+        g.sym[s][from] = (uint8_t)to;
+        g.invSym[s][to] = (uint8_t)from;
+      }
+    }
+
+  // Deterministic Zobrist keys: identical on every run and every machine.
+  for (int p = 0; p < 2; p++)
+    for (int c = 0; c < MAX_CELLS; c++)
+      g.zobrist[p][c] = SplitMix64(0x7A0B0000ull + p * MAX_CELLS + c);
+  g.zobristSide = SplitMix64(0x7A0BFFFFull);
+}
+
+// ============================================================================
+// FUNCTION: GetGeometry
+// ============================================================================
+// ============= Objective =============
+// Return the shared lookup tables for a size × size board with winLen in a row.
+//
+// ============= Input Parameters =============
+// int size   → side length (1..8)
+// int winLen → stones in a row needed to win (1..size)
+//
+// ============= Return Value =============
+// const Geometry & → lives for the whole program; safe to share across threads.
+//
+// ============= Approach =============
+// Lazily build each shape once into a static table, under a per-shape
+// std::once_flag. After the first call for a shape, a call is one acquire
+// load of the flag's state: Board constructors never contend on a lock.
+//
+inline const Geometry &GetGeometry(int size, int winLen) {
+  static Geometry table[MAX_SIDE + 1][MAX_SIDE + 1];
+  static std::once_flag built[MAX_SIDE + 1][MAX_SIDE + 1];
+
+  std::call_once(built[size][winLen], [&] {
+    BuildGeometry(table[size][winLen], size, winLen);
+  });
+  return table[size][winLen];
+}
+
+// ============================================================================
+// STRUCT: Board
+// ============================================================================
+// Compact, copyable board state. Copying a Board is 48 bytes, but engines
+// should prefer Make()/Unmake() on a single instance.
+//
+// MEMBER VARIABLES:
+//   geo       → shared shape tables
+//   stones[2] → bit masks of X stones ([0]) and O stones ([1])
+//   hash      → Zobrist hash of stones + side to move
+//   side      → 0 when X is to move, 1 when O is to move
+//   ply       → number of stones on the board
+//   winner    → RESULT_NONE / RESULT_X / RESULT_O / RESULT_DRAW
+//
+struct Board {
+  const Geometry *geo = nullptr;
+  uint64_t stones[2] = {0, 0};
+  uint64_t hash = 0;
+  int side = 0;
+  int ply = 0;
+  int winner = RESULT_NONE;
+
+  Board() : geo(&GetGeometry(3, 3)) {}
+  Board(int size, int winLen) : geo(&GetGeometry(size, winLen)) {}
+
+  int Size() const { return geo->size; }
+  int Cells() const { return geo->cells; }
+  int Result() const { return winner; }
+  bool Over() const { return winner != RESULT_NONE; }
+  uint64_t Occupied() const { return stones[0] | stones[1]; }
+  uint64_t Empty() const { return geo->full & ~Occupied(); }
+
+  // Value of a cell in GameState convention: 0 empty, 1 X, 2 O.
+  int At(int cell) const {
+    uint64_t bit = 1ull << cell;
+    return (stones[0] & bit) ? RESULT_X : (stones[1] & bit) ? RESULT_O : 0;
+  }
+
+  // -------------------------------------------------------------------------
+  // Does colour p own a complete line through `cell`?
+  // -------------------------------------------------------------------------
+  bool WinsThrough(int cell, int p) const {
+    for (int id : geo->linesThrough[cell]) {
+      uint64_t m = geo->lines[id];
+      if ((stones[p] & m) == m)
+        return true;
+    }
+    return false;
+  }
+
+  // -------------------------------------------------------------------------
+  // Make: place the side-to-move's stone on an empty cell.
+  // -------------------------------------------------------------------------
+  // Only the lines through the new stone can have been completed, so the
+  // result is updated incrementally instead of rescanning the board.
+  void Make(int cell) {
+    int p = side;
+    stones[p] |= 1ull << cell;
+    hash ^= geo->zobrist[p][cell] ^ geo->zobristSide;
+    side ^= 1;
+    ply++;
+
+    if (WinsThrough(cell, p))
+      winner = p == 0 ? RESULT_X : RESULT_O;
+    else if (ply == geo->cells)
+      winner = RESULT_DRAW;
+  }
+
+  // -------------------------------------------------------------------------
+  // Unmake: exact inverse of Make(cell).
+  // -------------------------------------------------------------------------
+  // `prevWinner` is the result before the Make(). Searches never move after
+  // the game is over, so they can rely on the RESULT_NONE default.
+  void Unmake(int cell, int prevWinner = RESULT_NONE) {
+    side ^= 1;
+    ply--;
+    stones[side] &= ~(1ull << cell);
+    hash ^= geo->zobrist[side][cell] ^ geo->zobristSide;
+    winner = prevWinner;
+  }
+
+  // -------------------------------------------------------------------------
+  // CanonicalHash: symmetry-independent hash of the position.
+  // -------------------------------------------------------------------------
+  // Returns the minimum hash over the 8 symmetric images and stores in
+  // *symOut the symmetry that produced it. A move m on this board is move
+  // geo->sym[*symOut][m] on the canonical board (and invSym maps back).
+  uint64_t CanonicalHash(int *symOut = nullptr) const {
+    uint64_t best = ~0ull;
+    int bestSym = 0;
+    for (int s = 0; s < SYMMETRIES; s++) {
+      uint64_t h = side ? geo->zobristSide : 0;
+      for (int p = 0; p < 2; p++)
+        for (uint64_t b = stones[p]; b; b &= b - 1)
+          h ^= geo->zobrist[p][geo->sym[s][__builtin_ctzll(b)]];
+      if (h < best) {
+        best = h;
+        bestSym = s;
+      }
+    }
+    if (symOut)
+      *symOut = bestSym;
+    return best;
+  }
+};
+
+// ============================================================================
+// FUNCTION: BoardFromCells
+// ============================================================================
+// Build an engine Board from a GameState-style cell array (0 empty, 1 X,
+// 2 O). Stones are replayed X/O alternately so hash, side and result are
+// consistent with Make(). Used where the UI hands a position to the engine.
+//
+inline Board BoardFromCells(const int *cells, int size, int winLen) {
+  Board b(size, winLen);
+  int xs[MAX_CELLS], os[MAX_CELLS], nx = 0, no = 0;
+  for (int i = 0; i < size * size; i++) {
+    if (cells[i] == RESULT_X)
+      xs[nx++] = i;
+    else if (cells[i] == RESULT_O)
+      os[no++] = i;
+  }
+  for (int i = 0, j = 0; i < nx || j < no;) {
+    if (b.side == 0 && i < nx)
+      b.Make(xs[i++]);
+    else if (b.side == 1 && j < no)
+      b.Make(os[j++]);
+    else
+      break; // inconsistent counts: stop rather than corrupt side to move
+  }
+  return b;
+}
+
+// ============================================================================
+// STRUCT: MoveRecord / MoveStack
+// ============================================================================
+// Game history as a compact move stack: undo, redo and jumping to any ply
+// are O(1) per ply and never copy a position.
+//
+//   MoveRecord → the cell played and the result before it (2 bytes), which
+//                is everything Unmake() needs
+//   MoveStack  → records [0, ply) are on the board; [ply, end) were undone
+//                and can be redone until a new move truncates them
+//
+// The helpers below work on any position type with Make(cell),
+// Unmake(cell, prevWinner) and Result(): the engines' Board as well as the
+// game's own 3×3 state.
+//
+struct MoveRecord {
+  uint8_t cell;
+  uint8_t prevWinner;
+};
+
+struct MoveStack {
+  MoveRecord moves[MAX_CELLS];
+  int ply = 0;
+  int end = 0;
+
+  bool CanUndo() const { return ply > 0; }
+  bool CanRedo() const { return ply < end; }
+};
+
+// Play a new move; any redo tail is discarded.
+template <typename Position>
+void PlayMove(Position &pos, MoveStack &s, int cell) {
+  s.moves[s.ply++] = MoveRecord{(uint8_t)cell, (uint8_t)pos.Result()};
+  s.end = s.ply;
+  pos.Make(cell);
+}
+
+template <typename Position> bool UndoMove(Position &pos, MoveStack &s) {
+  if (!s.CanUndo())
+    return false;
+  const MoveRecord &r = s.moves[--s.ply];
+  pos.Unmake(r.cell, r.prevWinner);
+  return true;
+}
+
+template <typename Position> bool RedoMove(Position &pos, MoveStack &s) {
+  if (!s.CanRedo())
+    return false;
+  pos.Make(s.moves[s.ply++].cell);
+  return true;
+}
+
+// Time travel: step to `ply` (clamped to [0, end]).
+template <typename Position>
+void SeekPly(Position &pos, MoveStack &s, int ply) {
+  while (s.ply > ply && UndoMove(pos, s)) {
+  }
+  while (s.ply < ply && RedoMove(pos, s)) {
+  }
+}
@@ -0,0 +1,308 @@
+// ============================================================================
+// book.h — Perfect-hashed, memory-mapped opening book
+// ============================================================================
+// The first moves on larger boards are expensive to search but never change.
+// tools/book_builder.cpp searches every canonical early position once and
+// writes the answers here; the CPU opponent then probes the book in O(1)
+// before starting a search.
+//
+// FILE LAYOUT (little-endian, all sections 8-byte aligned):
+//
+//   BookHeader                      → magic, shape, table sizes
+//   uint16_t seeds[buckets]         → CHD displacement seed per bucket
+//   BookEntry entries[slots]        → one slot per key (+ a little slack)
+//
+// Keys are canonical Zobrist hashes (Board::CanonicalHash), so all 8
+// symmetric images of a position share one entry. Stored moves are in the
+// canonical orientation and mapped back with Geometry::invSym on probe.
+//
+// The perfect hash follows "hash, displace and compress" (CHD): keys are
+// grouped into buckets by key % buckets; each bucket gets the first seed that
+// sends all of its keys to free slots. A probe is therefore exactly one seed
+// read plus one entry read, with no collisions or chains.
+#pragma once
+
+#include "board.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// ============================================================================
+// ON-DISK STRUCTS
+// ============================================================================
+constexpr uint32_t BOOK_MAGIC = 0x4B425454; // "TTBK"
+constexpr uint32_t BOOK_VERSION = 1;
+
+struct BookHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint8_t size;
+  uint8_t winLen;
+  uint8_t reserved[2];
+  uint32_t buckets;
+  uint32_t slots;
+  uint32_t entries;
+  uint32_t reserved2[2];
+};
+
+// check == 0 marks an empty slot; real fingerprints are forced non-zero.
+struct BookEntry {
+  uint32_t check;
+  uint8_t move;
+  uint8_t depth;
+  int16_t score;
+};
+
+static_assert(sizeof(BookHeader) == 32, "book header layout changed");
+static_assert(sizeof(BookEntry) == 8, "book entry layout changed");
+
+// ----------------------------------------------------------------------------
+// Hash helpers shared by the writer and the reader.
+// ----------------------------------------------------------------------------
+inline uint32_t BookCheck(uint64_t key) { return (uint32_t)(key >> 32) | 1u; }
+inline uint32_t BookSlot(uint64_t key, uint32_t seed, uint32_t slots) {
+  return (uint32_t)(SplitMix64(key ^ (seed * 0x9E3779B97F4A7C15ull)) % slots);
+}
+inline size_t BookSeedsBytes(uint32_t buckets) {
+  return (buckets * sizeof(uint16_t) + 7) & ~size_t(7);
+}
+
+// ============================================================================
+// STRUCT: BookRecord
+// ============================================================================
+// One position to be written: canonical key and the answer in canonical
+// orientation. Produced by the builder, consumed by WriteBook().
+//
+struct BookRecord {
+  uint64_t key;
+  uint8_t move;
+  uint8_t depth;
+  int16_t score;
+};
+
+// ============================================================================
+// FUNCTION: WriteBook
+// ============================================================================
+// ============= Objective =============
+// Build the CHD perfect hash for `records` and write the book file.
+//
+// ============= Input Parameters =============
+// const char *path                        → output file
+// int size, int winLen                    → board shape the book is for
+// const std::vector<BookRecord> &records  → unique canonical keys
+//
+// ============= Return Value =============
+// bool → true if the file was written.
+//
+// ============= Approach =============
+// - About 4 keys per bucket, 12% spare slots.
+// - Place the largest buckets first (they are hardest to fit), trying seeds
+//   0..65535 until every key of the bucket lands on a distinct free slot.
+// - If some bucket cannot be placed, grow the slot table and start over.
+//
+inline bool WriteBook(const char *path, int size, int winLen,
+                      const std::vector<BookRecord> &records) {
+  uint32_t n = (uint32_t)records.size();
+  uint32_t buckets = n / 4 + 1;
+  uint32_t slots = n + n / 8 + 1;
+
+  std::vector<uint16_t> seeds;
+  std::vector<BookEntry> table;
+
+  for (;;) {
+    std::vector<std::vector<uint32_t>> members(buckets);
+    for (uint32_t i = 0; i < n; i++)
+      members[records[i].key % buckets].push_back(i);
+
+    std::vector<uint32_t> order(buckets);
+    for (uint32_t i = 0; i < buckets; i++)
+      order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      return members[a].size() > members[b].size();
+    });
+
+    seeds.assign(buckets, 0);
+    table.assign(slots, BookEntry{0, 0, 0, 0});
+    std::vector<uint32_t> placed;
+    bool ok = true;
+
+    for (uint32_t bucket : order) {
+      const std::vector<uint32_t> &keys = members[bucket];
+      if (keys.empty())
+        break; // sorted by size: the rest are empty too
+
+      bool fitted = false;
+      for (uint32_t seed = 0; seed <= 0xFFFF && !fitted; seed++) {
+        placed.clear();
+        fitted = true;
+        for (uint32_t i : keys) {
+          uint32_t s = BookSlot(records[i].key, seed, slots);
+          if (table[s].check != 0 ||
+              std::find(placed.begin(), placed.end(), s) != placed.end()) {
+            fitted = false;
+            break;
+          }
+          placed.push_back(s);
+        }
+        if (fitted) {
+          seeds[bucket] = (uint16_t)seed;
+          for (size_t k = 0; k < keys.size(); k++) {
+            const BookRecord &r = records[keys[k]];
+            table[placed[k]] = {BookCheck(r.key), r.move, r.depth, r.score};
+          }
+        }
+      }
+      if (!fitted) {
+        ok = false;
+        break;
+      }
+    }
+
+    if (ok)
+      break;
+    slots += slots / 4 + 1;
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+
+  BookHeader h = {};
+  h.magic = BOOK_MAGIC;
+  h.version = BOOK_VERSION;
+  h.size = (uint8_t)size;
+  h.winLen = (uint8_t)winLen;
+  h.buckets = buckets;
+  h.slots = slots;
+  h.entries = n;
+
+  const char zeros[8] = {0};
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+  ok = ok && fwrite(seeds.data(), sizeof(uint16_t), buckets, f) == buckets;
+  size_t padding = BookSeedsBytes(buckets) - buckets * sizeof(uint16_t);
+  ok = ok && (padding == 0 || fwrite(zeros, padding, 1, f) == 1);
+  ok = ok && fwrite(table.data(), sizeof(BookEntry), slots, f) == slots;
+  return fclose(f) == 0 && ok;
+}
+
+// ============================================================================
+// CLASS: Book
+// ============================================================================
+// Read-only view of a book file mapped into memory. Opening costs one mmap();
+// pages are faulted in by the OS on first probe and shared between processes.
+//
+class Book {
+public:
+  Book() = default;
+  ~Book() { Close(); }
+  Book(const Book &) = delete;
+  Book &operator=(const Book &) = delete;
+
+  // ==========================================================================
+  // FUNCTION: Open
+  // ==========================================================================
+  // Map `path` and validate it against the expected board shape. Returns
+  // false (leaving the book empty) if the file is missing or does not match;
+  // callers simply fall back to searching.
+  //
+  bool Open(const char *path, int size, int winLen) {
+    Close();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(BookHeader)) {
+      close(fd);
+      return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if (p == MAP_FAILED)
+      return false;
+
+    const BookHeader *h = (const BookHeader *)p;
+    size_t need = sizeof(BookHeader) + BookSeedsBytes(h->buckets) +
+                  (size_t)h->slots * sizeof(BookEntry);
+    if (h->magic != BOOK_MAGIC || h->version != BOOK_VERSION ||
+        h->size != size || h->winLen != winLen || h->buckets == 0 ||
+        h->slots == 0 || (size_t)st.st_size < need) {
+      munmap(p, st.st_size);
+      return false;
+    }
+
+    base = p;
+    length = st.st_size;
+    header = h;
+    seeds = (const uint16_t *)(h + 1);
+    entries = (const BookEntry *)((const char *)seeds +
+                                  BookSeedsBytes(h->buckets));
+    return true;
+  }
+
+  void Close() {
+    if (base)
+      munmap(base, length);
+    base = nullptr;
+    header = nullptr;
+  }
+
+  bool Loaded() const { return header != nullptr; }
+  uint32_t Size() const { return header ? header->entries : 0; }
+
+  // ==========================================================================
+  // FUNCTION: Probe
+  // ==========================================================================
+  // ============= Objective =============
+  // Look up the book move for `b`.
+  //
+  // ============= Input Parameters =============
+  // const Board &b → current position (any orientation)
+  // int *move      → receives the move in b's orientation on a hit
+  //
+  // ============= Return Value =============
+  // bool → true on a book hit.
+  //
+  // ============= Approach =============
+  // Canonicalise, read the bucket seed, read the single candidate slot and
+  // compare the 32-bit fingerprint. The mapped-back move must be empty, which
+  // also rejects the rare fingerprint false positive.
+  //
+  bool Probe(const Board &b, int *move) const {
+    if (!header || b.Over())
+      return false;
+
+    int s;
+    uint64_t key = b.CanonicalHash(&s);
+    uint32_t seed = seeds[key % header->buckets];
+    const BookEntry &e = entries[BookSlot(key, seed, header->slots)];
+    if (e.check != BookCheck(key) || e.move >= b.Cells())
+      return false;
+
+    int m = b.geo->invSym[s][e.move];
+    if (!(b.Empty() & (1ull << m)))
+      return false;
+    *move = m;
+    return true;
+  }
+
+private:
+  void *base = nullptr;
+  size_t length = 0;
+  const BookHeader *header = nullptr;
+  const uint16_t *seeds = nullptr;
+  const BookEntry *entries = nullptr;
+};
+
+// ----------------------------------------------------------------------------
+// Conventional location of the book for a board shape.
+// ----------------------------------------------------------------------------
+inline void BookPath(char *out, size_t cap, int size, int winLen) {
+  snprintf(out, cap, "resources/book_%dx%d_k%d.bin", size, size, winLen);
+}
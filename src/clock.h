@@ -0,0 +1,137 @@
+// ============================================================================
+// clock.h — Chess-style game clocks with increment
+// ============================================================================
+// A GameClock never ticks by itself. It remembers when the side to move
+// started thinking and how much time each side had left at that moment;
+// everything else is computed from monotonic timestamps handed in by the
+// caller. So:
+//
+//   - the remaining time is exact however irregularly it is looked at
+//     (dropped frames, a stalled logic step) — there is no per-frame
+//     subtraction that could drift
+//   - a move is charged up to the timestamp of the input that made it, not
+//     up to whenever that input got processed
+//   - the same clock serves as the authority for engine games: the
+//     tournament runner charges each engine up to the moment its reply
+//     arrived and decides flag fall by itself
+//
+// Times are nanoseconds of MonotonicNs() (steady_clock: unaffected by wall
+// clock changes). The struct is trivially copyable, so it can live in the
+// game's snapshots.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+constexpr int64_t NS_PER_MS = 1000000;
+constexpr int64_t NS_PER_SECOND = 1000 * NS_PER_MS;
+
+// Nanoseconds on the monotonic clock.
+inline int64_t MonotonicNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// ============================================================================
+// CLASS: GameClock
+// ============================================================================
+// Sides are 0 (first player) and 1.
+class GameClock {
+public:
+  // Both sides get `base`; every completed move adds `increment` to the
+  // side that made it. The clock is stopped until Start().
+  void Reset(int64_t base, int64_t increment) {
+    left[0] = left[1] = base;
+    used[0] = used[1] = 0;
+    inc = increment;
+    running = -1;
+    since = started = 0;
+  }
+
+  // Start the clock of `side` at time `at` (the first move of the game).
+  void Start(int side, int64_t at) {
+    running = side;
+    since = started = at;
+  }
+
+  // ==========================================================================
+  // FUNCTION: Press
+  // ==========================================================================
+  // The running side completed a move at time `at`.
+  //
+  // ============= Return Value =============
+  // bool → true: the move was in time; the mover got its increment and the
+  //        other side's clock runs from `at`.
+  //        false: the mover's flag had already fallen; the clock stops with
+  //        it at zero.
+  //
+  bool Press(int64_t at) {
+    if (running < 0)
+      return false;
+    if (!Charge(at))
+      return false;
+    left[running] += inc;
+    running ^= 1;
+    since = at;
+    return true;
+  }
+
+  // Charge the running side up to `at` and stop (the game ended).
+  void Stop(int64_t at) {
+    if (running >= 0)
+      Charge(at);
+    running = -1;
+  }
+
+  // Time `side` has left at `now`, never below zero.
+  int64_t Remaining(int side, int64_t now) const {
+    if (side != running)
+      return left[side];
+    int64_t r = left[side] - (now - since);
+    return r > 0 ? r : 0;
+  }
+
+  // Side whose flag has fallen by `now`, -1 if none.
+  int Flagged(int64_t now) const {
+    if (running >= 0 && now - since >= left[running])
+      return running;
+    for (int s = 0; s < 2; s++)
+      if (left[s] <= 0)
+        return s;
+    return -1;
+  }
+
+  // Side whose clock runs, -1 while stopped.
+  int Running() const { return running; }
+
+  // Thinking time charged to `side` so far (increments not included).
+  int64_t Used(int side) const { return used[side]; }
+
+  // When Start() was called.
+  int64_t Started() const { return started; }
+
+private:
+  // Charge the running side from `since` to `at` (clamped at what it had
+  // left). Returns false, leaving it at zero, if its time ran out first.
+  bool Charge(int64_t at) {
+    int64_t spent = at > since ? at - since : 0;
+    if (spent >= left[running]) {
+      used[running] += left[running];
+      left[running] = 0;
+      running = -1;
+      return false;
+    }
+    used[running] += spent;
+    left[running] -= spent;
+    since = at;
+    return true;
+  }
+
+  int64_t left[2] = {0, 0};
+  int64_t used[2] = {0, 0};
+  int64_t inc = 0;
+  int64_t since = 0;   // when the running side's clock started
+  int64_t started = 0; // when the game's clock started
+  int running = -1;
+};
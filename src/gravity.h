@@ -0,0 +1,446 @@
+// ============================================================================
+// gravity.h — 7×6 gravity ("Connect Four") rules and a perfect-play solver
+// ============================================================================
+// Stones are dropped into a column and fall to its lowest empty cell; four
+// in a row wins. The board is the classic column-padded bitboard: column c
+// owns bits c·7 .. c·7+5 of a uint64_t (bottom to top) and bit c·7+6 stays
+// empty as a separator, so shifts never carry a line from one column into
+// the next:
+//
+//   GravityBoard  → two words (side-to-move stones, occupied mask) plus a
+//                   move count. Legal moves come from the height mask
+//                   (mask + bottom row), a win is four shift-and-AND
+//                   operations, and the pair (stones + mask) is a unique
+//                   position key. 24 bytes, trivially copyable.
+//   GravitySolver → negamax alpha-beta with a transposition table, threat
+//                   based move ordering and pruning of moves that lose at
+//                   once. Searches may be given a node budget, so the game
+//                   can ask for a perfect move without ever blocking.
+//
+// Scores follow the usual convention for this game: 0 is a draw, a positive
+// score means the side to move wins, and the sooner the win the larger the
+// score (one point per stone the winner has left when the game ends).
+// Players use the game's values (RESULT_X = 1 moves first, RESULT_O = 2).
+#pragma once
+
+#include "board.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// STRUCT: GravityBoard
+// ============================================================================
+struct GravityBoard {
+  static constexpr int WIDTH = 7;
+  static constexpr int HEIGHT = 6;
+  static constexpr int CELLS = WIDTH * HEIGHT;
+  static constexpr int COLUMN_BITS = HEIGHT + 1; // incl. the separator bit
+
+  uint64_t current = 0; // stones of the side to move
+  uint64_t mask = 0;    // every stone
+  int moves = 0;
+
+  // --------------------------------------------------------------------------
+  // Masks
+  // --------------------------------------------------------------------------
+  static constexpr uint64_t BottomMask(int col) {
+    return 1ull << (col * COLUMN_BITS);
+  }
+  static constexpr uint64_t TopMask(int col) {
+    return 1ull << (HEIGHT - 1 + col * COLUMN_BITS);
+  }
+  static constexpr uint64_t ColumnMask(int col) {
+    return ((1ull << HEIGHT) - 1) << (col * COLUMN_BITS);
+  }
+  // Bit 0 of every column: 1 + 2^7 + 2^14 + ... as a geometric series.
+  static constexpr uint64_t BOTTOM_ROW =
+      ((1ull << (WIDTH * COLUMN_BITS)) - 1) / ((1ull << COLUMN_BITS) - 1);
+  static constexpr uint64_t BOARD_MASK = BOTTOM_ROW * ((1ull << HEIGHT) - 1);
+
+  // --------------------------------------------------------------------------
+  // Moves
+  // --------------------------------------------------------------------------
+  int SideToMove() const { return moves & 1 ? RESULT_O : RESULT_X; }
+
+  bool CanPlay(int col) const {
+    return col >= 0 && col < WIDTH && !(mask & TopMask(col));
+  }
+
+  // One bit per column: the cell a stone dropped there would land on.
+  uint64_t Possible() const { return (mask + BOTTOM_ROW) & BOARD_MASK; }
+
+  // Drop a stone of the side to move; the column must not be full.
+  void Play(int col) { PlayBit(Possible() & ColumnMask(col)); }
+
+  // Play a landing cell taken from Possible().
+  void PlayBit(uint64_t move) {
+    current ^= mask;
+    mask |= move;
+    moves++;
+  }
+
+  // Row (0 = bottom) the next stone in `col` lands on; HEIGHT when full.
+  int Height(int col) const {
+    return __builtin_popcountll(mask & ColumnMask(col));
+  }
+
+  // 0 = empty, RESULT_X or RESULT_O. Row 0 is the bottom row.
+  int Cell(int col, int row) const {
+    uint64_t bit = 1ull << (col * COLUMN_BITS + row);
+    if (!(mask & bit))
+      return 0;
+    return (Stones(RESULT_X) & bit) ? RESULT_X : RESULT_O;
+  }
+
+  uint64_t Stones(int player) const {
+    return player == SideToMove() ? current : current ^ mask;
+  }
+
+  uint64_t Key() const { return current + mask; }
+
+  // --------------------------------------------------------------------------
+  // Results
+  // --------------------------------------------------------------------------
+  // Four in a row somewhere in `stones`: one shift-and-AND pair per
+  // direction (vertical, horizontal and the two diagonals).
+  static bool Aligned(uint64_t stones) {
+    static const int DIRS[4] = {1, COLUMN_BITS, COLUMN_BITS - 1,
+                                COLUMN_BITS + 1};
+    for (int d : DIRS) {
+      uint64_t m = stones & (stones >> d);
+      if (m & (m >> 2 * d))
+        return true;
+    }
+    return false;
+  }
+
+  // Every stone of `stones` that is part of a four (for highlighting).
+  static uint64_t AlignedStones(uint64_t stones) {
+    static const int DIRS[4] = {1, COLUMN_BITS, COLUMN_BITS - 1,
+                                COLUMN_BITS + 1};
+    uint64_t out = 0;
+    for (int d : DIRS) {
+      uint64_t m = stones & (stones >> d);
+      m &= m >> 2 * d; // m = first stone of each four
+      out |= m | m << d | m << 2 * d | m << 3 * d;
+    }
+    return out;
+  }
+
+  // RESULT_NONE while the game runs; the player who just moved can be the
+  // only winner.
+  int Result() const {
+    if (moves && Aligned(current ^ mask))
+      return moves & 1 ? RESULT_X : RESULT_O;
+    return moves == CELLS ? RESULT_DRAW : RESULT_NONE;
+  }
+
+  // True if dropping into `col` wins on the spot for the side to move.
+  bool IsWinningMove(int col) const {
+    return WinningCells(current, mask) & Possible() & ColumnMask(col);
+  }
+
+  // Empty cells that would complete a four for `stones`.
+  static uint64_t WinningCells(uint64_t stones, uint64_t mask) {
+    // Vertical: only the cell on top of three.
+    uint64_t r = (stones << 1) & (stones << 2) & (stones << 3);
+
+    // Horizontal and the two diagonals: the missing cell may be anywhere in
+    // the four, so test both ends and both inner gaps.
+    for (int d : {COLUMN_BITS, COLUMN_BITS - 1, COLUMN_BITS + 1}) {
+      uint64_t p = (stones << d) & (stones << 2 * d);
+      r |= p & (stones << 3 * d);
+      r |= p & (stones >> d);
+      p = (stones >> d) & (stones >> 2 * d);
+      r |= p & (stones << d);
+      r |= p & (stones >> 3 * d);
+    }
+    return r & (BOARD_MASK ^ mask);
+  }
+};
+
+// ============================================================================
+// CLASS: GravitySolver
+// ============================================================================
+// USAGE:
+//   GravitySolver solver; // 2^20 TT entries, 8 MB
+//   GravityMove m = solver.BestMove(board, 100000);
+//   if (m.solved) { m.score is exact } else { m.col is a heuristic pick }
+//
+// The transposition table is kept between calls: positions met again (the
+// next move of the same game, or a later game) are answered from it.
+//
+struct GravityMove {
+  int col = -1;        // column to play, -1 if the game is over
+  int score = 0;       // exact score of `col` when solved
+  bool solved = false; // false: the node budget ran out
+  uint64_t nodes = 0;  // positions searched for this answer
+};
+
+class GravitySolver {
+public:
+  static constexpr int MIN_SCORE = -GravityBoard::CELLS / 2 + 3;
+  static constexpr int MAX_SCORE = (GravityBoard::CELLS + 1) / 2 - 3;
+
+  explicit GravitySolver(int ttLog2 = 20)
+      : table(size_t(1) << ttLog2, 0), tableMask((size_t(1) << ttLog2) - 1) {}
+
+  // ==========================================================================
+  // FUNCTION: Solve
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // const GravityBoard &b → position with no winner yet
+  // int *score            → receives the exact score
+  // uint64_t budget       → node limit, 0 = none
+  //
+  // ============= Return Value =============
+  // bool → false if the budget ran out (*score untouched).
+  //
+  // ============= Approach =============
+  // Null-window searches narrow [min, max] down to the exact score; probing
+  // close to 0 first settles the win / draw / loss question cheaply.
+  //
+  bool Solve(const GravityBoard &b, int *score, uint64_t budget = 0) {
+    limit = budget ? nodes + budget : ~0ull;
+    aborted = false;
+
+    if (WinningCells(b) & b.Possible()) {
+      *score = (GravityBoard::CELLS + 1 - b.moves) / 2;
+      return true;
+    }
+    int min = -(GravityBoard::CELLS - b.moves) / 2;
+    int max = (GravityBoard::CELLS + 1 - b.moves) / 2;
+    while (min < max) {
+      int med = min + (max - min) / 2;
+      if (med <= 0 && min / 2 < med)
+        med = min / 2;
+      else if (med >= 0 && max / 2 > med)
+        med = max / 2;
+      int r = Negamax(b, med, med + 1);
+      if (aborted)
+        return false;
+      if (r <= med)
+        max = r;
+      else
+        min = r;
+    }
+    *score = min;
+    return true;
+  }
+
+  // ==========================================================================
+  // FUNCTION: BestMove
+  // ==========================================================================
+  // Perfect move within `budget` nodes (0 = unlimited). When the budget runs
+  // out, the move that creates the most threats without handing the
+  // opponent an immediate win is returned instead, with solved = false.
+  //
+  GravityMove BestMove(const GravityBoard &b, uint64_t budget = 0) {
+    GravityMove best;
+    uint64_t start = nodes;
+    if (b.Result() != RESULT_NONE)
+      return best;
+
+    for (int i = 0; i < GravityBoard::WIDTH; i++) {
+      int col = ORDER[i];
+      if (b.CanPlay(col) && b.IsWinningMove(col)) {
+        best.col = col;
+        best.score = (GravityBoard::CELLS + 1 - b.moves) / 2;
+        best.solved = true;
+        return best;
+      }
+    }
+
+    MoveList list;
+    uint64_t next = NonLosingMoves(b);
+    if (!next)
+      next = b.Possible(); // lost whatever we do; delay it the longest
+    Sort(b, next, list);
+    best.col = list.cols[0];
+
+    best.solved = true;
+    int bestScore = -GravityBoard::CELLS;
+    for (int i = 0; i < list.count && best.solved; i++) {
+      GravityBoard child = b;
+      child.PlayBit(list.bits[i]);
+      uint64_t used = nodes - start;
+      if (budget && used >= budget) {
+        best.solved = false;
+        break;
+      }
+      int s;
+      if (!Solve(child, &s, budget ? budget - used : 0)) {
+        best.solved = false;
+        break;
+      }
+      if (-s > bestScore) {
+        bestScore = -s;
+        best.col = list.cols[i];
+      }
+    }
+
+    if (best.solved)
+      best.score = bestScore;
+    else
+      best.col = list.cols[0];
+    best.nodes = nodes - start;
+    return best;
+  }
+
+  // Stones the winner plays from a position with `moves` stones until the
+  // game ends (the winning one included), for a non-zero score of the side
+  // to move there. A negative score counts the opponent's stones.
+  static int StonesToWin(int moves, int score) {
+    if (score > 0)
+      return (GravityBoard::CELLS + 1 - moves) / 2 - score + 1;
+    return (GravityBoard::CELLS - moves) / 2 + score + 1;
+  }
+
+  void Clear() { std::fill(table.begin(), table.end(), 0); }
+  uint64_t Nodes() const { return nodes; }
+
+private:
+  // Centre columns first: they take part in the most lines.
+  static constexpr int ORDER[GravityBoard::WIDTH] = {3, 2, 4, 1, 5, 0, 6};
+
+  struct MoveList {
+    uint64_t bits[GravityBoard::WIDTH];
+    int cols[GravityBoard::WIDTH];
+    int count = 0;
+  };
+
+  static uint64_t WinningCells(const GravityBoard &b) {
+    return GravityBoard::WinningCells(b.current, b.mask);
+  }
+
+  // Legal moves that don't let the opponent win on the next move: if the
+  // opponent threatens one cell we must take it (two → lost, returns 0),
+  // and we never play directly under an opponent's winning cell.
+  static uint64_t NonLosingMoves(const GravityBoard &b) {
+    uint64_t possible = b.Possible();
+    uint64_t theirs = GravityBoard::WinningCells(b.current ^ b.mask, b.mask);
+    uint64_t forced = possible & theirs;
+    if (forced) {
+      if (forced & (forced - 1))
+        return 0;
+      possible = forced;
+    }
+    return possible & ~(theirs >> 1);
+  }
+
+  // Order the moves in `next` by the winning cells they create (most
+  // first), centre columns first among equals. Insertion sort on ≤ 7.
+  static void Sort(const GravityBoard &b, uint64_t next, MoveList &list) {
+    int scores[GravityBoard::WIDTH];
+    for (int i = GravityBoard::WIDTH - 1; i >= 0; i--) {
+      uint64_t move = next & GravityBoard::ColumnMask(ORDER[i]);
+      if (!move)
+        continue;
+      int s = __builtin_popcountll(
+          GravityBoard::WinningCells(b.current | move, b.mask));
+      int j = list.count++;
+      for (; j && scores[j - 1] > s; j--) {
+        scores[j] = scores[j - 1];
+        list.bits[j] = list.bits[j - 1];
+        list.cols[j] = list.cols[j - 1];
+      }
+      scores[j] = s;
+      list.bits[j] = move;
+      list.cols[j] = ORDER[i];
+    }
+    // Ascending with later-inserted (more central) moves ahead of equal
+    // scores; reverse into best-first.
+    for (int i = 0, j = list.count - 1; i < j; i++, j--) {
+      std::swap(list.bits[i], list.bits[j]);
+      std::swap(list.cols[i], list.cols[j]);
+    }
+  }
+
+  // --------------------------------------------------------------------------
+  // Transposition table: one word per slot, key (< 2^49) in the high bits
+  // and the stored bound in the low byte. Values 1..MAX-MIN+1 are upper
+  // bounds, larger values lower bounds, 0 is an empty slot.
+  // --------------------------------------------------------------------------
+  int Probe(uint64_t key) const {
+    uint64_t e = table[SplitMix64(key) & tableMask];
+    return (e >> 8) == key ? int(e & 0xff) : 0;
+  }
+  void Store(uint64_t key, int value) {
+    table[SplitMix64(key) & tableMask] = key << 8 | uint64_t(value);
+  }
+
+  // Score in [alpha, beta] if the true score is inside, else a bound on the
+  // side the true score lies. Only called on positions where the side to
+  // move can't win at once.
+  int Negamax(const GravityBoard &b, int alpha, int beta) {
+    if (++nodes >= limit) {
+      aborted = true;
+      return 0;
+    }
+
+    uint64_t next = NonLosingMoves(b);
+    if (!next)
+      return -(GravityBoard::CELLS - b.moves) / 2;
+    if (b.moves >= GravityBoard::CELLS - 2)
+      return 0;
+
+    int min = -(GravityBoard::CELLS - 2 - b.moves) / 2;
+    if (alpha < min) {
+      alpha = min;
+      if (alpha >= beta)
+        return alpha;
+    }
+    int max = (GravityBoard::CELLS - 1 - b.moves) / 2;
+    if (beta > max) {
+      beta = max;
+      if (alpha >= beta)
+        return beta;
+    }
+
+    uint64_t key = b.Key();
+    if (int v = Probe(key)) {
+      if (v > MAX_SCORE - MIN_SCORE + 1) {
+        min = v + 2 * MIN_SCORE - MAX_SCORE - 2;
+        if (alpha < min) {
+          alpha = min;
+          if (alpha >= beta)
+            return alpha;
+        }
+      } else {
+        max = v + MIN_SCORE - 1;
+        if (beta > max) {
+          beta = max;
+          if (alpha >= beta)
+            return beta;
+        }
+      }
+    }
+
+    MoveList list;
+    Sort(b, next, list);
+    for (int i = 0; i < list.count; i++) {
+      GravityBoard child = b;
+      child.PlayBit(list.bits[i]);
+      int score = -Negamax(child, -beta, -alpha);
+      if (aborted)
+        return 0;
+      if (score >= beta) {
+        Store(key, score + MAX_SCORE - 2 * MIN_SCORE + 2);
+        return score;
+      }
+      if (score > alpha)
+        alpha = score;
+    }
+    Store(key, alpha - MIN_SCORE + 1);
+    return alpha;
+  }
+
+  std::vector<uint64_t> table;
+  size_t tableMask;
+  uint64_t nodes = 0;
+  uint64_t limit = ~0ull;
+  bool aborted = false;
+};
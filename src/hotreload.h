@@ -0,0 +1,224 @@
+// ============================================================================
+// hotreload.h — Watch a directory and re-decode changed files in background
+// ============================================================================
+// Development aid: artists edit resources/*.png while the game runs and see
+// the result without a restart.
+//
+//   HotReloader<T> → an inotify watch on one directory plus a background
+//                    thread that waits for writes to settle, decodes each
+//                    changed file into a T with a caller-supplied function
+//                    and queues the result
+//
+// The owning (render) thread calls Poll() once between frames and installs
+// at most one result per call, so the worst per-frame cost is one upload of
+// an already-decoded file. Everything expensive (file I/O, PNG decode) stays
+// on the background thread.
+//
+// USAGE:
+//   HotReloader<Image> reloader;
+//   reloader.Start("resources", ".png", DecodeFn, ReleaseFn);
+//   ...between frames:
+//   HotReload<Image> r;
+//   if (reloader.Poll(r)) { install r.data under r.name; }
+//
+// Linux only (inotify); Start() returns false elsewhere or on failure.
+#pragma once
+
+#include "lockfree.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// ============================================================================
+// STRUCT: HotReload
+// ============================================================================
+// One decoded file, handed from the watcher thread to the owner.
+//
+//   name → file name inside the watched directory (no directory part)
+//   data → decoded payload; the owner takes ownership
+//
+template <typename T> struct HotReload {
+  char name[64];
+  T data;
+};
+
+// ============================================================================
+// CLASS: HotReloader
+// ============================================================================
+template <typename T> class HotReloader {
+public:
+  using DecodeFn = bool (*)(const char *path, T *out);
+  using ReleaseFn = void (*)(T *data);
+
+  HotReloader() = default;
+  ~HotReloader() { Stop(); }
+  HotReloader(const HotReloader &) = delete;
+  HotReloader &operator=(const HotReloader &) = delete;
+
+  // ==========================================================================
+  // FUNCTION: Start
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // const char *dir     → directory to watch (not recursive)
+  // const char *suffix  → only file names ending in this are reloaded
+  // DecodeFn decode     → runs on the watcher thread; false = skip the file
+  // ReleaseFn release   → frees payloads that are never polled
+  //
+  // ============= Return Value =============
+  // bool → false if inotify is unavailable or the directory can't be watched.
+  //
+  bool Start(const char *dir, const char *suffix, DecodeFn decode,
+             ReleaseFn release) {
+    Stop();
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+      return false;
+    // Editors either rewrite a file in place (close after write) or write a
+    // temporary file and rename it over the original (moved to).
+    if (inotify_add_watch(inotifyFd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+      close(inotifyFd);
+      inotifyFd = -1;
+      return false;
+    }
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stopFd < 0) {
+      close(inotifyFd);
+      inotifyFd = -1;
+      return false;
+    }
+
+    directory = dir;
+    this->suffix = suffix;
+    this->decode = decode;
+    this->release = release;
+    worker = std::thread([this] { Watch(); });
+    return true;
+  }
+
+  // Stop the watcher thread and free anything decoded but never polled.
+  void Stop() {
+    if (!worker.joinable())
+      return;
+    uint64_t one = 1;
+    if (write(stopFd, &one, sizeof(one)) < 0) {
+      // eventfd writes only fail on counter overflow; the poll still wakes.
+    }
+    worker.join();
+    close(inotifyFd);
+    close(stopFd);
+    inotifyFd = stopFd = -1;
+
+    HotReload<T> r;
+    while (ready.Pop(r))
+      release(&r.data);
+  }
+
+  bool Running() const { return worker.joinable(); }
+
+  // Owner thread: take the next decoded file, if any. Call once per frame.
+  bool Poll(HotReload<T> &out) { return ready.Pop(out); }
+
+private:
+  // How long a file must stay quiet before it is decoded, so a half-written
+  // file (or a burst of saves) results in exactly one reload.
+  static constexpr int SETTLE_MS = 100;
+
+  // -------------------------------------------------------------------------
+  // Watch: body of the background thread.
+  // -------------------------------------------------------------------------
+  void Watch() {
+    using Clock = std::chrono::steady_clock;
+    std::vector<std::string> pending;
+    Clock::time_point lastEvent = Clock::now();
+
+    for (;;) {
+      pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+      int timeout = pending.empty() ? -1 : SETTLE_MS;
+      int n = poll(fds, 2, timeout);
+      if (fds[1].revents & POLLIN)
+        return;
+
+      if (n > 0 && (fds[0].revents & POLLIN)) {
+        ReadEvents(pending);
+        lastEvent = Clock::now();
+        continue;
+      }
+
+      // Quiet for SETTLE_MS: decode everything that changed.
+      if (!pending.empty() &&
+          Clock::now() - lastEvent >= std::chrono::milliseconds(SETTLE_MS)) {
+        for (const std::string &name : pending)
+          DecodeAndQueue(name);
+        pending.clear();
+      }
+    }
+  }
+
+  void ReadEvents(std::vector<std::string> &pending) {
+    alignas(inotify_event) char buf[4096];
+    for (;;) {
+      ssize_t len = read(inotifyFd, buf, sizeof(buf));
+      if (len <= 0)
+        return;
+      for (char *p = buf; p < buf + len;) {
+        const inotify_event *ev = reinterpret_cast<const inotify_event *>(p);
+        p += sizeof(inotify_event) + ev->len;
+        if (!ev->len || !Matches(ev->name))
+          continue;
+        bool known = false;
+        for (const std::string &name : pending)
+          known |= name == ev->name;
+        if (!known)
+          pending.push_back(ev->name);
+      }
+    }
+  }
+
+  bool Matches(const char *name) const {
+    size_t n = strlen(name), s = suffix.size();
+    return n < sizeof(HotReload<T>::name) && n >= s &&
+           suffix.compare(0, s, name + n - s) == 0;
+  }
+
+  void DecodeAndQueue(const std::string &name) {
+    HotReload<T> r;
+    snprintf(r.name, sizeof(r.name), "%s", name.c_str());
+    std::string path = directory + "/" + name;
+    if (!decode(path.c_str(), &r.data)) {
+      fprintf(stderr, "hot reload: could not decode %s\n", path.c_str());
+      return;
+    }
+    // The owner drains one result per frame; wait for room rather than
+    // dropping an artist's change.
+    while (!ready.Push(r)) {
+      uint64_t stop;
+      if (read(stopFd, &stop, sizeof(stop)) == sizeof(stop)) {
+        release(&r.data);
+        // Re-arm the stop signal for Watch().
+        uint64_t one = 1;
+        if (write(stopFd, &one, sizeof(one)) < 0) {
+        }
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+
+  int inotifyFd = -1;
+  int stopFd = -1;
+  std::string directory;
+  std::string suffix;
+  DecodeFn decode = nullptr;
+  ReleaseFn release = nullptr;
+  SpscQueue<HotReload<T>, 16> ready;
+  std::thread worker;
+};
@@ -0,0 +1,171 @@
+// ============================================================================
+// infinite.h — Unbounded k-in-a-row board stored as sparse 8×8 chunks
+// ============================================================================
+// board.h covers boards up to 8×8. On an infinite plane the board is kept as
+// a hash map from chunk coordinates to 8×8 chunks, each holding one 64-bit
+// stone mask per player, so:
+//
+//   memory       → one 16-byte chunk (plus map node) per 8×8 area that has
+//                  at least one stone; empty space costs nothing
+//   Place()      → one map lookup, then at most 2·(winLen−1) cell tests
+//                  along each of the 4 lines through the stone, each a bit
+//                  test in a cached chunk (a new lookup only when the walk
+//                  crosses a chunk edge)
+//   ForEachStone → visits only the chunks overlapping the query rectangle,
+//                  so a viewport costs the same anywhere on the plane
+//
+// Coordinates are any int; chunk = coordinate >> 3 (floor division, also
+// for negatives) and the bit inside the chunk is (y & 7) * 8 + (x & 7).
+// Players use the game's values (RESULT_X = 1, RESULT_O = 2).
+#pragma once
+
+#include "board.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+// ============================================================================
+// CLASS: InfiniteBoard
+// ============================================================================
+class InfiniteBoard {
+public:
+  static constexpr int CHUNK_SHIFT = 3;
+  static constexpr int CHUNK_SIDE = 1 << CHUNK_SHIFT;
+
+  explicit InfiniteBoard(int winLen = 5) : winLen(winLen) {}
+
+  // 0 = empty, RESULT_X or RESULT_O.
+  int Get(int x, int y) const {
+    const Chunk *c = Find(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT);
+    return c ? c->At(Bit(x, y)) : 0;
+  }
+
+  // ==========================================================================
+  // FUNCTION: Place
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // int x, y    → an empty cell
+  // int player  → RESULT_X or RESULT_O
+  //
+  // ============= Return Value =============
+  // bool → true if the stone completes winLen (or more) in a row.
+  //
+  bool Place(int x, int y, int player) {
+    Chunk &c = chunks[Key(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT)];
+    c.stones[player - 1] |= Bit(x, y);
+    stones++;
+
+    static const int DIRS[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+    for (const auto &d : DIRS) {
+      int run = 1 + Run(x, y, d[0], d[1], player, winLen - 1);
+      if (run < winLen)
+        run += Run(x, y, -d[0], -d[1], player, winLen - run);
+      if (run >= winLen)
+        return true;
+    }
+    return false;
+  }
+
+  // Take back a stone (undo). Chunks that become empty are freed.
+  void Remove(int x, int y) {
+    auto it = chunks.find(Key(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT));
+    if (it == chunks.end())
+      return;
+    uint64_t bit = Bit(x, y);
+    if (!((it->second.stones[0] | it->second.stones[1]) & bit))
+      return;
+    it->second.stones[0] &= ~bit;
+    it->second.stones[1] &= ~bit;
+    stones--;
+    if (!(it->second.stones[0] | it->second.stones[1]))
+      chunks.erase(it);
+  }
+
+  void Clear() {
+    chunks.clear();
+    stones = 0;
+  }
+
+  // ==========================================================================
+  // FUNCTION: ForEachStone
+  // ==========================================================================
+  // Call f(x, y, player) for every stone with x0 <= x <= x1, y0 <= y <= y1.
+  // Cost is one lookup per chunk overlapping the rectangle plus one step per
+  // stone found, independent of how far the board extends elsewhere.
+  //
+  template <typename F>
+  void ForEachStone(int x0, int y0, int x1, int y1, F &&f) const {
+    for (int cy = y0 >> CHUNK_SHIFT; cy <= y1 >> CHUNK_SHIFT; cy++)
+      for (int cx = x0 >> CHUNK_SHIFT; cx <= x1 >> CHUNK_SHIFT; cx++) {
+        const Chunk *c = Find(cx, cy);
+        if (!c)
+          continue;
+        for (int p = 0; p < 2; p++)
+          for (uint64_t m = c->stones[p]; m; m &= m - 1) {
+            int bit = __builtin_ctzll(m);
+            int x = (cx << CHUNK_SHIFT) + (bit & (CHUNK_SIDE - 1));
+            int y = (cy << CHUNK_SHIFT) + (bit >> CHUNK_SHIFT);
+            if (x >= x0 && x <= x1 && y >= y0 && y <= y1)
+              f(x, y, p + 1);
+          }
+      }
+  }
+
+  int WinLength() const { return winLen; }
+  size_t Stones() const { return stones; }
+  size_t Chunks() const { return chunks.size(); }
+
+private:
+  struct Chunk {
+    uint64_t stones[2] = {0, 0}; // [RESULT_X - 1], [RESULT_O - 1]
+
+    int At(uint64_t bit) const {
+      return (stones[0] & bit) ? RESULT_X : (stones[1] & bit) ? RESULT_O : 0;
+    }
+  };
+
+  // std::hash<uint64_t> is the identity, which clusters neighbouring chunks.
+  struct KeyHash {
+    size_t operator()(uint64_t k) const { return (size_t)SplitMix64(k); }
+  };
+
+  static uint64_t Key(int cx, int cy) {
+    return (uint64_t)(uint32_t)cx << 32 | (uint32_t)cy;
+  }
+
+  static uint64_t Bit(int x, int y) {
+    int bx = x & (CHUNK_SIDE - 1), by = y & (CHUNK_SIDE - 1);
+    return 1ull << (by * CHUNK_SIDE + bx);
+  }
+
+  const Chunk *Find(int cx, int cy) const {
+    auto it = chunks.find(Key(cx, cy));
+    return it == chunks.end() ? nullptr : &it->second;
+  }
+
+  // Stones of `player` directly after (x, y) in direction (dx, dy), up to
+  // `limit`. The current chunk is cached, so a lookup only happens when the
+  // walk crosses into the next chunk.
+  int Run(int x, int y, int dx, int dy, int player, int limit) const {
+    int n = 0;
+    int cx = x >> CHUNK_SHIFT, cy = y >> CHUNK_SHIFT;
+    const Chunk *c = Find(cx, cy);
+    while (n < limit) {
+      x += dx;
+      y += dy;
+      if (x >> CHUNK_SHIFT != cx || y >> CHUNK_SHIFT != cy) {
+        cx = x >> CHUNK_SHIFT;
+        cy = y >> CHUNK_SHIFT;
+        c = Find(cx, cy);
+      }
+      if (!c || !(c->stones[player - 1] & Bit(x, y)))
+        break;
+      n++;
+    }
+    return n;
+  }
+
+  std::unordered_map<uint64_t, Chunk, KeyHash> chunks;
+  int winLen;
+  size_t stones = 0;
+};
@@ -0,0 +1,475 @@
+// ============================================================================
+// jobs.h — Work-stealing job system shared by engines, tools and I/O
+// ============================================================================
+// One pool of worker threads for everything that wants parallelism (book
+// building, batch simulation, asset decoding, archive indexing, ...) instead
+// of ad-hoc std::thread usage.
+//
+//   WorkStealingDeque → Chase-Lev deque: the owner pushes/pops at the bottom,
+//                       any thread steals from the top, no locks
+//   Job               → 128-byte task with inline storage for its callable,
+//                       a parent pointer and an unfinished-children counter
+//   JobSystem         → N workers, each with one deque per priority
+//
+// USAGE:
+//   JobSystem jobs(4);                                  // 4 worker threads
+//
+//   Job *root = jobs.Create([] {});                     // fork / join
+//   jobs.Run(jobs.CreateChild(root, [&] { Left(); }));
+//   jobs.Run(jobs.CreateChild(root, [&] { Right(); }));
+//   jobs.Run(root);
+//   jobs.Wait(root);                                    // helps while waiting
+//
+//   jobs.ParallelFor(0, n, 64, [&](size_t b, size_t e) { ... });
+//
+// PRIORITIES:
+//   Workers always look for JOB_HIGH work (own deque, then the injection
+//   queue, then stealing) before touching any JOB_NORMAL work, so a
+//   frame-critical job submitted while the pool is saturated with background
+//   work starts as soon as any running job returns. Jobs are never
+//   interrupted once started; keep background jobs short.
+//
+// LIMITS:
+//   Jobs come from a per-thread ring of JOB_POOL_SIZE entries that is reused
+//   without bookkeeping, so a thread may have at most JOB_POOL_SIZE jobs in
+//   flight. A full deque is not an error: the job simply runs inline.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum JobPriority { JOB_HIGH = 0, JOB_NORMAL = 1, JOB_PRIORITIES = 2 };
+
+constexpr size_t JOB_POOL_SIZE = 4096;  // jobs per thread ring (power of 2)
+constexpr size_t JOB_DEQUE_SIZE = 4096; // slots per deque (power of 2)
+constexpr size_t JOB_PAYLOAD = 96;      // bytes of inline callable storage
+
+// ============================================================================
+// STRUCT: Job
+// ============================================================================
+// MEMBER VARIABLES:
+//   fn         → thunk that runs and destroys the stored callable
+//   parent     → job to notify when this one (and its children) finish
+//   unfinished → 1 for the job itself + 1 per child not yet finished
+//   priority   → JOB_HIGH / JOB_NORMAL, inherited by children
+//   payload    → the callable, constructed in place
+//
+struct alignas(64) Job {
+  void (*fn)(Job &) = nullptr;
+  Job *parent = nullptr;
+  std::atomic<int32_t> unfinished{0};
+  uint8_t priority = JOB_NORMAL;
+  alignas(16) unsigned char payload[JOB_PAYLOAD];
+
+  bool Finished() const {
+    return unfinished.load(std::memory_order_acquire) <= 0;
+  }
+};
+
+static_assert(sizeof(Job) == 128, "Job should stay two cache lines");
+
+// ============================================================================
+// CLASS: WorkStealingDeque
+// ============================================================================
+// Fixed-capacity Chase-Lev deque (Lê, Pop, Cohen & Zappa Nardelli's C11
+// formulation). Push/Pop only from the owning thread; Steal from any thread.
+//
+class WorkStealingDeque {
+public:
+  WorkStealingDeque() {
+    for (auto &s : slots)
+      s.store(nullptr, std::memory_order_relaxed);
+  }
+
+  // Owner: false when full (the caller then runs the job itself).
+  bool Push(Job *job) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= (int64_t)JOB_DEQUE_SIZE)
+      return false;
+    slots[b & (JOB_DEQUE_SIZE - 1)].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Owner: newest job (LIFO keeps the working set hot), nullptr if empty.
+  Job *Pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    Job *job = nullptr;
+    if (t <= b) {
+      job = slots[b & (JOB_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+      if (t == b) {
+        // Last job: race the thieves for it.
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+          job = nullptr;
+        bottom.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  // Any thread: oldest job (usually the biggest piece of work), nullptr if
+  // empty or another thread won the race.
+  Job *Steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b)
+      return nullptr;
+    Job *job = slots[t & (JOB_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed))
+      return nullptr;
+    return job;
+  }
+
+  bool Empty() const {
+    return top.load(std::memory_order_relaxed) >=
+           bottom.load(std::memory_order_relaxed);
+  }
+
+private:
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  alignas(64) std::atomic<Job *> slots[JOB_DEQUE_SIZE];
+};
+
+// ============================================================================
+// STRUCT: JobStats
+// ============================================================================
+// Counters summed over all threads (approximate while jobs are running).
+//
+//   executed → jobs run to completion
+//   stolen   → jobs taken from another worker's deque
+//   inline_  → jobs run inline because a deque was full
+//   sleeps   → times a worker went to sleep for lack of work
+//
+struct JobStats {
+  uint64_t executed = 0, stolen = 0, inline_ = 0, sleeps = 0;
+};
+
+// ============================================================================
+// CLASS: JobSystem
+// ============================================================================
+class JobSystem {
+public:
+  // ==========================================================================
+  // FUNCTION: JobSystem (constructor)
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // int workers → background worker threads; negative means one per
+  //               hardware thread minus one (the caller helps in Wait()).
+  //               Zero is valid: every job then runs inside Wait().
+  //
+  explicit JobSystem(int workers = -1) {
+    if (workers < 0) {
+      int hw = (int)std::thread::hardware_concurrency();
+      workers = hw > 1 ? hw - 1 : 1;
+    }
+    workerCount = workers;
+    // Slot `workers` is shared by every thread that is not a worker.
+    for (int i = 0; i <= workers; i++)
+      slots.emplace_back(new Worker());
+    for (int i = 0; i < workers; i++)
+      threads.emplace_back([this, i] { WorkerLoop(i); });
+  }
+
+  ~JobSystem() {
+    {
+      std::lock_guard<std::mutex> guard(sleepLock);
+      quitting = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : threads)
+      t.join();
+  }
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  int Workers() const { return workerCount; }
+
+  // 0..Workers()-1 on a worker thread, Workers() on any other thread. Handy
+  // for indexing per-thread scratch state such as searchers.
+  int ThreadIndex() const {
+    return current.system == this ? current.index : Workers();
+  }
+
+  // ==========================================================================
+  // FUNCTION: Create / CreateChild
+  // ==========================================================================
+  // Build a job around a callable taking no arguments. Nothing runs until
+  // Run(job). A child keeps its parent unfinished until the child is done,
+  // which is how fork/join is expressed; children inherit the priority.
+  //
+  template <typename F> Job *Create(F &&f, JobPriority priority = JOB_NORMAL) {
+    Job *job = Allocate();
+    Construct(job, std::forward<F>(f));
+    job->parent = nullptr;
+    job->priority = (uint8_t)priority;
+    job->unfinished.store(1, std::memory_order_relaxed);
+    return job;
+  }
+
+  template <typename F> Job *CreateChild(Job *parent, F &&f) {
+    parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+    Job *job = Create(std::forward<F>(f), (JobPriority)parent->priority);
+    job->parent = parent;
+    return job;
+  }
+
+  // ==========================================================================
+  // FUNCTION: Run
+  // ==========================================================================
+  // Make a job available to the pool. On a worker it goes to that worker's
+  // own deque; other threads use the shared injection queue.
+  //
+  void Run(Job *job) {
+    int p = job->priority;
+    if (current.system == this) {
+      Worker &w = *slots[current.index];
+      if (!w.deque[p].Push(job)) {
+        w.inlined++;
+        Execute(job);
+        return;
+      }
+    } else {
+      std::lock_guard<std::mutex> guard(injectLock);
+      inject[p].push_back(job);
+      injectCount.fetch_add(1, std::memory_order_seq_cst);
+    }
+    WakeOne();
+  }
+
+  // ==========================================================================
+  // FUNCTION: Wait
+  // ==========================================================================
+  // Block until `job` and all of its children have finished, running other
+  // jobs on this thread in the meantime.
+  //
+  void Wait(const Job *job) {
+    while (!job->Finished()) {
+      if (Job *next = FindJob(ThreadIndex()))
+        Execute(next);
+      else
+        std::this_thread::yield();
+    }
+  }
+
+  // ==========================================================================
+  // FUNCTION: ParallelFor
+  // ==========================================================================
+  // ============= Objective =============
+  // Call f(b, e) over disjoint sub-ranges covering [begin, end), in parallel,
+  // and return when all of them are done.
+  //
+  // ============= Approach =============
+  // The range is split in halves recursively: each split hands the upper half
+  // to the pool as a child job and keeps the lower half, so idle workers steal
+  // big chunks first and only ranges of at most `grain` items are executed.
+  //
+  template <typename F>
+  void ParallelFor(size_t begin, size_t end, size_t grain, const F &f,
+                   JobPriority priority = JOB_NORMAL) {
+    if (begin >= end)
+      return;
+    Job *root = Create([] {}, priority);
+    SplitRange(root, begin, end, grain ? grain : 1, &f);
+    Run(root);
+    Wait(root);
+  }
+
+  JobStats Stats() const {
+    JobStats s;
+    for (const auto &w : slots) {
+      s.executed += w->executed.load(std::memory_order_relaxed);
+      s.stolen += w->stolen.load(std::memory_order_relaxed);
+      s.inline_ += w->inlined.load(std::memory_order_relaxed);
+      s.sleeps += w->sleeps.load(std::memory_order_relaxed);
+    }
+    return s;
+  }
+
+private:
+  // Per-worker state, padded so workers never share a counter cache line.
+  struct Worker {
+    WorkStealingDeque deque[JOB_PRIORITIES];
+    std::unique_ptr<Job[]> pool{new Job[JOB_POOL_SIZE]};
+    alignas(64) std::atomic<uint64_t> next{0};
+    std::atomic<uint64_t> executed{0}, stolen{0}, inlined{0}, sleeps{0};
+  };
+
+  // Which pool (if any) the calling thread works for. Zero-initialized like
+  // every thread_local, i.e. "not a worker".
+  struct Current {
+    const JobSystem *system;
+    int index;
+  };
+  static inline thread_local Current current;
+
+  // Ring allocation. Workers own their ring; non-worker threads share the
+  // last one through the atomic counter.
+  Job *Allocate() {
+    Worker &w = *slots[ThreadIndex()];
+    uint64_t i = w.next.fetch_add(1, std::memory_order_relaxed);
+    return &w.pool[i & (JOB_POOL_SIZE - 1)];
+  }
+
+  template <typename F> static void Construct(Job *job, F &&f) {
+    using Fn = std::decay_t<F>;
+    static_assert(sizeof(Fn) <= JOB_PAYLOAD, "job callable too large");
+    static_assert(alignof(Fn) <= 16, "job callable over-aligned");
+    new (job->payload) Fn(std::forward<F>(f));
+    job->fn = [](Job &j) {
+      Fn *fn = std::launder(reinterpret_cast<Fn *>(j.payload));
+      (*fn)();
+      fn->~Fn();
+    };
+  }
+
+  template <typename F>
+  void SplitRange(Job *parent, size_t b, size_t e, size_t grain, const F *f) {
+    while (e - b > grain) {
+      size_t mid = b + (e - b) / 2;
+      Run(CreateChild(parent, [this, parent, mid, e, grain, f] {
+        SplitRange(parent, mid, e, grain, f);
+      }));
+      e = mid;
+    }
+    (*f)(b, e);
+  }
+
+  void Execute(Job *job) {
+    job->fn(*job);
+    slots[ThreadIndex()]->executed.fetch_add(1, std::memory_order_relaxed);
+    Finish(job);
+  }
+
+  void Finish(Job *job) {
+    while (job && job->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      job = job->parent;
+  }
+
+  // -------------------------------------------------------------------------
+  // FindJob: highest priority first; within a priority, own deque, then the
+  // injection queue, then steal from the other workers starting at a
+  // rotating victim so thieves spread out.
+  // -------------------------------------------------------------------------
+  Job *FindJob(int self) {
+    int n = (int)slots.size();
+    for (int p = 0; p < JOB_PRIORITIES; p++) {
+      if (self < Workers())
+        if (Job *job = slots[self]->deque[p].Pop())
+          return job;
+
+      if (injectCount.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> guard(injectLock);
+        if (!inject[p].empty()) {
+          Job *job = inject[p].front();
+          inject[p].pop_front();
+          injectCount.fetch_sub(1, std::memory_order_relaxed);
+          return job;
+        }
+      }
+
+      int start = (int)(victim.fetch_add(1, std::memory_order_relaxed) % n);
+      for (int k = 0; k < n; k++) {
+        int v = (start + k) % n;
+        if (v == self || v == Workers())
+          continue;
+        if (Job *job = slots[v]->deque[p].Steal()) {
+          slots[self]->stolen.fetch_add(1, std::memory_order_relaxed);
+          return job;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  bool HasWork() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (injectCount.load(std::memory_order_seq_cst) > 0)
+      return true;
+    for (int i = 0; i < Workers(); i++)
+      for (int p = 0; p < JOB_PRIORITIES; p++)
+        if (!slots[i]->deque[p].Empty())
+          return true;
+    return false;
+  }
+
+  // Wake one sleeping worker, if any. The sleeper registers itself before
+  // re-checking for work under sleepLock, so a wakeup cannot be lost.
+  void WakeOne() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) == 0)
+      return;
+    {
+      std::lock_guard<std::mutex> guard(sleepLock);
+      wakeups++;
+    }
+    wake.notify_one();
+  }
+
+  void WorkerLoop(int index) {
+    current.system = this;
+    current.index = index;
+    int idle = 0;
+    for (;;) {
+      if (Job *job = FindJob(index)) {
+        Execute(job);
+        idle = 0;
+        continue;
+      }
+      if (++idle < 64) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleepLock);
+      if (quitting)
+        return;
+      sleepers.fetch_add(1, std::memory_order_seq_cst);
+      if (!HasWork()) {
+        slots[index]->sleeps.fetch_add(1, std::memory_order_relaxed);
+        uint64_t seen = wakeups;
+        wake.wait(lock, [&] { return quitting || wakeups != seen; });
+      }
+      sleepers.fetch_sub(1, std::memory_order_seq_cst);
+      idle = 0;
+      if (quitting)
+        return;
+    }
+  }
+
+  int workerCount = 0; // fixed before any worker starts
+  std::vector<std::unique_ptr<Worker>> slots;
+  std::vector<std::thread> threads;
+
+  std::mutex injectLock;
+  std::deque<Job *> inject[JOB_PRIORITIES];
+  std::atomic<int64_t> injectCount{0};
+  std::atomic<uint64_t> victim{0};
+
+  std::mutex sleepLock;
+  std::condition_variable wake;
+  std::atomic<int> sleepers{0};
+  uint64_t wakeups = 0;
+  bool quitting = false;
+};
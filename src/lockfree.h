@@ -0,0 +1,177 @@
+// ============================================================================
+// lockfree.h — Wait-free primitives for passing data between threads
+// ============================================================================
+//   TripleBuffer<T> → one writer publishes whole values, one reader always
+//                     gets the newest complete value; neither ever waits
+//   SpscQueue<T,N>  → bounded single-producer / single-consumer ring buffer
+//   SeqLock<T>      → one writer publishes a value that any number of reader
+//                     threads sample; readers never delay the writer
+//
+// All are used on the frame path (logic ↔ render, logic → observers), so
+// they never take a lock, never allocate after construction and every
+// operation is O(1).
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// ============================================================================
+// CLASS: TripleBuffer
+// ============================================================================
+// Three slots: the writer owns one ("back"), the reader owns one ("front")
+// and the third ("middle") is exchanged atomically. A FRESH bit on the middle
+// index tells the reader whether the writer has published since its last
+// read.
+//
+// USAGE:
+//   writer: buf.Write() = value; buf.Publish();
+//   reader: const T &v = buf.Read();   // newest published value
+//
+template <typename T> class TripleBuffer {
+public:
+  // Slots are default-constructed, or copies of `initial`. T need not be
+  // copyable for the first form (e.g. slots that own an arena).
+  TripleBuffer() = default;
+  explicit TripleBuffer(const T &initial) {
+    for (T &s : slots)
+      s = initial;
+  }
+
+  // Writer side: the slot to fill before Publish(). Never seen by the reader
+  // until published.
+  T &Write() { return slots[back]; }
+
+  // Writer side: hand the back slot to the reader, take the spare one back.
+  void Publish() {
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+  }
+
+  // Reader side: swap in the newest published slot if there is one. The
+  // returned reference stays valid and unchanged until the next Read().
+  const T &Read() {
+    if (middle.load(std::memory_order_relaxed) & FRESH)
+      front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+    return slots[front];
+  }
+
+private:
+  static constexpr uint8_t FRESH = 4;
+  static constexpr uint8_t INDEX = 3;
+
+  T slots[3];
+  uint8_t back = 0;                 // writer-owned
+  uint8_t front = 1;                // reader-owned
+  std::atomic<uint8_t> middle{2};   // shared, with FRESH flag
+};
+
+// ============================================================================
+// CLASS: SpscQueue
+// ============================================================================
+// Fixed-capacity ring buffer for exactly one producer thread and one
+// consumer thread. N must be a power of two. Push() fails (returns false)
+// when full instead of blocking.
+//
+template <typename T, size_t N> class SpscQueue {
+  static_assert((N & (N - 1)) == 0, "SpscQueue capacity must be a power of 2");
+
+public:
+  bool Push(const T &v) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == N)
+      return false;
+    items[t & (N - 1)] = v;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Pop(T &out) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+      return false;
+    out = items[h & (N - 1)];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  T items[N];
+  alignas(64) std::atomic<size_t> head{0}; // consumer-owned
+  alignas(64) std::atomic<size_t> tail{0}; // producer-owned
+};
+
+// ============================================================================
+// CLASS: SeqLock
+// ============================================================================
+// A sequence counter around one copy of T. The writer makes the counter odd,
+// overwrites the copy and makes it even again; a reader copies the value out
+// and keeps it only if the counter was the same even number before and
+// after. Readers never write shared memory, so any number of them cost the
+// writer nothing, and a torn copy is always detected and discarded.
+//
+// The copy is stored as relaxed atomic words so concurrent reads and writes
+// are well defined; T must be trivially copyable.
+//
+// USAGE:
+//   writer (one thread): lock.Store(value);
+//   reader (any thread): T v; if (lock.TryLoad(v)) ...   // one attempt
+//                        T v = lock.Load();              // retries
+//
+template <typename T> class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock values are copied word by word");
+
+public:
+  SeqLock() { Store(T()); }
+
+  // Writer side: wait-free, O(sizeof(T)).
+  void Store(const T &value) {
+    uint64_t words[WORDS] = {};
+    memcpy(words, &value, sizeof(T));
+    uint64_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < WORDS; i++)
+      data[i].store(words[i], std::memory_order_relaxed);
+    seq.store(s + 2, std::memory_order_release);
+  }
+
+  // Reader side: one wait-free attempt. False (and `out` untouched) when it
+  // overlapped a Store(); try again later.
+  bool TryLoad(T &out) const {
+    uint64_t before = seq.load(std::memory_order_acquire);
+    if (before & 1)
+      return false;
+    uint64_t words[WORDS];
+    for (size_t i = 0; i < WORDS; i++)
+      words[i] = data[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq.load(std::memory_order_relaxed) != before)
+      return false;
+    memcpy(&out, words, sizeof(T));
+    return true;
+  }
+
+  // Reader side: retry until a consistent copy is read. A Store() takes
+  // nanoseconds, so this only spins while the writer is mid-copy.
+  T Load() const {
+    T out;
+    while (!TryLoad(out))
+      std::this_thread::yield();
+    return out;
+  }
+
+  // Number of completed Store() calls; cheap change detection for readers.
+  uint64_t Version() const {
+    return seq.load(std::memory_order_acquire) / 2 - 1;
+  }
+
+private:
+  static constexpr size_t WORDS = (sizeof(T) + 7) / 8;
+
+  alignas(64) std::atomic<uint64_t> seq{0};
+  alignas(64) std::atomic<uint64_t> data[WORDS];
+};
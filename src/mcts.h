@@ -0,0 +1,358 @@
+// ============================================================================
+// mcts.h — Monte-Carlo tree search with an arena that survives moves and games
+// ============================================================================
+// UCT search over the same Board as the alpha-beta searcher. The tree lives
+// in a flat arena of fixed-size nodes; children of a node are allocated as
+// one contiguous block, so a node only stores (firstChild, childCount).
+//
+// TREE REUSE:
+//   Advance(move) → re-root to the played child in O(children). Nothing is
+//                   freed yet; the siblings simply become unreachable.
+//   Compaction    → when the arena fills up, the subtree under the current
+//                   root is copied into a second arena and the first one is
+//                   reclaimed in bulk by resetting its bump pointer.
+//   NewGame()     → if no compaction happened since the start position was
+//                   the root, the root jumps back to the start node, so the
+//                   statistics of all previous games are reused.
+#pragma once
+
+#include "board.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+// ============================================================================
+// STRUCT: MctsNode
+// ============================================================================
+// 16 bytes per node.
+//
+//   firstChild → arena index of the first child, -1 while unexpanded
+//   childCount → number of children in the contiguous block
+//   move       → cell played to reach this node from its parent
+//   visits     → playouts through this node
+//   reward     → summed playout results for the player who played `move`
+//                (win 1, draw 0.5, loss 0)
+//
+struct MctsNode {
+  int32_t firstChild = -1;
+  uint16_t childCount = 0;
+  uint8_t move = 0xFF;
+  uint8_t pad = 0;
+  uint32_t visits = 0;
+  float reward = 0.0f;
+};
+
+static_assert(sizeof(MctsNode) == 16, "MctsNode should stay 16 bytes");
+
+// ============================================================================
+// CLASS: Mcts
+// ============================================================================
+// Not thread-safe; one instance per engine thread.
+//
+class Mcts {
+public:
+  // ==========================================================================
+  // FUNCTION: Mcts (constructor)
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // int size, int winLen → board shape
+  // size_t capacity      → nodes per arena (two arenas are allocated)
+  //
+  Mcts(int size, int winLen, size_t capacity = 1 << 20)
+      : start(size, winLen), rootBoard(size, winLen) {
+    for (auto &a : arena)
+      a.resize(capacity);
+    ResetArena();
+  }
+
+  const Board &RootBoard() const { return rootBoard; }
+  uint32_t RootVisits() const { return Nodes()[root].visits; }
+  size_t NodesUsed() const { return used; }
+  size_t Compactions() const { return compactions; }
+
+  // ==========================================================================
+  // FUNCTION: NewGame
+  // ==========================================================================
+  // Return to the start position, keeping the start tree when it is intact.
+  //
+  void NewGame() {
+    rootBoard = start;
+    compactedAtRoot = false;
+    if (startIntact)
+      root = startRoot;
+    else
+      ResetArena();
+  }
+
+  // Drop the whole tree (both arenas are reclaimed in bulk) and go back to
+  // the start position. Only benchmarks and tests should need this.
+  void Reset() {
+    rootBoard = start;
+    ResetArena();
+  }
+
+  // ==========================================================================
+  // FUNCTION: Advance
+  // ==========================================================================
+  // ============= Objective =============
+  // Re-root the tree after `move` was played (by either side).
+  //
+  // ============= Approach =============
+  // Find the matching child and make it the root. If the root was never
+  // expanded (or the child is missing) a fresh node is allocated instead.
+  //
+  void Advance(int move) {
+    MctsNode &r = Nodes()[root];
+    int32_t next = -1;
+    for (int i = 0; i < r.childCount; i++)
+      if (Nodes()[r.firstChild + i].move == move)
+        next = r.firstChild + i;
+
+    rootBoard.Make(move);
+    compactedAtRoot = false;
+    if (next < 0) {
+      if (used == Capacity()) {
+        ResetArena(); // full and nothing to keep: start over in bulk; this
+        return;       // already makes a fresh root for the new position
+      }
+      next = Allocate(1);
+      Nodes()[next] = MctsNode();
+    }
+    root = next;
+  }
+
+  // ==========================================================================
+  // FUNCTION: Run
+  // ==========================================================================
+  // Run playouts from the root until `iterations` have been done, the root
+  // has `targetVisits` visits, or `timeMs` has elapsed (whichever first;
+  // pass 0 to disable a limit).
+  //
+  void Run(uint64_t iterations, uint32_t targetVisits = 0,
+           double timeMs = 0.0) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point end =
+        Clock::now() + std::chrono::microseconds((long long)(timeMs * 1000));
+
+    for (uint64_t i = 0; iterations == 0 || i < iterations; i++) {
+      if (targetVisits && Nodes()[root].visits >= targetVisits)
+        break;
+      if (timeMs > 0 && (i & 63) == 0 && Clock::now() >= end)
+        break;
+      Iterate();
+    }
+  }
+
+  // Most-visited root move (the standard robust choice), -1 if none.
+  int BestMove() const {
+    const MctsNode &r = Nodes()[root];
+    int best = -1;
+    uint32_t bestVisits = 0;
+    for (int i = 0; i < r.childCount; i++) {
+      const MctsNode &c = Nodes()[r.firstChild + i];
+      if (best < 0 || c.visits > bestVisits) {
+        best = c.move;
+        bestVisits = c.visits;
+      }
+    }
+    return best;
+  }
+
+private:
+  MctsNode *Nodes() { return arena[active].data(); }
+  const MctsNode *Nodes() const { return arena[active].data(); }
+  size_t Capacity() const { return arena[active].size(); }
+
+  int32_t Allocate(int count) {
+    int32_t at = (int32_t)used;
+    used += count;
+    return at;
+  }
+
+  // Drop every node at once and start a single-node tree at rootBoard.
+  void ResetArena() {
+    used = 0;
+    compactedAtRoot = false;
+    root = Allocate(1);
+    Nodes()[root] = MctsNode();
+    startIntact = rootBoard.ply == 0;
+    startRoot = root;
+  }
+
+  // -------------------------------------------------------------------------
+  // Compact: copy the subtree under `root` into the spare arena (breadth
+  // first, so child blocks stay contiguous) and reclaim the old arena by
+  // resetting its bump pointer. Unreachable siblings cost nothing to free.
+  // -------------------------------------------------------------------------
+  void Compact() {
+    std::vector<MctsNode> &from = arena[active];
+    std::vector<MctsNode> &to = arena[active ^ 1];
+
+    size_t head = 0, tail = 1;
+    to[0] = from[root];
+    queue.assign(1, root);
+    while (head < tail) {
+      MctsNode &n = to[head];
+      int32_t oldFirst = from[queue[head]].firstChild;
+      if (n.childCount > 0 && tail + n.childCount <= to.size()) {
+        n.firstChild = (int32_t)tail;
+        for (int i = 0; i < n.childCount; i++) {
+          to[tail + i] = from[oldFirst + i];
+          queue.push_back(oldFirst + i);
+        }
+        tail += n.childCount;
+      } else {
+        n.firstChild = -1;
+        n.childCount = 0;
+      }
+      head++;
+    }
+
+    bool keepStart = root == startRoot && startIntact;
+    active ^= 1;
+    used = tail;
+    root = 0;
+    startIntact = keepStart;
+    startRoot = 0;
+    compactedAtRoot = true;
+    compactions++;
+  }
+
+  // -------------------------------------------------------------------------
+  // Iterate: one selection → expansion → playout → backpropagation pass.
+  // -------------------------------------------------------------------------
+  // Tree moves are made on rootBoard itself and unmade on the way out, so
+  // selection never copies a position. The cells are kept separately from
+  // `path` because a compaction invalidates node indices, not cells.
+  void Iterate() {
+    Board &b = rootBoard;
+    int32_t path[MAX_CELLS + 1];
+    uint8_t cells[MAX_CELLS + 1];
+    int depth = 0;
+    int32_t node = root;
+    path[depth++] = node;
+
+    // Selection: descend with UCT while nodes are expanded.
+    while (!b.Over() && Nodes()[node].childCount > 0) {
+      node = SelectChild(node);
+      cells[depth] = Nodes()[node].move;
+      b.Make(cells[depth]);
+      path[depth++] = node;
+    }
+
+    // Expansion: grow the leaf once it has been visited before. If that
+    // compacted the arena, `path` is stale: drop this playout.
+    size_t before = compactions;
+    bool grown = !b.Over() && Nodes()[node].visits > 0 && Expand(node, b);
+    if (compactions != before) {
+      Rewind(cells, depth);
+      return;
+    }
+    if (grown) {
+      int32_t first = Nodes()[node].firstChild;
+      int32_t pick = first + (int32_t)(NextRandom() % Nodes()[node].childCount);
+      node = pick;
+      cells[depth] = Nodes()[node].move;
+      b.Make(cells[depth]);
+      path[depth++] = node;
+    }
+
+    // Playout and backpropagation. `winner` is RESULT_X/O/DRAW.
+    int winner = Playout(b);
+    Rewind(cells, depth);
+    for (int i = depth - 1; i >= 0; i--) {
+      MctsNode &n = Nodes()[path[i]];
+      n.visits++;
+      // The mover into path[i] is the opposite of the side to move there;
+      // the root node's reward is unused.
+      int ply = rootBoard.ply + i;
+      int mover = (ply - 1) & 1; // 0 = X, 1 = O
+      if (winner == RESULT_DRAW)
+        n.reward += 0.5f;
+      else if (winner == (mover == 0 ? RESULT_X : RESULT_O))
+        n.reward += 1.0f;
+    }
+  }
+
+  int32_t SelectChild(int32_t node) {
+    const MctsNode &p = Nodes()[node];
+    float logN = std::log((float)p.visits + 1.0f);
+    int32_t best = p.firstChild;
+    float bestScore = -1.0f;
+    for (int i = 0; i < p.childCount; i++) {
+      const MctsNode &c = Nodes()[p.firstChild + i];
+      if (c.visits == 0)
+        return p.firstChild + i;
+      float score = c.reward / c.visits + 1.4f * std::sqrt(logN / c.visits);
+      if (score > bestScore) {
+        bestScore = score;
+        best = p.firstChild + i;
+      }
+    }
+    return best;
+  }
+
+  // Allocate one contiguous child block. A full arena is compacted once per
+  // root; if the root subtree alone fills it, the tree stops growing.
+  bool Expand(int32_t node, const Board &b) {
+    uint8_t moves[MAX_CELLS];
+    int n = 0;
+    for (uint64_t e = b.Empty(); e; e &= e - 1)
+      moves[n++] = (uint8_t)__builtin_ctzll(e);
+
+    if (used + n > Capacity()) {
+      if (!compactedAtRoot)
+        Compact();
+      return false;
+    }
+    int32_t first = Allocate(n);
+    for (int i = 0; i < n; i++) {
+      Nodes()[first + i] = MctsNode();
+      Nodes()[first + i].move = moves[i];
+    }
+    Nodes()[node].firstChild = first;
+    Nodes()[node].childCount = (uint16_t)n;
+    return true;
+  }
+
+  // Undo the moves cells[1..depth) made by Iterate(), newest first.
+  void Rewind(const uint8_t *cells, int depth) {
+    for (int i = depth - 1; i >= 1; i--)
+      rootBoard.Unmake(cells[i]);
+  }
+
+  // Random playout. Unlike the tree path it takes a scratch copy: all of its
+  // moves are thrown away, and one 48-byte copy is cheaper than unmaking a
+  // whole game's worth of moves.
+  int Playout(Board b) {
+    uint8_t moves[MAX_CELLS];
+    while (!b.Over()) {
+      int n = 0;
+      for (uint64_t e = b.Empty(); e; e &= e - 1)
+        moves[n++] = (uint8_t)__builtin_ctzll(e);
+      b.Make(moves[NextRandom() % n]);
+    }
+    return b.winner;
+  }
+
+  uint64_t NextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+  }
+
+  Board start;
+  Board rootBoard;
+  std::vector<MctsNode> arena[2];
+  std::vector<int32_t> queue;
+  int active = 0;
+  size_t used = 0;
+  int32_t root = 0;
+  int32_t startRoot = 0;
+  bool startIntact = true;
+  bool compactedAtRoot = false;
+  size_t compactions = 0;
+  uint64_t rng = 0x2545F4914F6CDD1Dull;
+};
@@ -0,0 +1,260 @@
+// ============================================================================
+// notakto.h — Notakto (X-only misère tic-tac-toe on several boards) solver
+// ============================================================================
+// Both players place X's on any of N 3×3 boards. A board with three in a row
+// is dead and takes no more stones; whoever kills the last live board loses.
+//
+// Searching the sum of N boards directly is exponential in N. Instead every
+// board is mapped to an element of the game's misère quotient, the 18-element
+// commutative monoid found by Plambeck:
+//
+//   Q = ⟨ a, b, c, d | a² = 1, b³ = b, b²c = c, c³ = ac², b²d = d,
+//                      cd = ad, d² = c² ⟩
+//
+// A position (any number of boards) loses for the player to move exactly when
+// the product of its boards' elements is one of P = { a, b², bc, c² }. So:
+//
+//   NOTAKTO_QUOTIENT → the 18 elements' 18×18 multiplication table and the
+//                      P set, built at compile time from the presentation
+//                      above
+//   NOTAKTO_VALUE    → element of every one of the 512 possible boards, dead
+//                      boards being the identity; generated and checked
+//                      against brute force by tools/notakto_table.cpp
+//   NotaktoPosition  → up to NOTAKTO_MAX_BOARDS boards as 9-bit masks; its
+//                      value is one table lookup and one multiplication per
+//                      board, and BestMove() finds a move to a P-position
+//                      in O(boards · 9) using prefix and suffix products
+//
+#pragma once
+
+#include <cstdint>
+
+// ============================================================================
+// THE QUOTIENT
+// ============================================================================
+// Elements are words a^i b^j c^k d^l in reduced form: i ≤ 1, j ≤ 2, k ≤ 2,
+// l ≤ 1, and never b² together with c or d, nor c together with d. They are
+// numbered by their position in NOTAKTO_WORDS, 0 being the identity.
+//
+constexpr int NOTAKTO_ELEMENTS = 18;
+constexpr int NOTAKTO_IDENTITY = 0;
+
+struct NotaktoWord {
+  int a, b, c, d;
+};
+
+constexpr NotaktoWord NOTAKTO_WORDS[NOTAKTO_ELEMENTS] = {
+    {0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0}, {1, 1, 0, 0}, {0, 2, 0, 0},
+    {1, 2, 0, 0}, {0, 0, 1, 0}, {1, 0, 1, 0}, {0, 1, 1, 0}, {1, 1, 1, 0},
+    {0, 0, 2, 0}, {1, 0, 2, 0}, {0, 1, 2, 0}, {1, 1, 2, 0}, {0, 0, 0, 1},
+    {1, 0, 0, 1}, {0, 1, 0, 1}, {1, 1, 0, 1}};
+
+constexpr const char *NOTAKTO_NAMES[NOTAKTO_ELEMENTS] = {
+    "1",   "a",  "b",   "ab",  "b2",   "ab2", "c",  "ac", "bc",
+    "abc", "c2", "ac2", "bc2", "abc2", "d",   "ad", "bd", "abd"};
+
+// Apply the relations until none matches.
+constexpr NotaktoWord NotaktoReduce(NotaktoWord w) {
+  for (;;) {
+    if (w.a >= 2) // a² = 1
+      w.a -= 2;
+    else if (w.b >= 3) // b³ = b
+      w.b -= 2;
+    else if (w.b >= 2 && (w.c >= 1 || w.d >= 1)) // b²c = c, b²d = d
+      w.b -= 2;
+    else if (w.c >= 3) // c³ = ac²
+      w.c -= 1, w.a += 1;
+    else if (w.c >= 1 && w.d >= 1) // cd = ad
+      w.c -= 1, w.a += 1;
+    else if (w.d >= 2) // d² = c²
+      w.d -= 2, w.c += 2;
+    else
+      return w;
+  }
+}
+
+constexpr int NotaktoIndexOf(NotaktoWord w) {
+  for (int i = 0; i < NOTAKTO_ELEMENTS; i++) {
+    const NotaktoWord &e = NOTAKTO_WORDS[i];
+    if (e.a == w.a && e.b == w.b && e.c == w.c && e.d == w.d)
+      return i;
+  }
+  return -1;
+}
+
+// Multiplication table and P set, computed at compile time.
+struct NotaktoQuotient {
+  uint8_t mul[NOTAKTO_ELEMENTS][NOTAKTO_ELEMENTS];
+  bool losing[NOTAKTO_ELEMENTS]; // P: the player to move loses
+};
+
+constexpr NotaktoQuotient BuildNotaktoQuotient() {
+  NotaktoQuotient q{};
+  for (int x = 0; x < NOTAKTO_ELEMENTS; x++)
+    for (int y = 0; y < NOTAKTO_ELEMENTS; y++) {
+      const NotaktoWord &u = NOTAKTO_WORDS[x], &v = NOTAKTO_WORDS[y];
+      int product = NotaktoIndexOf(NotaktoReduce(
+          NotaktoWord{u.a + v.a, u.b + v.b, u.c + v.c, u.d + v.d}));
+      q.mul[x][y] = (uint8_t)(product < 0 ? 0xff : product);
+    }
+  const NotaktoWord P[4] = {{1, 0, 0, 0}, {0, 2, 0, 0}, {0, 1, 1, 0},
+                            {0, 0, 2, 0}};
+  for (const NotaktoWord &p : P)
+    q.losing[NotaktoIndexOf(p)] = true;
+  return q;
+}
+
+constexpr NotaktoQuotient NOTAKTO_QUOTIENT = BuildNotaktoQuotient();
+
+// Every product of two elements must reduce to one of the 18 words.
+static_assert(
+    [] {
+      for (const auto &row : NOTAKTO_QUOTIENT.mul)
+        for (uint8_t v : row)
+          if (v >= NOTAKTO_ELEMENTS)
+            return false;
+      return true;
+    }(),
+    "Notakto quotient is not closed");
+
+inline int NotaktoMul(int x, int y) { return NOTAKTO_QUOTIENT.mul[x][y]; }
+inline bool NotaktoLosing(int x) { return NOTAKTO_QUOTIENT.losing[x]; }
+
+// ============================================================================
+// TABLE: NOTAKTO_VALUE
+// ============================================================================
+// Quotient element (index into NOTAKTO_WORDS) of the 3×3 board
+// whose occupied cells are the bits of the index (bit = row * 3 + col).
+// Generated by `build/notakto_table --emit`.
+//
+// clang-format off
+static constexpr uint8_t NOTAKTO_VALUE[512] = {
+     6,  0,  0, 14,  0,  2, 14,  0,  0, 14,  1,  2,  2,  1, 15,  0,
+    10,  2,  2,  3,  2,  1,  3,  0,  2,  3,  3,  1,  1,  2,  2,  0,
+     0,  2,  1, 15, 14,  1,  2,  0,  1, 15,  2,  1, 15,  2,  1,  0,
+     2,  1,  3,  2,  3,  2,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  2,  2,  1,  1,  3, 15,  0, 14,  0, 15,  0, 15,  0,  3,  0,
+     2,  1,  1,  2,  0,  0,  0,  0,  3,  0,  2,  0,  0,  0,  0,  0,
+     2,  1,  0,  2, 15,  2,  1,  0, 15,  0,  3,  0,  1,  0,  2,  0,
+     1,  2,  2,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  2,  1, 15,  2,  1, 15,  0,  1, 15,  2,  1,  0,  2,  3,  0,
+     2,  1,  0,  0,  1,  2,  0,  0,  3,  2,  0,  0,  2,  1,  0,  0,
+     1,  0,  2,  3, 15,  2,  1,  0,  2,  3,  1,  2,  3,  1,  2,  0,
+     3,  2,  0,  0,  2,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    14,  1, 15,  2, 15,  2,  1,  0,  2,  0,  1,  0,  1,  0,  2,  0,
+     3,  2,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0,
+    15,  2,  3,  1,  3,  1,  2,  0,  1,  0,  2,  0,  2,  0,  1,  0,
+     2,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  1,  2, 15,  2,  3,  1,  0,  2, 15,  0,  1,  1,  2,  2,  0,
+     2,  0,  1,  0,  1,  0,  2,  0,  1,  0,  2,  0,  2,  0,  1,  0,
+    14, 15, 15,  3,  0,  0,  0,  0, 15,  1,  3,  2,  0,  0,  0,  0,
+     3,  0,  2,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     2,  3,  1,  2,  3,  1,  2,  0,  1,  0,  2,  0,  2,  0,  1,  0,
+     1,  0,  2,  0,  0,  0,  0,  0,  2,  0,  1,  0,  0,  0,  0,  0,
+     1,  2,  2,  1,  0,  0,  0,  0,  2,  0,  1,  0,  0,  0,  0,  0,
+     2,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    14, 15, 15,  1,  1,  2,  2,  0, 15,  3,  3,  2,  2,  1,  1,  0,
+     3,  0,  0,  0,  2,  0,  0,  0,  2,  0,  0,  0,  1,  0,  0,  0,
+     2,  1,  1,  2,  0,  0,  0,  0,  1,  2,  2,  1,  0,  0,  0,  0,
+     1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+// clang-format on
+
+// ============================================================================
+// STRUCT: NotaktoPosition
+// ============================================================================
+constexpr int NOTAKTO_MAX_BOARDS = 32;
+
+struct NotaktoPosition {
+  uint16_t boards[NOTAKTO_MAX_BOARDS] = {}; // occupied cells per board
+  int count = 0;
+
+  static bool Dead(uint16_t board) {
+    static const uint16_t LINES[8] = {0007, 0070, 0700, 0111,
+                                      0222, 0444, 0421, 0124};
+    for (uint16_t l : LINES)
+      if ((board & l) == l)
+        return true;
+    return false;
+  }
+
+  bool Live(int b) const { return !Dead(boards[b]); }
+
+  bool CanPlay(int b, int cell) const {
+    return b >= 0 && b < count && cell >= 0 && cell < 9 && Live(b) &&
+           !(boards[b] >> cell & 1);
+  }
+
+  void Play(int b, int cell) { boards[b] |= uint16_t(1 << cell); }
+
+  // No live board left: the player who just moved killed the last one.
+  bool Over() const {
+    for (int b = 0; b < count; b++)
+      if (Live(b))
+        return false;
+    return true;
+  }
+
+  // Product of every board's element.
+  int Value() const {
+    int v = NOTAKTO_IDENTITY;
+    for (int b = 0; b < count; b++)
+      v = NotaktoMul(v, NOTAKTO_VALUE[boards[b]]);
+    return v;
+  }
+
+  // True if the player to move loses against perfect play.
+  bool Losing() const { return NotaktoLosing(Value()); }
+
+  // ==========================================================================
+  // FUNCTION: BestMove
+  // ==========================================================================
+  // ============= Output =============
+  // *board, *cell → a move to a P-position if there is one (returns true);
+  //                 otherwise a move that keeps a board alive if possible,
+  //                 so a losing side prolongs the game (returns false).
+  //
+  // ============= Approach =============
+  // prefix[b] · suffix[b+1] is the product of every board except b, so each
+  // candidate move costs one table lookup and one multiplication.
+  //
+  bool BestMove(int *board, int *cell) const {
+    uint8_t prefix[NOTAKTO_MAX_BOARDS + 1], suffix[NOTAKTO_MAX_BOARDS + 1];
+    prefix[0] = suffix[count] = NOTAKTO_IDENTITY;
+    for (int b = 0; b < count; b++)
+      prefix[b + 1] =
+          (uint8_t)NotaktoMul(prefix[b], NOTAKTO_VALUE[boards[b]]);
+    for (int b = count - 1; b >= 0; b--)
+      suffix[b] =
+          (uint8_t)NotaktoMul(NOTAKTO_VALUE[boards[b]], suffix[b + 1]);
+
+    *board = *cell = -1;
+    bool safe = false; // fallback keeps its board alive
+    for (int b = 0; b < count; b++) {
+      if (!Live(b))
+        continue;
+      int others = NotaktoMul(prefix[b], suffix[b + 1]);
+      for (int c = 0; c < 9; c++) {
+        if (boards[b] >> c & 1)
+          continue;
+        uint16_t next = uint16_t(boards[b] | 1 << c);
+        int v = NotaktoMul(others, NOTAKTO_VALUE[next]);
+        if (NotaktoLosing(v)) {
+          *board = b;
+          *cell = c;
+          return true;
+        }
+        if (*board < 0 || (!safe && !Dead(next))) {
+          *board = b;
+          *cell = c;
+          safe = !Dead(next);
+        }
+      }
+    }
+    return false;
+  }
+};
@@ -0,0 +1,423 @@
+// ============================================================================
+// protocol.h — Line-based engine protocol ("TTTP") over stdin/stdout
+// ============================================================================
+// Lets the game and the tournament runner drive engines that live in other
+// processes, in the spirit of UCI. Every message is one '\n'-terminated line.
+//
+// GUI → ENGINE
+//   ttt                              handshake; engine answers id lines + tttok
+//   isready                          engine answers readyok
+//   newgame <size> <winLen>          start a new game on that board shape
+//   position startpos [moves <c>...] position as move list from empty board
+//   position cells <str> [moves <c>...]
+//                                    <str> is size*size chars of . x o
+//                                    (row-major); side to move is derived
+//   go movetime <ms>                 search exactly this long
+//   go xtime <ms> otime <ms> [xinc <ms>] [oinc <ms>]
+//                                    clock-based; engine budgets its time
+//   stop                             answer with bestmove as soon as possible
+//   quit                             exit
+//
+// ENGINE → GUI
+//   id name <text> / id author <text>
+//   tttok / readyok
+//   info depth <d> score <s> nodes <n>
+//   bestmove <cell>                  cell index, row-major (r * size + c)
+//
+// Commands may be pipelined: a GUI can write "position ...\ngo ...\n" in one
+// go without waiting for any acknowledgement, so one move costs one write and
+// one read system call on each side.
+//
+// This file contains the shared parsing helpers and the GUI side:
+//   EngineProcess → child process with non-blocking pipes
+//   EngineClient  → protocol state on top of an EngineProcess
+// Many clients can be multiplexed with a single poll() (see Fd/WantsWrite).
+// A program that starts engines must ignore SIGPIPE itself (dispositions are
+// process-wide), or a dead engine kills it on the next write.
+#pragma once
+
+#include "board.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// ============================================================================
+// FUNCTION: SplitTokens
+// ============================================================================
+// Split a protocol line on spaces/tabs. Empty tokens are dropped.
+//
+inline std::vector<std::string> SplitTokens(const std::string &line) {
+  std::vector<std::string> out;
+  size_t i = 0;
+  while (i < line.size()) {
+    while (i < line.size() && (line[i] == ' ' || line[i] == '\t'))
+      i++;
+    size_t j = i;
+    while (j < line.size() && line[j] != ' ' && line[j] != '\t')
+      j++;
+    if (j > i)
+      out.push_back(line.substr(i, j - i));
+    i = j;
+  }
+  return out;
+}
+
+// ============================================================================
+// FUNCTION: ParseCell
+// ============================================================================
+// Parse a cell index token. Returns false unless the whole token is a
+// decimal number, so garbage never reads as cell 0.
+//
+inline bool ParseCell(const std::string &token, int *cell) {
+  if (token.empty())
+    return false;
+  char *end = nullptr;
+  errno = 0;
+  long v = strtol(token.c_str(), &end, 10);
+  if (errno || *end || v < 0 || v >= MAX_CELLS)
+    return false;
+  *cell = (int)v;
+  return true;
+}
+
+// ============================================================================
+// FUNCTION: FormatPosition
+// ============================================================================
+// Build a "position cells ..." line for `b`. The cell string fully describes
+// the position, so the GUI never needs to keep a move list in sync.
+//
+inline std::string FormatPosition(const Board &b) {
+  std::string line = "position cells ";
+  for (int i = 0; i < b.Cells(); i++)
+    line += ".xo"[b.At(i)];
+  line += '\n';
+  return line;
+}
+
+// ============================================================================
+// FUNCTION: ParsePosition
+// ============================================================================
+// ============= Objective =============
+// Parse the tokens of a "position" command into `out`.
+//
+// ============= Input Parameters =============
+// const std::vector<std::string> &t → tokens, t[0] == "position"
+// int size, int winLen              → shape from the last newgame
+// Board &out                        → receives the position
+//
+// ============= Return Value =============
+// bool → false on malformed input or illegal moves (out is unspecified): a
+//        cells string with characters other than . x o, or with stone counts
+//        no game can reach (X moves first), is rejected.
+//
+inline bool ParsePosition(const std::vector<std::string> &t, int size,
+                          int winLen, Board &out) {
+  if (t.size() < 2)
+    return false;
+
+  size_t i = 2;
+  if (t[1] == "startpos") {
+    out = Board(size, winLen);
+  } else if (t[1] == "cells" && t.size() >= 3 &&
+             (int)t[2].size() == size * size) {
+    int cells[MAX_CELLS], nx = 0, no = 0;
+    for (int c = 0; c < size * size; c++) {
+      char ch = t[2][c];
+      if (ch != '.' && ch != 'x' && ch != 'o')
+        return false;
+      cells[c] = ch == 'x' ? RESULT_X : ch == 'o' ? RESULT_O : RESULT_NONE;
+      nx += ch == 'x';
+      no += ch == 'o';
+    }
+    if (nx != no && nx != no + 1)
+      return false;
+    out = BoardFromCells(cells, size, winLen);
+    i = 3;
+  } else {
+    return false;
+  }
+
+  if (i < t.size() && t[i] != "moves")
+    return false;
+  if (i < t.size())
+    for (i++; i < t.size(); i++) {
+      int m;
+      if (!ParseCell(t[i], &m) || m >= out.Cells() ||
+          !(out.Empty() & (1ull << m)) || out.Over())
+        return false;
+      out.Make(m);
+    }
+  return true;
+}
+
+// ============================================================================
+// FUNCTION: ReapEngines
+// ============================================================================
+// Collect exited engine processes without waiting. EngineProcess::Close()
+// kills its child and leaves it here; every later Close() and the runner's
+// loop (tools/tournament) call this, so no caller ever blocks on waitpid().
+//
+// ============= Input Parameters =============
+// pid_t pid → a killed child to add to the list, 0 to only reap
+//
+inline void ReapEngines(pid_t pid = 0) {
+  static std::mutex lock;
+  static std::vector<pid_t> dying;
+  std::lock_guard<std::mutex> guard(lock);
+  if (pid > 0)
+    dying.push_back(pid);
+  for (size_t i = 0; i < dying.size();) {
+    if (waitpid(dying[i], nullptr, WNOHANG) != 0) {
+      dying[i] = dying.back();
+      dying.pop_back();
+    } else {
+      i++;
+    }
+  }
+}
+
+// ============================================================================
+// CLASS: EngineProcess
+// ============================================================================
+// A child process whose stdin/stdout are non-blocking pipes. Nothing here
+// ever blocks: Send() only queues, Pump() moves whatever the pipes accept,
+// and ReadLine() only returns complete lines already received.
+//
+class EngineProcess {
+public:
+  EngineProcess() = default;
+  ~EngineProcess() { Close(); }
+  EngineProcess(const EngineProcess &) = delete;
+  EngineProcess &operator=(const EngineProcess &) = delete;
+
+  // ==========================================================================
+  // FUNCTION: Start
+  // ==========================================================================
+  // Launch `command` through /bin/sh. Returns false if the pipes or the fork
+  // fail; an exec failure shows up later as end-of-file.
+  //
+  bool Start(const char *command) {
+    Close();
+    int toChild[2], fromChild[2];
+    if (pipe(toChild) != 0)
+      return false;
+    if (pipe(fromChild) != 0) {
+      close(toChild[0]);
+      close(toChild[1]);
+      return false;
+    }
+
+    pid = fork();
+    if (pid < 0) {
+      for (int fd : {toChild[0], toChild[1], fromChild[0], fromChild[1]})
+        close(fd);
+      return false;
+    }
+    if (pid == 0) {
+      signal(SIGPIPE, SIG_DFL); // not inherited from an ignoring parent
+      dup2(toChild[0], STDIN_FILENO);
+      dup2(fromChild[1], STDOUT_FILENO);
+      for (int fd : {toChild[0], toChild[1], fromChild[0], fromChild[1]})
+        close(fd);
+      execl("/bin/sh", "sh", "-c", command, (char *)nullptr);
+      _exit(127);
+    }
+
+    close(toChild[0]);
+    close(fromChild[1]);
+    in = fromChild[0];
+    out = toChild[1];
+    fcntl(in, F_SETFL, fcntl(in, F_GETFL) | O_NONBLOCK);
+    fcntl(out, F_SETFL, fcntl(out, F_GETFL) | O_NONBLOCK);
+    fcntl(in, F_SETFD, FD_CLOEXEC);
+    fcntl(out, F_SETFD, FD_CLOEXEC);
+    eof = false;
+    return true;
+  }
+
+  // ==========================================================================
+  // FUNCTION: Close
+  // ==========================================================================
+  // Kill the engine at once and hand it to ReapEngines(); never waits, so
+  // replacing a forfeited engine doesn't stall the other games of a
+  // poll() loop.
+  //
+  void Close() {
+    if (pid <= 0)
+      return;
+    close(in);
+    close(out);
+    in = out = -1;
+    kill(pid, SIGKILL);
+    ReapEngines(pid);
+    pid = -1;
+    pending.clear();
+    received.clear();
+  }
+
+  bool Running() const { return pid > 0 && !eof; }
+  int Fd() const { return in; }
+  bool WantsWrite() const { return !pending.empty(); }
+  int WriteFd() const { return out; }
+
+  void Send(const std::string &text) { pending += text; }
+
+  // ==========================================================================
+  // FUNCTION: Pump
+  // ==========================================================================
+  // Write as much queued output and read as much input as possible without
+  // blocking. Returns false once the engine has gone away.
+  //
+  bool Pump() {
+    if (pid <= 0)
+      return false;
+
+    while (!pending.empty()) {
+      ssize_t n = write(out, pending.data(), pending.size());
+      if (n > 0) {
+        pending.erase(0, n);
+        continue;
+      }
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0 && errno != EAGAIN)
+        eof = true;
+      break;
+    }
+
+    char buf[4096];
+    for (;;) {
+      ssize_t n = read(in, buf, sizeof(buf));
+      if (n > 0) {
+        received.append(buf, n);
+        continue;
+      }
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n == 0 || errno != EAGAIN)
+        eof = true;
+      break;
+    }
+    return !eof;
+  }
+
+  // Pop one complete line (without '\n') from the receive buffer.
+  bool ReadLine(std::string &line) {
+    size_t nl = received.find('\n');
+    if (nl == std::string::npos)
+      return false;
+    line.assign(received, 0, nl);
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    received.erase(0, nl + 1);
+    return true;
+  }
+
+private:
+  pid_t pid = -1;
+  int in = -1, out = -1;
+  bool eof = false;
+  std::string pending;
+  std::string received;
+};
+
+// ============================================================================
+// CLASS: EngineClient
+// ============================================================================
+// GUI-side protocol state for one external engine. Typical per-frame use:
+//
+//   if (!client.Busy()) client.Go(board, 500);   // ask once
+//   int move; if (client.Poll(&move)) play(move); // check every frame
+//
+class EngineClient {
+public:
+  // Launch the engine and queue the handshake and first newgame. Does not
+  // wait for any reply; replies are consumed by later Poll() calls.
+  bool Start(const char *command, int size, int winLen) {
+    if (!proc.Start(command))
+      return false;
+    name = command;
+    proc.Send("ttt\n");
+    NewGame(size, winLen);
+    return true;
+  }
+
+  void Close() { proc.Close(); }
+  bool Running() const { return proc.Running(); }
+  bool Busy() const { return busy; }
+  const std::string &Name() const { return name; }
+  EngineProcess &Process() { return proc; }
+
+  void NewGame(int size, int winLen) {
+    char line[64];
+    snprintf(line, sizeof(line), "newgame %d %d\n", size, winLen);
+    proc.Send(line);
+  }
+
+  // ==========================================================================
+  // FUNCTION: Go
+  // ==========================================================================
+  // Queue position + go in one pipelined write. `xtimeMs` etc. are used when
+  // movetimeMs is negative (clock-based search).
+  //
+  void Go(const Board &b, double movetimeMs, double xtimeMs = 0,
+          double otimeMs = 0, double xincMs = 0, double oincMs = 0) {
+    char go[128];
+    if (movetimeMs >= 0)
+      snprintf(go, sizeof(go), "go movetime %d\n", (int)movetimeMs);
+    else
+      snprintf(go, sizeof(go), "go xtime %d otime %d xinc %d oinc %d\n",
+               (int)xtimeMs, (int)otimeMs, (int)xincMs, (int)oincMs);
+    proc.Send(FormatPosition(b) + go);
+    proc.Pump();
+    busy = true;
+  }
+
+  void Stop() {
+    proc.Send("stop\n");
+    proc.Pump();
+  }
+
+  // ==========================================================================
+  // FUNCTION: Poll
+  // ==========================================================================
+  // Non-blocking: pump the pipes and scan received lines. Returns true and
+  // sets *move when a bestmove arrives (-1 if its token is not a cell).
+  // info lines update LastInfo().
+  //
+  bool Poll(int *move) {
+    proc.Pump();
+    std::string line;
+    while (proc.ReadLine(line)) {
+      std::vector<std::string> t = SplitTokens(line);
+      if (t.empty())
+        continue;
+      if (t[0] == "info")
+        info = line;
+      else if (t[0] == "bestmove" && t.size() >= 2 && busy) {
+        busy = false;
+        if (!ParseCell(t[1], move))
+          *move = -1; // not a cell: callers reject it as an illegal move
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const std::string &LastInfo() const { return info; }
+
+private:
+  EngineProcess proc;
+  std::string name;
+  std::string info;
+  bool busy = false;
+};
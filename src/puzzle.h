@@ -0,0 +1,165 @@
+// ============================================================================
+// puzzle.h — Memory-mapped pack of "win in N" puzzles
+// ============================================================================
+// tools/puzzle_miner.cpp finds positions where the side to move has exactly
+// one move that forces a win in N moves (and no faster win), and writes
+// them here; the puzzle scene maps the pack and checks a player's answer
+// with one compare.
+//
+// FILE LAYOUT (little-endian, 8-byte aligned):
+//
+//   PuzzleHeader                    → magic, shape, puzzle count
+//   PuzzleEntry puzzles[count]      → position, answer, N
+//
+// An entry is 24 bytes: the two stone masks (the position as it is shown,
+// side to move implied by the stone counts), the winning cell and N.
+// Entries are sorted by N, then by canonical key, and the miner's searches
+// don't depend on threads or timing, so the same options give the same file
+// byte for byte on any machine; the miner has already removed symmetric
+// duplicates.
+#pragma once
+
+#include "board.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// ============================================================================
+// ON-DISK STRUCTS
+// ============================================================================
+constexpr uint32_t PUZZLE_MAGIC = 0x5A505454; // "TTPZ"
+constexpr uint32_t PUZZLE_VERSION = 1;
+
+struct PuzzleHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint8_t size;
+  uint8_t winLen;
+  uint8_t reserved[2];
+  uint32_t count;
+};
+
+struct PuzzleEntry {
+  uint64_t stones[2]; // X, O
+  uint8_t answer;     // the only cell that wins in `moves`
+  uint8_t moves;      // N: the winning stone is the side's N-th move
+  uint8_t reserved[6];
+};
+
+static_assert(sizeof(PuzzleHeader) == 16, "puzzle header layout changed");
+static_assert(sizeof(PuzzleEntry) == 24, "puzzle entry layout changed");
+
+// ----------------------------------------------------------------------------
+// Conventional location of the pack for a board shape.
+// ----------------------------------------------------------------------------
+inline void PuzzlePath(char *out, size_t cap, int size, int winLen) {
+  snprintf(out, cap, "resources/puzzles_%dx%d_k%d.bin", size, size, winLen);
+}
+
+// Engine board for a puzzle (hash, side to move and result included).
+inline Board PuzzleBoard(const PuzzleEntry &e, int size, int winLen) {
+  int cells[MAX_CELLS] = {0};
+  for (int p = 0; p < 2; p++)
+    for (uint64_t m = e.stones[p]; m; m &= m - 1)
+      cells[__builtin_ctzll(m)] = p + 1;
+  return BoardFromCells(cells, size, winLen);
+}
+
+// ============================================================================
+// FUNCTION: WritePuzzlePack
+// ============================================================================
+// Write `puzzles` (already deduplicated and sorted) as a pack. Returns false
+// if the file could not be written completely.
+//
+inline bool WritePuzzlePack(const char *path, int size, int winLen,
+                            const std::vector<PuzzleEntry> &puzzles) {
+  PuzzleHeader h = {};
+  h.magic = PUZZLE_MAGIC;
+  h.version = PUZZLE_VERSION;
+  h.size = (uint8_t)size;
+  h.winLen = (uint8_t)winLen;
+  h.count = (uint32_t)puzzles.size();
+
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+            fwrite(puzzles.data(), sizeof(PuzzleEntry), puzzles.size(), f) ==
+                puzzles.size();
+  return fclose(f) == 0 && ok;
+}
+
+// ============================================================================
+// CLASS: PuzzlePack
+// ============================================================================
+// Read-only view of a pack file mapped into memory, like Book: opening
+// costs one mmap() and a puzzle is read straight from the mapping.
+//
+class PuzzlePack {
+public:
+  PuzzlePack() = default;
+  ~PuzzlePack() { Close(); }
+  PuzzlePack(const PuzzlePack &) = delete;
+  PuzzlePack &operator=(const PuzzlePack &) = delete;
+
+  // Map `path` and validate it against the expected board shape. A missing
+  // or mismatching file leaves the pack empty.
+  bool Open(const char *path, int size, int winLen) {
+    Close();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PuzzleHeader)) {
+      close(fd);
+      return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if (p == MAP_FAILED)
+      return false;
+
+    const PuzzleHeader *h = (const PuzzleHeader *)p;
+    size_t need =
+        sizeof(PuzzleHeader) + (size_t)h->count * sizeof(PuzzleEntry);
+    if (h->magic != PUZZLE_MAGIC || h->version != PUZZLE_VERSION ||
+        h->size != size || h->winLen != winLen ||
+        (size_t)st.st_size < need) {
+      munmap(p, st.st_size);
+      return false;
+    }
+
+    base = p;
+    length = st.st_size;
+    header = h;
+    entries = (const PuzzleEntry *)(h + 1);
+    return true;
+  }
+
+  void Close() {
+    if (base)
+      munmap(base, length);
+    base = nullptr;
+    header = nullptr;
+  }
+
+  bool Loaded() const { return header != nullptr; }
+  uint32_t Count() const { return header ? header->count : 0; }
+  const PuzzleEntry &At(uint32_t i) const { return entries[i]; }
+
+  // The answer check: one compare, no search.
+  static bool Solves(const PuzzleEntry &e, int cell) {
+    return cell == e.answer;
+  }
+
+private:
+  void *base = nullptr;
+  size_t length = 0;
+  const PuzzleHeader *header = nullptr;
+  const PuzzleEntry *entries = nullptr;
+};
@@ -0,0 +1,232 @@
+// ============================================================================
+// quantum.h — Quantum tic-tac-toe rules with union-find cycle detection
+// ============================================================================
+// Move t (1-based; X plays odd t, O even t) puts a "spooky" mark t into two
+// different cells that hold no classical mark yet. Cells are the nodes of an
+// entanglement graph and spooky marks its edges. A move whose two cells are
+// already connected closes a cycle, and the cycle collapses: the player who
+// did not close it chooses which of the two cells mark t takes, and that
+// choice fixes every other mark of the connected component (a cell that
+// receives a classical mark sends each of its other spooky marks to their
+// other cell, and so on).
+//
+//   Place()    → cycle test with a union-find over the 9 cells (path
+//                halving, union by size): two Find()s and a union, so
+//                effectively constant time per move
+//   Collapse() → iterative propagation over a fixed-size stack in the
+//                object itself; no allocation
+//
+// Union-find never needs to delete an edge. A component that collapses has
+// as many marks as cells (a tree plus the closing edge), so every one of its
+// cells becomes classical and never takes part in a later move; its sets are
+// simply never queried again.
+//
+// At most 9 moves are ever made: each mark is either classical (one per
+// cell) or an edge of a forest on the remaining cells (fewer edges than
+// cells). When only one cell is left, the next player fills it with a plain
+// classical mark (PlaceLast()).
+//
+// A line of three classical marks of one player wins. If one collapse
+// completes lines for both players, the line whose newest mark is older
+// wins (the published rules split the point 1 : ½; the game names one
+// winner). Players use the game's values (RESULT_X = 1, RESULT_O = 2).
+#pragma once
+
+#include "board.h"
+
+#include <cstdint>
+
+// ============================================================================
+// CLASS: QuantumBoard
+// ============================================================================
+class QuantumBoard {
+public:
+  static constexpr int CELLS = 9;
+  static constexpr int MAX_MOVES = 9;
+
+  // Player who makes move t.
+  static int Owner(int move) { return move & 1 ? RESULT_X : RESULT_O; }
+
+  int Moves() const { return moves; }
+  int SideToMove() const { return Owner(moves + 1); }
+  int Result() const { return result; }
+
+  // Move number of the classical mark in `cell`, 0 if none.
+  int Classical(int cell) const { return classical[cell]; }
+
+  // Bit t is set for every spooky mark t still in `cell`.
+  uint16_t Spooky(int cell) const { return spooky[cell]; }
+
+  // The two cells move t was played in.
+  void MarkCells(int move, int *a, int *b) const {
+    *a = cellA[move];
+    *b = cellB[move];
+  }
+
+  // Move whose cycle waits for Collapse(), 0 if none. The player to move
+  // (the one who did not close the cycle) makes the choice.
+  int Pending() const { return pending; }
+
+  // Cells of the winning line, as a 9-bit mask (0 while nobody has won).
+  uint16_t WinningCells() const { return winCells; }
+
+  // Cells without a classical mark.
+  int Remaining() const {
+    int n = 0;
+    for (int c = 0; c < CELLS; c++)
+      n += classical[c] == 0;
+    return n;
+  }
+
+  // The single cell left for PlaceLast(), -1 unless that is the next move.
+  int LastCell() const {
+    if (pending || result != RESULT_NONE || Remaining() != 1)
+      return -1;
+    for (int c = 0; c < CELLS; c++)
+      if (!classical[c])
+        return c;
+    return -1;
+  }
+
+  bool CanPlace(int a, int b) const {
+    return result == RESULT_NONE && !pending && a != b && a >= 0 &&
+           a < CELLS && b >= 0 && b < CELLS && !classical[a] &&
+           !classical[b] && moves < MAX_MOVES;
+  }
+
+  // ==========================================================================
+  // FUNCTION: Place
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // int a, b → two different cells accepted by CanPlace()
+  //
+  // ============= Return Value =============
+  // bool → true if the mark closes a cycle; Pending() is then this move and
+  //        the game waits for Collapse().
+  //
+  bool Place(int a, int b) {
+    int t = ++moves;
+    cellA[t] = (int8_t)a;
+    cellB[t] = (int8_t)b;
+    spooky[a] |= Bit(t);
+    spooky[b] |= Bit(t);
+
+    int ra = Find(a), rb = Find(b);
+    if (ra == rb) {
+      pending = t;
+      return true;
+    }
+    if (size[ra] < size[rb]) {
+      int s = ra;
+      ra = rb;
+      rb = s;
+    }
+    parent[rb] = (uint8_t)ra;
+    size[ra] += size[rb];
+    return false;
+  }
+
+  bool CanCollapse(int cell) const {
+    return pending && (cell == cellA[pending] || cell == cellB[pending]);
+  }
+
+  // ==========================================================================
+  // FUNCTION: Collapse
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // int cell → where the pending mark lands (CanCollapse() must hold)
+  //
+  // ============= Side Effects =============
+  // - Every mark of the cycle's component becomes classical.
+  // - Updates Result() and WinningCells().
+  //
+  // ============= Approach =============
+  // Depth-first over a stack of (move, cell) steps: placing mark t in a cell
+  // removes t from its other cell and pushes every other spooky mark of the
+  // cell towards its other cell. Each mark is pushed at most once (the one
+  // cell it can still go to), so the stack never holds more than
+  // MAX_MOVES + 1 steps.
+  //
+  void Collapse(int cell) {
+    struct Step {
+      int8_t move, cell;
+    };
+    Step stack[MAX_MOVES + 1];
+    int top = 0;
+    stack[top++] = Step{(int8_t)pending, (int8_t)cell};
+    pending = 0;
+
+    while (top) {
+      Step s = stack[--top];
+      if (classical[s.cell] || !(spooky[s.cell] & Bit(s.move)))
+        continue; // already resolved from its other end
+      classical[s.cell] = s.move;
+      spooky[OtherCell(s.move, s.cell)] &= (uint16_t)~Bit(s.move);
+      uint16_t rest = spooky[s.cell] & (uint16_t)~Bit(s.move);
+      spooky[s.cell] = 0;
+      for (; rest && top <= MAX_MOVES; rest &= rest - 1) {
+        int u = __builtin_ctz(rest);
+        stack[top++] = Step{(int8_t)u, (int8_t)OtherCell(u, s.cell)};
+      }
+    }
+    Score();
+  }
+
+  // Fill LastCell() with a classical mark for the side to move.
+  void PlaceLast() {
+    int c = LastCell();
+    if (c < 0)
+      return;
+    int t = ++moves;
+    cellA[t] = cellB[t] = (int8_t)c;
+    classical[c] = (uint8_t)t;
+    Score();
+  }
+
+private:
+  static uint16_t Bit(int move) { return (uint16_t)(1u << move); }
+
+  int OtherCell(int move, int cell) const {
+    return cellA[move] == cell ? cellB[move] : cellA[move];
+  }
+
+  int Find(int c) {
+    while (parent[c] != c) {
+      parent[c] = parent[parent[c]];
+      c = parent[c];
+    }
+    return c;
+  }
+
+  // Result from the classical marks: the earliest-completed line wins.
+  void Score() {
+    static const uint8_t LINES[8][3] = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8},
+                                        {0, 3, 6}, {1, 4, 7}, {2, 5, 8},
+                                        {0, 4, 8}, {2, 4, 6}};
+    int newest = MAX_MOVES + 1;
+    for (const auto &l : LINES) {
+      int m0 = classical[l[0]], m1 = classical[l[1]], m2 = classical[l[2]];
+      if (!m0 || !m1 || !m2 || Owner(m0) != Owner(m1) ||
+          Owner(m0) != Owner(m2))
+        continue;
+      int n = m0 > m1 ? (m0 > m2 ? m0 : m2) : (m1 > m2 ? m1 : m2);
+      if (n < newest) {
+        newest = n;
+        result = Owner(m0);
+        winCells = (uint16_t)(1u << l[0] | 1u << l[1] | 1u << l[2]);
+      }
+    }
+    if (result == RESULT_NONE && Remaining() == 0)
+      result = RESULT_DRAW;
+  }
+
+  int8_t cellA[MAX_MOVES + 1] = {}, cellB[MAX_MOVES + 1] = {};
+  uint8_t classical[CELLS] = {};
+  uint16_t spooky[CELLS] = {};
+  uint8_t parent[CELLS] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+  uint8_t size[CELLS] = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+  int moves = 0;
+  int pending = 0;
+  int result = RESULT_NONE;
+  uint16_t winCells = 0;
+};
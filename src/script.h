@@ -0,0 +1,287 @@
+// ============================================================================
+// script.h — C++20 coroutine scripts for timed, sequenced game logic
+// ============================================================================
+// A scene transition, an AI "thinking" pause or a tutorial is naturally
+// written as straight-line code that waits in between steps. Without
+// coroutines every such sequence becomes a state machine with flags in
+// GameState; with them it stays one function:
+//
+//   Script FadeToScene(GameState &G, SceneName to) {
+//     G.fade = 1.0f;
+//     co_await Wait(0.2);
+//     G.scene = to;
+//   }
+//   ...
+//   runner.Start(FadeToScene(G, SCENE_GAME));
+//
+//   Script       → coroutine return type; owns the frame until started
+//   Wait(s)      → suspend for s seconds of runner time (0 = next Tick())
+//   ScriptRunner → resumes due scripts from the owning loop's Tick(now)
+//   ScriptPool   → per-thread size-class free lists the coroutine frames
+//                  come from, so starting a script does not touch the heap
+//                  once the pool is warm
+//
+// Scripts are single-threaded: a script is started, resumed and destroyed
+// by the thread that owns its ScriptRunner. Waiting scripts sit in a binary
+// heap keyed on wake time, so a Tick() costs O(k log n) for k due scripts
+// out of n suspended ones, and a suspended script costs only its frame
+// (typically well under 256 bytes).
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <new>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// STRUCT: ScriptPool
+// ============================================================================
+// Fixed-size blocks in power-of-two classes from 64 to 1024 bytes, carved
+// out of 64 KB slabs. Freed blocks go back on their class's free list and
+// slabs are only returned at thread exit, so a steady stream of short
+// scripts allocates nothing after warm-up. Frames above the largest class
+// fall back to malloc and are counted.
+//
+struct ScriptPool {
+  static constexpr size_t MIN_BLOCK = 64;
+  static constexpr int CLASSES = 5; // 64, 128, 256, 512, 1024
+  static constexpr size_t SLAB_BYTES = 64 * 1024;
+
+  struct Stats {
+    uint64_t live;          // frames currently allocated
+    uint64_t slabs;         // slabs taken from the heap
+    uint64_t heapFallbacks; // frames too large for any class
+  };
+
+  static void *Allocate(size_t bytes) {
+    Local &L = local;
+    int c = Class(bytes);
+    L.stats.live++;
+    if (c < 0) {
+      L.stats.heapFallbacks++;
+      if (void *p = std::malloc(bytes))
+        return p;
+      throw std::bad_alloc();
+    }
+    if (!L.lists[c])
+      Refill(L, c);
+    FreeBlock *b = L.lists[c];
+    L.lists[c] = b->next;
+    return b;
+  }
+
+  static void Free(void *p, size_t bytes) {
+    Local &L = local;
+    int c = Class(bytes);
+    L.stats.live--;
+    if (c < 0) {
+      std::free(p);
+      return;
+    }
+    FreeBlock *b = static_cast<FreeBlock *>(p);
+    b->next = L.lists[c];
+    L.lists[c] = b;
+  }
+
+  // The calling thread's counters.
+  static Stats ThreadStats() { return local.stats; }
+
+private:
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  // No member initializers (not allowed here); thread_local storage starts
+  // zeroed anyway.
+  struct Local {
+    FreeBlock *lists[CLASSES];
+    std::vector<void *> slabs;
+    Stats stats;
+    ~Local() {
+      for (void *s : slabs)
+        std::free(s);
+    }
+  };
+
+  static inline thread_local Local local;
+
+  static int Class(size_t bytes) {
+    size_t size = MIN_BLOCK;
+    for (int c = 0; c < CLASSES; c++, size *= 2)
+      if (bytes <= size)
+        return c;
+    return -1;
+  }
+
+  static void Refill(Local &L, int c) {
+    size_t block = MIN_BLOCK << c;
+    unsigned char *slab = static_cast<unsigned char *>(std::malloc(SLAB_BYTES));
+    if (!slab)
+      throw std::bad_alloc();
+    L.slabs.push_back(slab);
+    L.stats.slabs++;
+    for (size_t at = 0; at + block <= SLAB_BYTES; at += block) {
+      FreeBlock *b = reinterpret_cast<FreeBlock *>(slab + at);
+      b->next = L.lists[c];
+      L.lists[c] = b;
+    }
+  }
+};
+
+class ScriptRunner;
+
+// ============================================================================
+// CLASS: Script
+// ============================================================================
+// Move-only handle to a suspended coroutine that has not been started yet.
+// ScriptRunner::Start() takes the frame over; a Script that is never started
+// destroys its frame.
+//
+class Script {
+public:
+  struct promise_type {
+    ScriptRunner *runner = nullptr;
+    double wake = 0.0;
+
+    Script get_return_object() {
+      return Script(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    // Lazy start: the runner resumes it for the first time in Start().
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    // Stay suspended at the end so the runner sees done() and frees it.
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+
+    static void *operator new(size_t bytes) {
+      return ScriptPool::Allocate(bytes);
+    }
+    static void operator delete(void *p, size_t bytes) {
+      ScriptPool::Free(p, bytes);
+    }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Script(Script &&o) noexcept : handle(std::exchange(o.handle, {})) {}
+  Script &operator=(Script &&o) noexcept {
+    if (this != &o) {
+      if (handle)
+        handle.destroy();
+      handle = std::exchange(o.handle, {});
+    }
+    return *this;
+  }
+  ~Script() {
+    if (handle)
+      handle.destroy();
+  }
+
+  // Give up ownership (used by ScriptRunner::Start).
+  Handle Release() { return std::exchange(handle, {}); }
+
+private:
+  explicit Script(Handle h) : handle(h) {}
+  Handle handle;
+};
+
+// ============================================================================
+// CLASS: ScriptRunner
+// ============================================================================
+// Owns every started script and resumes each one when its Wait() is over.
+// Driven by one loop calling Tick() with a monotonically increasing time in
+// seconds; all waits are measured against those Tick() times.
+//
+class ScriptRunner {
+public:
+  explicit ScriptRunner(size_t expected = 64) {
+    waiting.reserve(expected);
+    due.reserve(expected);
+  }
+  ~ScriptRunner() { StopAll(); }
+  ScriptRunner(const ScriptRunner &) = delete;
+  ScriptRunner &operator=(const ScriptRunner &) = delete;
+
+  // Run `script` up to its first Wait() right away, so its first step takes
+  // effect in the same logic step that started it.
+  void Start(Script script) {
+    Script::Handle h = script.Release();
+    h.promise().runner = this;
+    Resume(h);
+  }
+
+  // Resume every script whose wait ended at or before `time`. Scripts that
+  // wait again (even Wait(0)) are resumed on a later Tick(), never twice in
+  // one.
+  void Tick(double time) {
+    now = time;
+    due.clear();
+    while (!waiting.empty() && waiting.front().wake <= now) {
+      std::pop_heap(waiting.begin(), waiting.end(), Later);
+      due.push_back(waiting.back().handle);
+      waiting.pop_back();
+    }
+    for (Script::Handle h : due)
+      Resume(h);
+  }
+
+  // Destroy all suspended scripts without running them further.
+  void StopAll() {
+    for (const Entry &e : waiting)
+      e.handle.destroy();
+    waiting.clear();
+  }
+
+  double Now() const { return now; }
+  size_t Active() const { return waiting.size(); }
+
+private:
+  friend struct WaitAwaiter;
+
+  struct Entry {
+    double wake;
+    Script::Handle handle;
+  };
+
+  // Heap order: earliest wake time on top.
+  static bool Later(const Entry &a, const Entry &b) { return a.wake > b.wake; }
+
+  void Resume(Script::Handle h) {
+    h.resume();
+    if (h.done()) {
+      h.destroy();
+      return;
+    }
+    waiting.push_back(Entry{h.promise().wake, h});
+    std::push_heap(waiting.begin(), waiting.end(), Later);
+  }
+
+  std::vector<Entry> waiting;
+  std::vector<Script::Handle> due;
+  double now = 0.0;
+};
+
+// ============================================================================
+// AWAITABLE: Wait
+// ============================================================================
+// co_await Wait(seconds) inside a Script. Evaluates to the runner time at
+// which the script was resumed.
+//
+struct WaitAwaiter {
+  double seconds;
+  ScriptRunner *runner = nullptr;
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(Script::Handle h) noexcept {
+    runner = h.promise().runner;
+    h.promise().wake = runner->now + seconds;
+  }
+  double await_resume() const noexcept { return runner->now; }
+};
+
+inline WaitAwaiter Wait(double seconds) { return WaitAwaiter{seconds}; }
@@ -0,0 +1,598 @@
+// ============================================================================
+// search.h — Iterative-deepening alpha-beta search for k-in-a-row boards
+// ============================================================================
+// The CPU opponent and the offline tools share this searcher:
+//
+//   TransTable → fixed-size hash table of previously searched positions
+//   Searcher   → negamax alpha-beta with TT move ordering, iterative
+//                deepening and a wall-clock limit
+//
+// Scores are from the side to move's point of view. A forced win found at
+// ply p scores SCORE_WIN - p, so shorter wins are preferred and longer
+// losses are preferred when losing.
+#pragma once
+
+#include "arena.h"
+#include "board.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// CONSTANTS
+// ============================================================================
+constexpr int SCORE_WIN = 100000;
+constexpr int SCORE_INF = SCORE_WIN + 1;
+constexpr int SCORE_MATE_BOUND = SCORE_WIN - 1000; // |score| above → forced
+
+enum TTBound : uint8_t { BOUND_NONE = 0, BOUND_EXACT, BOUND_LOWER, BOUND_UPPER };
+
+// ============================================================================
+// STRUCT: TTEntry / CLASS: TransTable
+// ============================================================================
+// Lock-free table shared by every search thread (Lazy SMP).
+//
+// Each slot is 16 bytes: a data word packing score/depth/move/bound/age and
+// a check word holding key ^ data. Both words are written and read with
+// relaxed atomics and no lock. A reader accepts a slot only if
+// check ^ data == key, so a slot torn by two concurrent writers simply looks
+// like a miss instead of returning another position's data.
+//
+// Slots are grouped in buckets of 4 (64 bytes, one cache line) so a probe
+// touches a single line. The table is never cleared between moves or games:
+// every root search starts a new generation, and within a bucket the entry
+// from the oldest generation / shallowest depth is replaced first.
+//
+// MEMBER VARIABLES (TTEntry, the unpacked form):
+//   score → search score (mate scores stored relative to this node)
+//   depth → remaining depth the score was searched to
+//   move  → best move found, or 0xFF
+//   bound → exact / lower / upper bound
+//   age   → generation that last wrote the entry
+//
+struct TTEntry {
+  int32_t score = 0;
+  uint8_t depth = 0;
+  uint8_t move = 0xFF;
+  uint8_t bound = BOUND_NONE;
+  uint8_t age = 0;
+};
+
+class TransTable {
+public:
+  static constexpr int BUCKET_SLOTS = 4;
+
+  explicit TransTable(size_t entries = 1 << 20) { Resize(entries); }
+  TransTable(const TransTable &) = delete;
+  TransTable &operator=(const TransTable &) = delete;
+
+  // Round the bucket count down to a power of two so indexing is a mask.
+  // Not thread-safe: only call while no search is running.
+  void Resize(size_t entries) {
+    size_t n = 1;
+    while (n * 2 * BUCKET_SLOTS <= entries)
+      n *= 2;
+    buckets.reset(new Bucket[n]);
+    count = n;
+    mask = n - 1;
+  }
+
+  // Not thread-safe: only call while no search is running.
+  void Clear() {
+    for (size_t i = 0; i < count; i++)
+      for (Slot &s : buckets[i].slots) {
+        s.check.store(0, std::memory_order_relaxed);
+        s.data.store(0, std::memory_order_relaxed);
+      }
+  }
+
+  // Called once per root search; wraps harmlessly after 256 generations.
+  void NewGeneration() {
+    generation.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // ==========================================================================
+  // FUNCTION: Probe
+  // ==========================================================================
+  // Copy the entry for `key` into `out`. Returns false on a miss (including
+  // a slot that was torn by concurrent writers).
+  //
+  bool Probe(uint64_t key, TTEntry &out) const {
+    const Bucket &b = buckets[key & mask];
+    for (const Slot &s : b.slots) {
+      uint64_t data = s.data.load(std::memory_order_relaxed);
+      uint64_t check = s.check.load(std::memory_order_relaxed);
+      if ((check ^ data) == key && data != 0) {
+        out = Unpack(data);
+        return out.bound != BOUND_NONE;
+      }
+    }
+    return false;
+  }
+
+  // ==========================================================================
+  // FUNCTION: Store
+  // ==========================================================================
+  // ============= Approach =============
+  // - A slot already holding `key` is overwritten unless it has a deeper
+  //   result from this generation (exact bounds always win).
+  // - Otherwise replace the slot with the lowest depth - 4 × age difference,
+  //   so entries left over from earlier moves or games go first.
+  //
+  void Store(uint64_t key, int score, int depth, int move, TTBound bound) {
+    Bucket &b = buckets[key & mask];
+    uint8_t gen = generation.load(std::memory_order_relaxed);
+
+    Slot *victim = nullptr;
+    int victimWorth = 1 << 30;
+    for (Slot &s : b.slots) {
+      uint64_t data = s.data.load(std::memory_order_relaxed);
+      uint64_t check = s.check.load(std::memory_order_relaxed);
+      TTEntry e = Unpack(data);
+
+      if ((check ^ data) == key) {
+        if (e.age == gen && e.depth > depth && bound != BOUND_EXACT)
+          return; // keep the deeper result from the current generation
+        victim = &s;
+        break;
+      }
+      int worth = data == 0 ? -1000 : e.depth - 4 * (uint8_t)(gen - e.age);
+      if (worth < victimWorth) {
+        victimWorth = worth;
+        victim = &s;
+      }
+    }
+
+    TTEntry e;
+    e.score = score;
+    e.depth = (uint8_t)depth;
+    e.move = (uint8_t)move;
+    e.bound = bound;
+    e.age = gen;
+    uint64_t data = Pack(e);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> check{0};
+    std::atomic<uint64_t> data{0};
+  };
+  struct alignas(64) Bucket {
+    Slot slots[BUCKET_SLOTS];
+  };
+  static_assert(sizeof(Slot) == 16, "TT slots must stay 16 bytes");
+  static_assert(sizeof(Bucket) == 64, "TT buckets must fill one cache line");
+
+  static uint64_t Pack(const TTEntry &e) {
+    return (uint64_t)(uint32_t)e.score | (uint64_t)e.depth << 32 |
+           (uint64_t)e.move << 40 | (uint64_t)e.bound << 48 |
+           (uint64_t)e.age << 56;
+  }
+  static TTEntry Unpack(uint64_t d) {
+    TTEntry e;
+    e.score = (int32_t)(uint32_t)d;
+    e.depth = (uint8_t)(d >> 32);
+    e.move = (uint8_t)(d >> 40);
+    e.bound = (uint8_t)(d >> 48);
+    e.age = (uint8_t)(d >> 56);
+    return e;
+  }
+
+  std::unique_ptr<Bucket[]> buckets;
+  size_t count = 0;
+  size_t mask = 0;
+  std::atomic<uint8_t> generation{0};
+};
+
+// ----------------------------------------------------------------------------
+// Mate scores are stored relative to the node, not the root, so the same
+// position reached at different plies reads back the correct distance.
+// ----------------------------------------------------------------------------
+inline int ScoreToTT(int s, int ply) {
+  return s > SCORE_MATE_BOUND ? s + ply : s < -SCORE_MATE_BOUND ? s - ply : s;
+}
+inline int ScoreFromTT(int s, int ply) {
+  return s > SCORE_MATE_BOUND ? s - ply : s < -SCORE_MATE_BOUND ? s + ply : s;
+}
+
+// ============================================================================
+// FUNCTION: Evaluate
+// ============================================================================
+// ============= Objective =============
+// Static score of a non-terminal position for the side to move.
+//
+// ============= Approach =============
+// Every winning line still open for only one colour contributes a weight that
+// grows quickly with the number of stones already on it (1, 4, 16, ...).
+// Lines holding both colours are dead and ignored.
+//
+inline int Evaluate(const Board &b) {
+  int score = 0;
+  for (uint64_t m : b.geo->lines) {
+    int x = __builtin_popcountll(b.stones[0] & m);
+    int o = __builtin_popcountll(b.stones[1] & m);
+    if (o == 0 && x > 0)
+      score += 1 << (2 * (x - 1));
+    else if (x == 0 && o > 0)
+      score -= 1 << (2 * (o - 1));
+  }
+  return b.side == 0 ? score : -score;
+}
+
+// ============================================================================
+// FUNCTION: GenerateMoves
+// ============================================================================
+// ============= Objective =============
+// Fill `out` with candidate moves and return how many were written.
+//
+// ============= Approach =============
+// - Boards up to 4×4: every empty cell.
+// - Larger boards: only empty cells within distance 2 of an existing stone
+//   (or the centre on an empty board). Far-away moves are never useful in
+//   k-in-a-row and pruning them shrinks the branching factor dramatically.
+// - Cells are emitted centre-first, which is a good default ordering.
+//
+inline int GenerateMoves(const Board &b, uint8_t *out) {
+  const Geometry &g = *b.geo;
+  uint64_t cand = b.Empty();
+
+  if (g.cells > 16) {
+    uint64_t occ = b.Occupied();
+    if (occ == 0) {
+      int mid = g.size / 2;
+      out[0] = (uint8_t)(mid * g.size + mid);
+      return 1;
+    }
+    uint64_t near = 0;
+    for (uint64_t s = occ; s; s &= s - 1)
+      near |= g.near[__builtin_ctzll(s)];
+    cand &= near;
+  }
+
+  // Centre-first ordering by Manhattan distance from the middle.
+  int n = 0;
+  int twiceMid = g.size - 1;
+  for (int ring = 0; ring <= 2 * twiceMid && cand; ring++)
+    for (uint64_t s = cand; s; s &= s - 1) {
+      int c = __builtin_ctzll(s);
+      int r = c / g.size, k = c % g.size;
+      int d = (r * 2 > twiceMid ? r * 2 - twiceMid : twiceMid - r * 2) +
+              (k * 2 > twiceMid ? k * 2 - twiceMid : twiceMid - k * 2);
+      if (d == ring) {
+        out[n++] = (uint8_t)c;
+        cand &= ~(1ull << c);
+      }
+    }
+  return n;
+}
+
+// ============================================================================
+// STRUCT: SearchLimits / SearchResult
+// ============================================================================
+//   maxDepth → stop iterative deepening after this depth
+//   timeMs   → wall-clock budget; the last completed iteration is returned.
+//              Negative means "keep the deadline already set with
+//              Searcher::SetDeadline()" (pondering starts open-ended and is
+//              given a real deadline later from another thread).
+//
+//   move     → best root move (-1 if the position is already over)
+//   score    → score of that move for the side to move
+//   depth    → deepest fully completed iteration
+//   nodes    → positions visited
+//
+struct SearchLimits {
+  int maxDepth = 64;
+  double timeMs = 1000.0;
+};
+
+struct SearchResult {
+  int move = -1;
+  int score = 0;
+  int depth = 0;
+  uint64_t nodes = 0;
+};
+
+// ============================================================================
+// STRUCT: SearchControl
+// ============================================================================
+// Flags shared by all threads of one Searcher. Any thread may write them.
+//
+//   stop        → external stop request (sticky until ClearStop)
+//   helpersStop → main thread finished; helper threads should return
+//   deadlineNs  → steady-clock deadline in nanoseconds
+//
+struct SearchControl {
+  std::atomic<bool> stop{false};
+  std::atomic<bool> helpersStop{false};
+  std::atomic<int64_t> deadlineNs{0};
+};
+
+inline int64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// ============================================================================
+// CLASS: SearchWorker
+// ============================================================================
+// One search thread: iterative-deepening negamax over the shared table.
+// Worker 0 is the main thread; helpers (id > 0) differ only in where they
+// start deepening and in their root move order, so they naturally explore
+// different parts of the tree and feed each other through the table.
+//
+class SearchWorker {
+public:
+  SearchWorker(TransTable &tt, SearchControl &ctl, int id)
+      : tt(tt), ctl(ctl), id(id) {}
+
+  // ==========================================================================
+  // FUNCTION: Run
+  // ==========================================================================
+  // Search `root` up to `maxDepth` and return the last completed iteration.
+  //
+  SearchResult Run(const Board &root, int maxDepth) {
+    SearchResult best;
+    Board b = root;
+    timeUp = false;
+    nodes = 0;
+
+    for (int depth = 1 + (id & 1); depth <= maxDepth; depth++) {
+      int move = -1;
+      int score = Root(b, depth, &move);
+      if (Aborted()) {
+        // Incomplete iteration: keep the previous answer. If there is none,
+        // still return a legal move, reported as depth 0 with no score.
+        if (best.move < 0)
+          best.move = move;
+        break;
+      }
+
+      best.move = move;
+      best.score = score;
+      best.depth = depth;
+      // A mate score can come from a deeper table entry, so it is only
+      // known to be the shortest once this iteration reached its distance.
+      int mateIn = SCORE_WIN - (score < 0 ? -score : score);
+      if ((score > SCORE_MATE_BOUND || score < -SCORE_MATE_BOUND) &&
+          depth >= mateIn)
+        break;
+    }
+    best.nodes = nodes;
+    return best;
+  }
+
+private:
+  bool Aborted() const {
+    return timeUp || ctl.stop.load(std::memory_order_relaxed) ||
+           (id > 0 && ctl.helpersStop.load(std::memory_order_relaxed));
+  }
+
+  // -------------------------------------------------------------------------
+  // Root: search every root move with a full window and report the best.
+  // -------------------------------------------------------------------------
+  int Root(Board &b, int depth, int *bestMove) {
+    uint8_t moves[MAX_CELLS];
+    int n = OrderedMoves(b, moves);
+
+    // Helpers rotate the root order so threads start on different moves.
+    if (id > 0 && n > 1) {
+      uint8_t rotated[MAX_CELLS];
+      for (int i = 0; i < n; i++)
+        rotated[i] = moves[(i + id) % n];
+      for (int i = 0; i < n; i++)
+        moves[i] = rotated[i];
+    }
+
+    int alpha = -SCORE_INF;
+    *bestMove = moves[0];
+    for (int i = 0; i < n; i++) {
+      b.Make(moves[i]);
+      int s = -Negamax(b, depth - 1, -SCORE_INF, -alpha, 1);
+      b.Unmake(moves[i]);
+      if (Aborted())
+        break;
+      if (s > alpha) {
+        alpha = s;
+        *bestMove = moves[i];
+      }
+    }
+    if (!Aborted())
+      tt.Store(b.hash, ScoreToTT(alpha, 0), depth, *bestMove, BOUND_EXACT);
+    return alpha;
+  }
+
+  // -------------------------------------------------------------------------
+  // Negamax: fail-soft alpha-beta with transposition table.
+  // -------------------------------------------------------------------------
+  int Negamax(Board &b, int depth, int alpha, int beta, int ply) {
+    if ((++nodes & 1023) == 0 &&
+        SteadyNowNs() >= ctl.deadlineNs.load(std::memory_order_relaxed))
+      timeUp = true;
+    if (Aborted())
+      return 0;
+
+    // The previous mover just won (a loss for us) or filled the board.
+    if (b.winner == RESULT_DRAW)
+      return 0;
+    if (b.winner != RESULT_NONE)
+      return -(SCORE_WIN - ply);
+    if (depth == 0)
+      return Evaluate(b);
+
+    int alphaOrig = alpha;
+    TTEntry e;
+    if (tt.Probe(b.hash, e) && e.depth >= depth) {
+      int s = ScoreFromTT(e.score, ply);
+      if (e.bound == BOUND_EXACT || (e.bound == BOUND_LOWER && s >= beta) ||
+          (e.bound == BOUND_UPPER && s <= alpha))
+        return s;
+    }
+
+    uint8_t moves[MAX_CELLS];
+    int n = OrderedMoves(b, moves);
+
+    int best = -SCORE_INF;
+    int bestMove = moves[0];
+    for (int i = 0; i < n; i++) {
+      b.Make(moves[i]);
+      int s = -Negamax(b, depth - 1, -beta, -alpha, ply + 1);
+      b.Unmake(moves[i]);
+      if (Aborted())
+        return 0;
+
+      if (s > best) {
+        best = s;
+        bestMove = moves[i];
+      }
+      if (s > alpha)
+        alpha = s;
+      if (alpha >= beta)
+        break;
+    }
+
+    TTBound bound = best <= alphaOrig ? BOUND_UPPER
+                    : best >= beta    ? BOUND_LOWER
+                                      : BOUND_EXACT;
+    tt.Store(b.hash, ScoreToTT(best, ply), depth, bestMove, bound);
+    return best;
+  }
+
+  // -------------------------------------------------------------------------
+  // OrderedMoves: generate moves and put the TT move first.
+  // -------------------------------------------------------------------------
+  int OrderedMoves(const Board &b, uint8_t *moves) {
+    int n = GenerateMoves(b, moves);
+    TTEntry e;
+    if (tt.Probe(b.hash, e))
+      for (int i = 1; i < n; i++)
+        if (moves[i] == e.move) {
+          uint8_t m = moves[i];
+          for (int j = i; j > 0; j--)
+            moves[j] = moves[j - 1];
+          moves[0] = m;
+          break;
+        }
+    return n;
+  }
+
+  TransTable &tt;
+  SearchControl &ctl;
+  int id;
+  bool timeUp = false; // deadline reached (this thread)
+  uint64_t nodes = 0;
+};
+
+// ============================================================================
+// CLASS: Searcher
+// ============================================================================
+// Owns the transposition table and runs Lazy SMP on it: `threads` workers
+// search the same root concurrently and share results only through the
+// lock-free table. With threads == 1 no extra thread is ever created.
+//
+// Only one Search() may run at a time, but Stop() and SetDeadline() may be
+// called from any thread while it runs (used for pondering).
+//
+class Searcher {
+public:
+  explicit Searcher(size_t ttEntries = 1 << 20, int threads = 1)
+      : tt(ttEntries) {
+    SetThreads(threads);
+  }
+
+  TransTable &Table() { return tt; }
+  int Threads() const { return (int)workers.size(); }
+
+  // Not thread-safe: only call while no search is running. The scratch
+  // arena is sized here so Search() itself never allocates from the heap.
+  void SetThreads(int threads) {
+    workers.clear();
+    for (int i = 0; i < (threads > 0 ? threads : 1); i++)
+      workers.emplace_back(new SearchWorker(tt, ctl, i));
+    scratch.reset(new LinearArena(
+        workers.size() * (sizeof(SearchResult) + sizeof(std::thread)) + 256));
+  }
+
+  // Ask a running Search() to return as soon as possible. The request stays
+  // set until ClearStop(), so it cannot be lost if it races with the start
+  // of a search on another thread.
+  void Stop() { ctl.stop.store(true, std::memory_order_relaxed); }
+  void ClearStop() { ctl.stop.store(false, std::memory_order_relaxed); }
+
+  // Move the deadline of the running (or next) search to `ms` from now.
+  void SetDeadline(double ms) {
+    ctl.deadlineNs.store(SteadyNowNs() + (int64_t)(ms * 1e6),
+                         std::memory_order_relaxed);
+  }
+
+  // ==========================================================================
+  // FUNCTION: Search
+  // ==========================================================================
+  // ============= Objective =============
+  // Find the best move for the side to move in `root`.
+  //
+  // ============= Input Parameters =============
+  // const Board &root         → position to search (copied, never modified)
+  // const SearchLimits &limits → depth and time budget
+  //
+  // ============= Return Value =============
+  // SearchResult of the deepest fully completed iteration of any thread;
+  // nodes is the total over all threads.
+  //
+  // ============= Approach =============
+  // Iterative deepening: depth 1, 2, 3, ... each iteration seeds the next one
+  // through the TT best move. Stops early once a forced result is proven.
+  // Helpers run until the main worker finishes, then are told to return.
+  // Per-search bookkeeping comes from the scratch arena, reset per call.
+  //
+  SearchResult Search(const Board &root, const SearchLimits &limits) {
+    if (root.Over())
+      return SearchResult();
+
+    tt.NewGeneration();
+    if (limits.timeMs >= 0)
+      SetDeadline(limits.timeMs);
+    ctl.helpersStop.store(false, std::memory_order_relaxed);
+
+    int remaining = __builtin_popcountll(root.Empty());
+    int maxDepth = limits.maxDepth < remaining ? limits.maxDepth : remaining;
+
+    size_t n = workers.size();
+    scratch->Reset();
+    SearchResult *results = scratch->Alloc<SearchResult>(n);
+    std::thread *helpers = static_cast<std::thread *>(
+        scratch->Allocate(sizeof(std::thread) * n, alignof(std::thread)));
+    for (size_t i = 1; i < n; i++)
+      new (helpers + i) std::thread(
+          [&, i] { results[i] = workers[i]->Run(root, maxDepth); });
+
+    results[0] = workers[0]->Run(root, maxDepth);
+    ctl.helpersStop.store(true, std::memory_order_relaxed);
+    for (size_t i = 1; i < n; i++) {
+      helpers[i].join();
+      helpers[i].~thread();
+    }
+
+    SearchResult best = results[0];
+    uint64_t nodes = 0;
+    for (size_t i = 0; i < n; i++) {
+      const SearchResult &r = results[i];
+      nodes += r.nodes;
+      if (r.move >= 0 && r.depth > best.depth)
+        best = r;
+    }
+    best.nodes = nodes;
+    return best;
+  }
+
+private:
+  TransTable tt;
+  SearchControl ctl;
+  std::vector<std::unique_ptr<SearchWorker>> workers;
+  std::unique_ptr<LinearArena> scratch;
+};
@@ -0,0 +1,250 @@
+// ============================================================================
+// variants.h — k-in-a-row rule variants compiled from a rules policy
+// ============================================================================
+// VariantBoard<Rules> is one rules core for a family of games. Everything
+// that tells the variants apart is a compile-time constant of the policy,
+// so each variant gets its own line tables (built by the compiler) and
+// every rule test folds away; nothing about the rules is looked up or
+// branched on while moves are made:
+//
+//   SIZE, WIN   → board side (at most MAX_SIDE) and marks in a row
+//   EITHER_MARK → the mover places X or O as they like ("wild"); otherwise
+//                 the first player always places X and the second O
+//   MISERE      → completing a line loses instead of winning
+//   ORDER_CHAOS → asymmetric goals: a line of either mark wins for the
+//                 first player (Order) whoever completed it, and a full
+//                 board without one wins for the second (Chaos)
+//
+// A move is a (cell, mark) pair packed as cell * 2 + mark, mark 0 = X and
+// 1 = O. Results use the game's values for the players, not the marks:
+// RESULT_X = the first player (Order) wins, RESULT_O = the second, and
+// RESULT_DRAW.
+//
+// ClassicRules is the plain game; tools/variant_bench checks it against
+// Board move for move and times both. VariantSolver<Rules> solves boards of
+// up to 4×4 exactly.
+#pragma once
+
+#include "board.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+// ============================================================================
+// RULES POLICIES
+// ============================================================================
+struct ClassicRules {
+  static constexpr int SIZE = 3, WIN = 3;
+  static constexpr bool EITHER_MARK = false, MISERE = false;
+  static constexpr bool ORDER_CHAOS = false;
+};
+
+// Wild tic-tac-toe: either player may place either mark.
+struct WildRules {
+  static constexpr int SIZE = 3, WIN = 3;
+  static constexpr bool EITHER_MARK = true, MISERE = false;
+  static constexpr bool ORDER_CHAOS = false;
+};
+
+// Misère 3×3: whoever makes three of their own in a row loses.
+struct MisereRules {
+  static constexpr int SIZE = 3, WIN = 3;
+  static constexpr bool EITHER_MARK = false, MISERE = true;
+  static constexpr bool ORDER_CHAOS = false;
+};
+
+// Order and Chaos: 6×6, five of one mark in a row.
+struct OrderChaosRules {
+  static constexpr int SIZE = 6, WIN = 5;
+  static constexpr bool EITHER_MARK = true, MISERE = false;
+  static constexpr bool ORDER_CHAOS = true;
+};
+
+// ============================================================================
+// STRUCT: LineTable
+// ============================================================================
+// Winning lines of one (SIZE, WIN) shape as bit masks, and the lines
+// through each cell. A constexpr object: the compiler builds it.
+//
+template <int SIZE, int WIN> struct LineTable {
+  static constexpr int CELLS = SIZE * SIZE;
+  static constexpr int SPAN = SIZE - WIN + 1; // windows per row
+  static constexpr int COUNT = 2 * SIZE * SPAN + 2 * SPAN * SPAN;
+  static constexpr int MAX_THROUGH = 4 * WIN; // WIN windows per direction
+
+  uint64_t lines[COUNT] = {};
+  uint64_t through[CELLS][MAX_THROUGH] = {};
+  int throughCount[CELLS] = {};
+
+  constexpr LineTable() {
+    const int dr[4] = {0, 1, 1, 1}, dc[4] = {1, 0, 1, -1};
+    int n = 0;
+    for (int d = 0; d < 4; d++)
+      for (int r = 0; r < SIZE; r++)
+        for (int c = 0; c < SIZE; c++) {
+          int er = r + (WIN - 1) * dr[d], ec = c + (WIN - 1) * dc[d];
+          if (er >= SIZE || ec < 0 || ec >= SIZE)
+            continue;
+          uint64_t mask = 0;
+          for (int k = 0; k < WIN; k++)
+            mask |= 1ull << ((r + k * dr[d]) * SIZE + c + k * dc[d]);
+          lines[n++] = mask;
+          for (int k = 0; k < WIN; k++) {
+            int cell = (r + k * dr[d]) * SIZE + c + k * dc[d];
+            through[cell][throughCount[cell]++] = mask;
+          }
+        }
+  }
+};
+
+template <int SIZE, int WIN>
+inline constexpr LineTable<SIZE, WIN> LINE_TABLE{};
+
+// ============================================================================
+// STRUCT: VariantBoard
+// ============================================================================
+// Copyable position of one variant, the counterpart of Board.
+//
+// MEMBER VARIABLES:
+//   marks[2] → bit masks of X marks ([0]) and O marks ([1])
+//   side     → 0 when the first player (Order) is to move, 1 otherwise
+//   ply      → number of marks on the board
+//   winner   → RESULT_NONE / RESULT_X / RESULT_O / RESULT_DRAW (players)
+//   line     → the completed line, 0 if none
+//
+template <class Rules> struct VariantBoard {
+  static constexpr int SIZE = Rules::SIZE, WIN = Rules::WIN;
+  static constexpr int CELLS = SIZE * SIZE;
+  static constexpr uint64_t FULL =
+      CELLS == 64 ? ~0ull : (1ull << (CELLS % 64)) - 1;
+  static_assert(SIZE >= 3 && SIZE <= MAX_SIDE && WIN >= 3 && WIN <= SIZE,
+                "board must fit a uint64_t and hold a line");
+  static_assert(!(Rules::MISERE && Rules::ORDER_CHAOS),
+                "Order and Chaos has no misère form");
+
+  uint64_t marks[2] = {0, 0};
+  int side = 0;
+  int ply = 0;
+  int winner = RESULT_NONE;
+  uint64_t line = 0;
+
+  static int Move(int cell, int mark) { return cell * 2 + mark; }
+
+  int Result() const { return winner; }
+  bool Over() const { return winner != RESULT_NONE; }
+  uint64_t Empty() const { return FULL & ~(marks[0] | marks[1]); }
+
+  // Mark in `cell` in GameState convention: 0 empty, 1 X, 2 O.
+  int At(int cell) const {
+    uint64_t bit = 1ull << cell;
+    return (marks[0] & bit) ? RESULT_X : (marks[1] & bit) ? RESULT_O : 0;
+  }
+
+  // Can the side to move put `mark` in `cell`?
+  bool Legal(int cell, int mark) const {
+    if (Over() || cell < 0 || cell >= CELLS || !(Empty() >> cell & 1))
+      return false;
+    if constexpr (Rules::EITHER_MARK)
+      return mark == 0 || mark == 1;
+    else
+      return mark == side;
+  }
+
+  // Every legal move; returns the count (at most 2 * CELLS).
+  int GenerateMoves(uint16_t *out) const {
+    int n = 0;
+    for (uint64_t e = Empty(); e; e &= e - 1) {
+      int cell = __builtin_ctzll(e);
+      if constexpr (Rules::EITHER_MARK) {
+        out[n++] = (uint16_t)Move(cell, 0);
+        out[n++] = (uint16_t)Move(cell, 1);
+      } else {
+        out[n++] = (uint16_t)Move(cell, side);
+      }
+    }
+    return n;
+  }
+
+  // -------------------------------------------------------------------------
+  // Make: play a legal move. Only lines through the new mark can have been
+  // completed, so the result is updated from those alone.
+  // -------------------------------------------------------------------------
+  void Make(int move) {
+    int cell = move >> 1, mark = move & 1;
+    marks[mark] |= 1ull << cell;
+    int mover = side;
+    side ^= 1;
+    ply++;
+
+    constexpr const LineTable<SIZE, WIN> &T = LINE_TABLE<SIZE, WIN>;
+    for (int i = 0; i < T.throughCount[cell]; i++) {
+      uint64_t m = T.through[cell][i];
+      if ((marks[mark] & m) == m) {
+        line = m;
+        if constexpr (Rules::ORDER_CHAOS)
+          winner = RESULT_X;
+        else if constexpr (Rules::MISERE)
+          winner = mover == 0 ? RESULT_O : RESULT_X;
+        else
+          winner = mover == 0 ? RESULT_X : RESULT_O;
+        return;
+      }
+    }
+    if (ply == CELLS)
+      winner = Rules::ORDER_CHAOS ? RESULT_O : RESULT_DRAW;
+  }
+
+  // Exact inverse of Make(move) from a position with result `prevWinner`.
+  void Unmake(int move, int prevWinner = RESULT_NONE) {
+    marks[move & 1] &= ~(1ull << (move >> 1));
+    side ^= 1;
+    ply--;
+    winner = prevWinner;
+    line = 0;
+  }
+};
+
+// ============================================================================
+// CLASS: VariantSolver
+// ============================================================================
+// Exact negamax over a variant's whole game tree with a memo keyed on the
+// two mark masks (the side to move follows from their count). Meant for the
+// small boards (up to 4×4) where the full tree is cheap to enumerate.
+//
+template <class Rules> class VariantSolver {
+public:
+  using Position = VariantBoard<Rules>;
+  static_assert(Position::CELLS <= 16, "only small boards can be solved");
+
+  // Value for the side to move: +1 win, 0 draw, -1 loss.
+  int Solve(Position &b) {
+    if (b.Over())
+      return b.winner == RESULT_DRAW                       ? 0
+             : (b.winner == RESULT_X) == (b.side == 0) ? 1
+                                                           : -1;
+    uint64_t key = b.marks[0] | b.marks[1] << 32;
+    auto it = memo.find(key);
+    if (it != memo.end())
+      return it->second;
+
+    nodes++;
+    uint16_t moves[2 * Position::CELLS];
+    int n = b.GenerateMoves(moves);
+    int best = -1;
+    for (int i = 0; i < n && best < 1; i++) {
+      b.Make(moves[i]);
+      int v = -Solve(b);
+      b.Unmake(moves[i]);
+      best = v > best ? v : best;
+    }
+    memo.emplace(key, (int8_t)best);
+    return best;
+  }
+
+  // Positions expanded (memo misses) so far.
+  uint64_t Nodes() const { return nodes; }
+
+private:
+  std::unordered_map<uint64_t, int8_t> memo;
+  uint64_t nodes = 0;
+};
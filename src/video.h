@@ -0,0 +1,369 @@
+// ============================================================================
+// video.h — Frame encoding for the offscreen replay export
+// ============================================================================
+// The export renders frames on the render thread and must never wait for a
+// file write or an encoder; this file is everything after the pixels leave
+// the GPU:
+//
+//   GifWriter    → animated GIF89a with a fixed 6×7×6 colour cube, so a
+//                  pixel's palette index is a little arithmetic and a frame
+//                  is LZW coded in one pass (no per-frame palette search)
+//   FrameEncoder → a bounded queue of SLOTS frame buffers and an encoder
+//                  thread behind it. The producer takes a free buffer,
+//                  fills it and submits it together with how many video
+//                  frames it lasts; the encoder writes it as a GIF frame
+//                  (one frame with that delay) or pipes it that many times
+//                  to ffmpeg for any other extension. A full queue makes
+//                  Acquire() wait, which bounds memory however far ahead
+//                  the renderer gets.
+//
+// Frames are RGBA8, rows bottom-up as glReadPixels() returns them. A
+// program that pipes to ffmpeg must ignore SIGPIPE itself (signal dispositions
+// are process-wide), so that an ffmpeg that is missing or dies fails the
+// export instead of killing it.
+#pragma once
+
+#include "lockfree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// CLASS: GifWriter
+// ============================================================================
+class GifWriter {
+public:
+  GifWriter() = default;
+  ~GifWriter() { Close(); }
+  GifWriter(const GifWriter &) = delete;
+  GifWriter &operator=(const GifWriter &) = delete;
+
+  // Palette index of the cube colour nearest to (r, g, b).
+  static int Index(int r, int g, int b) {
+    return (r * 5 + 127) / 255 * 42 + (g * 6 + 127) / 255 * 6 +
+           (b * 5 + 127) / 255;
+  }
+
+  // ==========================================================================
+  // FUNCTION: Open
+  // ==========================================================================
+  // Write the header, the global colour table and the loop-forever block.
+  // Returns false if the file can't be created.
+  //
+  bool Open(const char *path, int width, int height) {
+    Close();
+    f = fopen(path, "wb");
+    if (!f)
+      return false;
+    w = width;
+    h = height;
+    indices.resize((size_t)w * h);
+
+    uint8_t head[13] = {'G', 'I', 'F', '8', '9', 'a'};
+    Put16(head + 6, w);
+    Put16(head + 8, h);
+    head[10] = 0xF7; // global table of 2^(7+1) colours, 8 bits per channel
+    fwrite(head, 1, sizeof(head), f);
+
+    uint8_t table[256 * 3] = {0};
+    for (int r = 0; r < 6; r++)
+      for (int g = 0; g < 7; g++)
+        for (int b = 0; b < 6; b++) {
+          uint8_t *c = table + 3 * (r * 42 + g * 6 + b);
+          c[0] = (uint8_t)(r * 255 / 5);
+          c[1] = (uint8_t)(g * 255 / 6);
+          c[2] = (uint8_t)(b * 255 / 5);
+        }
+    fwrite(table, 1, sizeof(table), f);
+
+    static const uint8_t loop[19] = {0x21, 0xFF, 11,  'N', 'E', 'T', 'S',
+                                     'C',  'A',  'P', 'E', '2', '.', '0',
+                                     3,    1,    0,   0,   0};
+    fwrite(loop, 1, sizeof(loop), f);
+    return !ferror(f);
+  }
+
+  // ==========================================================================
+  // FUNCTION: AddFrame
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // const uint8_t *rgba → w × h pixels, rows bottom-up
+  // int delayCs         → how long the frame shows, in 1/100 s
+  //
+  void AddFrame(const uint8_t *rgba, int delayCs) {
+    for (int y = 0; y < h; y++) {
+      const uint8_t *p = rgba + (size_t)(h - 1 - y) * w * 4;
+      uint8_t *out = &indices[(size_t)y * w];
+      for (int x = 0; x < w; x++, p += 4)
+        out[x] = (uint8_t)Index(p[0], p[1], p[2]);
+    }
+
+    uint8_t control[8] = {0x21, 0xF9, 4, 0x04}; // keep the frame underneath
+    Put16(control + 4, delayCs);
+    uint8_t image[11] = {0x2C};
+    Put16(image + 5, w);
+    Put16(image + 7, h);
+    image[10] = 8; // LZW minimum code size
+    fwrite(control, 1, sizeof(control), f);
+    fwrite(image, 1, sizeof(image), f);
+    Compress();
+  }
+
+  // Write the trailer. Returns false if any write failed.
+  bool Close() {
+    if (!f)
+      return true;
+    fputc(0x3B, f);
+    bool ok = !ferror(f);
+    ok = fclose(f) == 0 && ok;
+    f = nullptr;
+    return ok;
+  }
+
+private:
+  static constexpr int CLEAR = 256, END = 257, MAX_CODE = 4096;
+  static constexpr int HASH = 5003; // prime > MAX_CODE, as in compress(1)
+
+  static void Put16(uint8_t *at, int v) {
+    at[0] = (uint8_t)v;
+    at[1] = (uint8_t)(v >> 8);
+  }
+
+  // ---------------------------------------------------------------------------
+  // Compress: LZW-code `indices` into data sub-blocks.
+  // ---------------------------------------------------------------------------
+  // Dictionary entries (prefix code, next index) live in an open-addressed
+  // hash table that is cleared whenever the 12-bit code space runs out. The
+  // code width grows one code after the decoder's table reaches 2^width,
+  // because the decoder adds each entry one code later than the encoder.
+  void Compress() {
+    std::vector<int32_t> keys(HASH, -1);
+    std::vector<uint16_t> codes(HASH);
+    int width = 9, next = END + 1;
+    Emit(CLEAR, width);
+
+    int prefix = indices[0];
+    for (size_t i = 1; i < indices.size(); i++) {
+      int c = indices[i];
+      int32_t key = prefix << 8 | c;
+      int slot = (int)((uint32_t)key * 2654435761u % HASH);
+      while (keys[slot] >= 0 && keys[slot] != key)
+        slot = slot + 1 == HASH ? 0 : slot + 1;
+      if (keys[slot] == key) {
+        prefix = codes[slot];
+        continue;
+      }
+
+      if (next > (1 << width) && width < 12)
+        width++;
+      Emit(prefix, width);
+      if (next < MAX_CODE) {
+        keys[slot] = key;
+        codes[slot] = (uint16_t)next++;
+      } else {
+        Emit(CLEAR, width);
+        std::fill(keys.begin(), keys.end(), -1);
+        width = 9;
+        next = END + 1;
+      }
+      prefix = c;
+    }
+    if (next > (1 << width) && width < 12)
+      width++;
+    Emit(prefix, width);
+    Emit(END, width);
+    Flush();
+  }
+
+  void Emit(int code, int width) {
+    bits |= (uint32_t)code << nbits;
+    nbits += width;
+    while (nbits >= 8) {
+      Byte((uint8_t)bits);
+      bits >>= 8;
+      nbits -= 8;
+    }
+  }
+
+  void Byte(uint8_t b) {
+    block[++block[0]] = b;
+    if (block[0] == 255) {
+      fwrite(block, 1, 256, f);
+      block[0] = 0;
+    }
+  }
+
+  // Pad the last code to a byte, write the last sub-block and the
+  // terminator.
+  void Flush() {
+    if (nbits)
+      Byte((uint8_t)bits);
+    bits = 0;
+    nbits = 0;
+    if (block[0])
+      fwrite(block, 1, block[0] + 1, f);
+    block[0] = 0;
+    fputc(0, f);
+  }
+
+  FILE *f = nullptr;
+  int w = 0, h = 0;
+  std::vector<uint8_t> indices;
+  uint32_t bits = 0;
+  int nbits = 0;
+  uint8_t block[256] = {0}; // [0] = length of the sub-block being filled
+};
+
+// ============================================================================
+// CLASS: FrameEncoder
+// ============================================================================
+class FrameEncoder {
+public:
+  static constexpr int SLOTS = 4; // frames in flight between the threads
+
+  FrameEncoder() = default;
+  ~FrameEncoder() { Close(); }
+  FrameEncoder(const FrameEncoder &) = delete;
+  FrameEncoder &operator=(const FrameEncoder &) = delete;
+
+  // ==========================================================================
+  // FUNCTION: Open
+  // ==========================================================================
+  // ============= Input Parameters =============
+  // const char *path   → *.gif: written here; anything else: encoded by
+  //                      ffmpeg (which must be on the PATH)
+  // int width, height  → frame size
+  // int fps            → video frame rate that Submit() counts in
+  //
+  // ============= Return Value =============
+  // bool → false if the output can't be created.
+  //
+  // ============= Side Effects =============
+  // - Starts the encoder thread.
+  //
+  bool Open(const char *path, int width, int height, int fps) {
+    Close();
+    w = width;
+    h = height;
+    rate = fps;
+    size_t n = strlen(path);
+    if (n >= 4 && !strcmp(path + n - 4, ".gif")) {
+      if (!gif.Open(path, w, h))
+        return false;
+      isGif = true;
+    } else {
+      if (strchr(path, '\''))
+        return false; // would break the shell quoting below
+      char command[1024];
+      snprintf(command, sizeof(command),
+               "ffmpeg -loglevel error -y -f rawvideo -pix_fmt rgba -s %dx%d "
+               "-r %d -i - -vf vflip -pix_fmt yuv420p '%s'",
+               w, h, fps, path);
+      pipe = popen(command, "w");
+      if (!pipe)
+        return false;
+      isGif = false;
+    }
+
+    for (int i = 0; i < SLOTS; i++) {
+      buffers[i].assign((size_t)w * h * 4, 0);
+      free.Push(i);
+    }
+    failed = false;
+    stop.store(false);
+    waits = 0;
+    worker = std::thread([this] { Run(); });
+    return true;
+  }
+
+  // Producer: a free frame buffer, waiting while all SLOTS are queued.
+  uint8_t *Acquire() {
+    int i;
+    if (!free.Pop(i)) {
+      waits++;
+      while (!free.Pop(i))
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return buffers[i].data();
+  }
+
+  // Producer: queue a filled buffer from Acquire(), shown for `frames`
+  // video frames.
+  void Submit(uint8_t *buffer, int frames) {
+    int i = 0;
+    while (buffers[i].data() != buffer)
+      i++;
+    filled.Push(Frame{i, frames});
+  }
+
+  // Encode everything queued, stop the thread and finish the file.
+  // Returns false if any write failed.
+  bool Close() {
+    if (!worker.joinable())
+      return !failed;
+    stop.store(true);
+    worker.join();
+    if (isGif) {
+      failed |= !gif.Close();
+    } else {
+      failed |= pclose(pipe) != 0;
+      pipe = nullptr;
+    }
+    return !failed;
+  }
+
+  // How often Acquire() found the queue full (the encoder was the
+  // bottleneck).
+  uint64_t Waits() const { return waits; }
+
+private:
+  struct Frame {
+    int slot;
+    int frames;
+  };
+
+  // -------------------------------------------------------------------------
+  // Run: body of the encoder thread.
+  // -------------------------------------------------------------------------
+  void Run() {
+    for (;;) {
+      Frame fr;
+      if (!filled.Pop(fr)) {
+        if (!stop.load()) {
+          std::this_thread::sleep_for(std::chrono::microseconds(200));
+          continue;
+        }
+        if (!filled.Pop(fr))
+          return; // stop is set after the last Submit(): nothing is left
+      }
+      const uint8_t *pixels = buffers[fr.slot].data();
+      if (isGif) {
+        gif.AddFrame(pixels, (fr.frames * 100 + rate / 2) / rate);
+      } else {
+        size_t bytes = (size_t)w * h * 4;
+        for (int k = 0; k < fr.frames && !failed; k++)
+          failed |= fwrite(pixels, 1, bytes, pipe) != bytes;
+      }
+      free.Push(fr.slot);
+    }
+  }
+
+  int w = 0, h = 0, rate = 30;
+  bool isGif = true;
+  GifWriter gif;
+  FILE *pipe = nullptr;
+  bool failed = false; // written by the encoder thread until it is joined
+
+  std::vector<uint8_t> buffers[SLOTS];
+  SpscQueue<int, SLOTS> free;     // encoder → producer
+  SpscQueue<Frame, SLOTS> filled; // producer → encoder
+  std::atomic<bool> stop{false};
+  uint64_t waits = 0;
+  std::thread worker;
+};
@@ -0,0 +1,105 @@
+// ============================================================================
+// analysis_bench.cpp — Correctness and cost of the analysis overlay values
+// ============================================================================
+// Walks every position reachable in the 3×3 game and checks
+// Analyser::Analyse() against a plain, unmemoised minimax with the same
+// value convention (win / draw / loss and distance), cell by cell.
+//
+// Reports:
+//   cold → time for the first Analyse() of the empty board, which solves
+//          the whole game
+//   warm → average time per Analyse() over every reachable position once
+//          the table is filled (what a move, undo or replay costs)
+//
+// USAGE:
+//   analysis_bench
+//
+#include "../src/analysis.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// Reference: same convention, no memo, no symmetry.
+static int Minimax(Board &b) {
+  if (b.Over())
+    return b.Result() == RESULT_DRAW ? 0 : -ANALYSIS_WIN;
+  int best = -ANALYSIS_WIN - 1;
+  for (uint64_t m = b.Empty(); m; m &= m - 1) {
+    int c = __builtin_ctzll(m);
+    b.Make(c);
+    int v = -Minimax(b);
+    b.Unmake(c);
+    v = v > 0 ? v - 1 : v < 0 ? v + 1 : 0;
+    if (v > best)
+      best = v;
+  }
+  return best;
+}
+
+// Every distinct reachable position (by hash), game-over ones included.
+static void Collect(Board &b, std::vector<Board> &out,
+                    std::unordered_map<uint64_t, bool> &seen) {
+  if (!seen.emplace(b.hash, true).second)
+    return;
+  out.push_back(b);
+  if (b.Over())
+    return;
+  for (uint64_t m = b.Empty(); m; m &= m - 1) {
+    int c = __builtin_ctzll(m);
+    b.Make(c);
+    Collect(b, out, seen);
+    b.Unmake(c);
+  }
+}
+
+int main() {
+  std::vector<Board> positions;
+  std::unordered_map<uint64_t, bool> seen;
+  Board root;
+  Collect(root, positions, seen);
+
+  Analyser analyser;
+  int8_t values[9];
+  Clock::time_point t0 = Clock::now();
+  analyser.Analyse(root, values);
+  double cold =
+      std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+
+  uint64_t cells = 0;
+  for (const Board &p : positions) {
+    analyser.Analyse(p, values);
+    for (int c = 0; c < 9; c++) {
+      int expect = ANALYSIS_NONE;
+      if (!p.Over() && (p.Empty() >> c & 1)) {
+        Board b = p;
+        b.Make(c);
+        int v = -Minimax(b);
+        expect = v > 0 ? v - 1 : v < 0 ? v + 1 : 0;
+        cells++;
+      }
+      if (values[c] != expect) {
+        fprintf(stderr, "cell %d: analyser %d, minimax %d\n", c, values[c],
+                expect);
+        return 1;
+      }
+    }
+  }
+  printf("check  %zu positions, %llu cells: all match minimax\n",
+         positions.size(), (unsigned long long)cells);
+
+  const int ROUNDS = 20;
+  t0 = Clock::now();
+  for (int r = 0; r < ROUNDS; r++)
+    for (const Board &p : positions)
+      analyser.Analyse(p, values);
+  double warm =
+      std::chrono::duration<double, std::nano>(Clock::now() - t0).count() /
+      (ROUNDS * positions.size());
+  printf("cold   %.0f us to solve the game (%zu positions up to symmetry)\n",
+         cold, analyser.Cached());
+  printf("warm   %.0f ns per Analyse()\n", warm);
+  return 0;
+}
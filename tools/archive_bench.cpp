@@ -0,0 +1,164 @@
+// ============================================================================
+// archive_bench.cpp — Correctness and latency of the game archive streamer
+// ============================================================================
+// Writes --games random games to a scratch archive with ArchiveWriter, drops
+// the file from the page cache, then reads it back through ArchiveStreamer
+// the way the replay scene does:
+//
+//   stream → Seek(i) / Fetch(i) over every game in order, checking each one
+//            against the game that was written; counts how often the viewer
+//            would have had to wait
+//   flip   → one game per millisecond from a cold cache (far faster than
+//            key repeat): share of Fetch() calls answered at once
+//   jump   → Seek() to random games: time until Fetch() succeeds
+//
+// USAGE:
+//   archive_bench [--games N] [--size N] [--win K] [--out FILE]
+//
+#include "../src/archive.h"
+
+#include <chrono>
+#include <cstdlib>
+
+using Clock = std::chrono::steady_clock;
+
+// Random legal game number g (deterministic). Returns the result.
+static int RandomGame(uint64_t g, int size, int winLen, uint8_t *moves,
+                      int *plies) {
+  Board b(size, winLen);
+  uint64_t r = SplitMix64(g);
+  while (!b.Over()) {
+    uint64_t empty = b.Empty();
+    int n = __builtin_popcountll(empty);
+    r = SplitMix64(r);
+    for (int k = (int)(r % n); k > 0; k--)
+      empty &= empty - 1;
+    int c = __builtin_ctzll(empty);
+    moves[b.ply] = (uint8_t)c;
+    b.Make(c);
+  }
+  *plies = b.ply;
+  return b.Result();
+}
+
+static void Evict(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd >= 0) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+int main(int argc, char **argv) {
+  int games = 1000000, size = 3, winLen = 3;
+  const char *out = "/tmp/archive_bench.bin";
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--games"))
+      games = atoi(v);
+    else if (!strcmp(k, "--size"))
+      size = atoi(v);
+    else if (!strcmp(k, "--win"))
+      winLen = atoi(v);
+    else if (!strcmp(k, "--out"))
+      out = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (size < 3 || size > MAX_SIDE || winLen < 3 || winLen > size ||
+      games < 1) {
+    fprintf(stderr, "invalid options\n");
+    return 1;
+  }
+
+  // Write.
+  remove(out);
+  ArchiveWriter writer;
+  if (!writer.Open(out, size, winLen)) {
+    fprintf(stderr, "cannot create %s\n", out);
+    return 1;
+  }
+  Clock::time_point t0 = Clock::now();
+  uint8_t moves[MAX_CELLS];
+  int plies;
+  for (int g = 0; g < games; g++) {
+    int result = RandomGame(g, size, winLen, moves, &plies);
+    if (!writer.Append(moves, plies, result)) {
+      fprintf(stderr, "write failed at game %d\n", g);
+      return 1;
+    }
+  }
+  writer.Close();
+  double writeSecs = std::chrono::duration<double>(Clock::now() - t0).count();
+  printf("write   %d games, %d bytes each, in %.2f s\n", games,
+         ArchiveRecordSize(size), writeSecs);
+
+  // Stream every game in order.
+  Evict(out);
+  ArchiveStreamer streamer;
+  if (!streamer.Open(out) || streamer.Count() != (uint32_t)games) {
+    fprintf(stderr, "cannot reopen %s\n", out);
+    return 1;
+  }
+  ArchivedGame game;
+  uint64_t waits = 0;
+  t0 = Clock::now();
+  for (uint32_t i = 0; i < streamer.Count(); i++) {
+    streamer.Seek(i);
+    if (!streamer.Fetch(i, &game)) {
+      waits++;
+      while (!streamer.Fetch(i, &game))
+        std::this_thread::yield();
+    }
+    int result = RandomGame(i, size, winLen, moves, &plies);
+    if (!game.valid || game.plies != plies || game.result != result ||
+        memcmp(game.moves, moves, plies) != 0) {
+      fprintf(stderr, "game %u does not read back\n", i);
+      return 1;
+    }
+  }
+  double streamSecs = std::chrono::duration<double>(Clock::now() - t0).count();
+  printf("stream  %.0f games/s, all match; viewer waited on %llu of %d "
+         "(%llu reads)\n",
+         games / streamSecs, (unsigned long long)waits, games,
+         (unsigned long long)streamer.Reads());
+
+  // Flip one game per millisecond from a cold cache.
+  streamer.Close();
+  Evict(out);
+  streamer.Open(out);
+  uint32_t flips = streamer.Count() < 2000 ? streamer.Count() : 2000, ready = 0;
+  for (uint32_t i = 0; i < flips; i++) {
+    streamer.Seek(i);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ready += streamer.Fetch(i, &game);
+  }
+  printf("flip    %u games at 1 ms each: %.1f%% ready at once\n", flips,
+         100.0 * ready / flips);
+
+  // Random jumps.
+  const int JUMPS = 1000;
+  double total = 0, worst = 0;
+  uint64_t r = 42;
+  for (int j = 0; j < JUMPS; j++) {
+    r = SplitMix64(r);
+    uint32_t i = (uint32_t)(r % streamer.Count());
+    Clock::time_point t = Clock::now();
+    streamer.Seek(i);
+    while (!streamer.Fetch(i, &game))
+      std::this_thread::yield();
+    double us =
+        std::chrono::duration<double, std::micro>(Clock::now() - t).count();
+    total += us;
+    worst = us > worst ? us : worst;
+  }
+  printf("jump    %d random seeks: %.0f us average, %.0f us worst\n", JUMPS,
+         total / JUMPS, worst);
+
+  streamer.Close();
+  remove(out);
+  return 0;
+}
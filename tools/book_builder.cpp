@@ -0,0 +1,157 @@
+// ============================================================================
+// book_builder.cpp — Offline opening book generator
+// ============================================================================
+// Enumerates every canonical (symmetry-reduced) position up to a given ply,
+// searches each one deeply in parallel and writes the answers to a
+// perfect-hashed book file that AiPlayer memory-maps at startup.
+//
+// USAGE:
+//   book_builder [--size N] [--win K] [--ply P] [--depth D] [--time MS]
+//                [--threads T] [--out FILE]
+//
+//   --size    board side length (default 3)
+//   --win     stones in a row to win (default = size)
+//   --ply     book covers positions with fewer than P stones (default 4)
+//   --depth   maximum search depth per position (default 64)
+//   --time    time limit per position in milliseconds (default 2000)
+//   --threads threads searching in parallel, including the calling one
+//             (default: all hardware threads)
+//   --out     output path (default resources/book_<N>x<N>_k<K>.bin)
+//
+#include "../src/book.h"
+#include "../src/jobs.h"
+#include "../src/search.h"
+
+#include <cstdlib>
+#include <unordered_set>
+
+// ----------------------------------------------------------------------------
+// Book scores are int16: keep forced results recognisable by mapping them to
+// ±(32000 - plies to the end) and clamp heuristic scores below that range.
+// ----------------------------------------------------------------------------
+static int16_t BookScore(int s) {
+  if (s > SCORE_MATE_BOUND)
+    return (int16_t)(32000 - (SCORE_WIN - s));
+  if (s < -SCORE_MATE_BOUND)
+    return (int16_t)-(32000 - (SCORE_WIN + s));
+  return (int16_t)(s > 30000 ? 30000 : s < -30000 ? -30000 : s);
+}
+
+// ============================================================================
+// FUNCTION: EnumeratePositions
+// ============================================================================
+// Breadth-first walk from the empty board, keeping one representative per
+// canonical key. Terminal positions are dropped (nothing to play there).
+//
+static std::vector<Board> EnumeratePositions(int size, int winLen, int plies) {
+  std::vector<Board> all, level(1, Board(size, winLen));
+  std::unordered_set<uint64_t> seen;
+
+  for (int ply = 0; ply < plies && !level.empty(); ply++) {
+    std::vector<Board> next;
+    for (const Board &b : level) {
+      all.push_back(b);
+      for (uint64_t e = b.Empty(); e; e &= e - 1) {
+        Board c = b;
+        c.Make(__builtin_ctzll(e));
+        if (!c.Over() && seen.insert(c.CanonicalHash()).second)
+          next.push_back(c);
+      }
+    }
+    level.swap(next);
+  }
+  return all;
+}
+
+int main(int argc, char **argv) {
+  int size = 3, winLen = 0, plies = 4, threads = 0;
+  SearchLimits limits;
+  limits.timeMs = 2000.0;
+  const char *out = nullptr;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--size"))
+      size = atoi(v);
+    else if (!strcmp(k, "--win"))
+      winLen = atoi(v);
+    else if (!strcmp(k, "--ply"))
+      plies = atoi(v);
+    else if (!strcmp(k, "--depth"))
+      limits.maxDepth = atoi(v);
+    else if (!strcmp(k, "--time"))
+      limits.timeMs = atof(v);
+    else if (!strcmp(k, "--threads"))
+      threads = atoi(v);
+    else if (!strcmp(k, "--out"))
+      out = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (winLen <= 0)
+    winLen = size;
+  if (size < 1 || size > MAX_SIDE || winLen > size) {
+    fprintf(stderr, "invalid board shape %dx%d k=%d\n", size, size, winLen);
+    return 1;
+  }
+  if (threads <= 0)
+    threads = (int)std::thread::hardware_concurrency();
+  if (threads <= 0)
+    threads = 1;
+
+  char defaultPath[128];
+  BookPath(defaultPath, sizeof(defaultPath), size, winLen);
+  if (!out)
+    out = defaultPath;
+
+  std::vector<Board> positions = EnumeratePositions(size, winLen, plies);
+  std::vector<BookRecord> records(positions.size());
+  printf("%zu canonical positions, %d threads\n", positions.size(), threads);
+
+  // One searcher per job-system thread, created on first use; each position
+  // is its own job so idle workers steal the slow ones. The table is cleared
+  // before every position: which positions a thread searched earlier depends
+  // on the stealing, and a warm table would let that leak into the book.
+  JobSystem jobs(threads - 1);
+  std::vector<std::unique_ptr<Searcher>> searchers(jobs.Workers() + 1);
+  jobs.ParallelFor(0, positions.size(), 1, [&](size_t begin, size_t end) {
+    std::unique_ptr<Searcher> &searcher = searchers[jobs.ThreadIndex()];
+    if (!searcher)
+      searcher.reset(new Searcher(1 << 20));
+    for (size_t i = begin; i < end; i++) {
+      const Board &b = positions[i];
+      searcher->Table().Clear();
+      SearchResult r = searcher->Search(b, limits);
+
+      int sym;
+      BookRecord &rec = records[i];
+      rec.key = b.CanonicalHash(&sym);
+      rec.move = b.geo->sym[sym][r.move];
+      rec.depth = (uint8_t)r.depth;
+      rec.score = BookScore(r.score);
+    }
+  });
+
+  if (!WriteBook(out, size, winLen, records)) {
+    fprintf(stderr, "failed to write %s\n", out);
+    return 1;
+  }
+
+  // Sanity pass: every position must probe back to a legal move.
+  Book book;
+  if (!book.Open(out, size, winLen)) {
+    fprintf(stderr, "failed to reopen %s\n", out);
+    return 1;
+  }
+  for (const Board &b : positions) {
+    int m;
+    if (!book.Probe(b, &m)) {
+      fprintf(stderr, "book probe failed after writing\n");
+      return 1;
+    }
+  }
+  printf("wrote %u entries to %s\n", book.Size(), out);
+  return 0;
+}
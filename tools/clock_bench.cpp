@@ -0,0 +1,141 @@
+// ============================================================================
+// clock_bench.cpp — Drift and input-to-charge error of the game clocks
+// ============================================================================
+// Runs a real-time imitation of the game's two loops for --seconds: a 60 Hz
+// render frame that polls input, with one frame in --drop stalling for
+// 50-250 ms, and a logic step behind it that now and then takes 80 ms (an AI
+// search). Clicks come at random moments and alternate between the sides.
+//
+//   drift  → a clock left running for the whole run, read at the end three
+//            ways: counting frames (1/60 s each), summing frame times clamped
+//            at 100 ms (what frame-driven countdowns usually do), and
+//            GameClock::Remaining(), against the real elapsed time
+//   charge → the same game timed by two GameClocks, one pressed at the poll
+//            that delivered each click (what the game does), one at the end
+//            of the logic step that handled it: time charged beyond the
+//            physical click, average and worst per move
+//   ledger → both sides' charged time must add up to the game's duration to
+//            the nanosecond
+//
+// USAGE:
+//   clock_bench [--seconds S] [--drop N]
+//
+#include "../src/board.h"
+#include "../src/clock.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static void SleepNs(int64_t ns) {
+  std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+}
+
+int main(int argc, char **argv) {
+  double seconds = 5.0;
+  int drop = 10;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--seconds"))
+      seconds = atof(v);
+    else if (!strcmp(k, "--drop"))
+      drop = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (seconds <= 0 || drop < 1) {
+    fprintf(stderr, "invalid options\n");
+    return 1;
+  }
+
+  const int64_t BASE = 600 * NS_PER_SECOND, FRAME = NS_PER_SECOND / 60;
+  const int64_t length = (int64_t)(seconds * NS_PER_SECOND);
+  uint64_t r = 7;
+
+  // Click times, 150-650 ms apart.
+  int64_t t0 = MonotonicNs();
+  std::vector<int64_t> clicks;
+  for (int64_t t = t0; t < t0 + length;) {
+    r = SplitMix64(r);
+    t += 150 * NS_PER_MS + (int64_t)(r % (500 * NS_PER_MS));
+    clicks.push_back(t);
+  }
+
+  GameClock running, atPoll, atStep;
+  running.Reset(BASE, 0);
+  running.Start(0, t0);
+  atPoll.Reset(BASE, 2 * NS_PER_SECOND);
+  atPoll.Start(0, t0);
+  atStep = atPoll;
+
+  int64_t frames = 0, clampedSum = 0, last = t0, now = t0;
+  int64_t pollLate = 0, pollWorst = 0, stepLate = 0, stepWorst = 0;
+  size_t next = 0, moves = 0;
+  int drops = 0;
+  while (now - t0 < length) {
+    // Poll: clicks since the last poll arrive, stamped now.
+    int64_t polled = MonotonicNs();
+    size_t first = next;
+    while (next < clicks.size() && clicks[next] <= polled)
+      next++;
+    for (size_t i = first; i < next; i++)
+      atPoll.Press(polled);
+
+    // Logic step, sometimes slow; it handles the clicks afterwards.
+    r = SplitMix64(r);
+    SleepNs(r % 20 == 0 ? 80 * NS_PER_MS : 2 * NS_PER_MS);
+    int64_t handled = MonotonicNs();
+    for (size_t i = first; i < next; i++) {
+      atStep.Press(handled);
+      int64_t a = polled - clicks[i], b = handled - clicks[i];
+      pollLate += a;
+      stepLate += b;
+      pollWorst = a > pollWorst ? a : pollWorst;
+      stepWorst = b > stepWorst ? b : stepWorst;
+      moves++;
+    }
+
+    // Rest of the frame, sometimes dropped.
+    r = SplitMix64(r);
+    bool stall = (r >> 32) % drop == 0;
+    drops += stall;
+    int64_t spent = MonotonicNs() - polled;
+    int64_t frame = stall ? 50 * NS_PER_MS + (int64_t)(r % (200 * NS_PER_MS))
+                          : FRAME;
+    if (spent < frame)
+      SleepNs(frame - spent);
+
+    now = MonotonicNs();
+    frames++;
+    int64_t dt = now - last;
+    clampedSum += dt < 100 * NS_PER_MS ? dt : 100 * NS_PER_MS;
+    last = now;
+  }
+
+  double ms = 1.0 / NS_PER_MS;
+  int64_t truth = BASE - (now - t0);
+  int64_t counted = BASE - frames * FRAME;
+  int64_t clamped = BASE - clampedSum;
+  printf("run     %.1f s, %lld frames, %d dropped, %zu moves\n",
+         (now - t0) * 1e-9, (long long)frames, drops, moves);
+  printf("drift   frame count %+.1f ms, clamped frame time %+.1f ms, "
+         "GameClock %+.3f ms\n",
+         (counted - truth) * ms, (clamped - truth) * ms,
+         (running.Remaining(0, now) - truth) * ms);
+  if (moves)
+    printf("charge  beyond the click: at poll %.1f ms avg / %.1f worst, "
+           "at logic step %.1f ms avg / %.1f worst\n",
+           pollLate * ms / moves, pollWorst * ms, stepLate * ms / moves,
+           stepWorst * ms);
+
+  int64_t end = MonotonicNs();
+  atPoll.Stop(end);
+  int64_t error = (end - atPoll.Started()) - atPoll.Used(0) - atPoll.Used(1);
+  printf("ledger  X %.3f s + O %.3f s charged, %lld ns unaccounted\n",
+         atPoll.Used(0) * 1e-9, atPoll.Used(1) * 1e-9, (long long)error);
+  return error == 0 && running.Remaining(0, now) == truth ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+// ============================================================================
+// engine.cpp — The built-in engine as a standalone TTTP process
+// ============================================================================
+// Speaks the protocol described in src/protocol.h on stdin/stdout, so our own
+// engine can be run by the tournament runner (or by the game with --engine)
+// exactly like a third-party one.
+//
+// USAGE:
+//   engine [--threads T] [--hash ENTRIES]
+//
+// Searches run on a worker thread so "stop" and "isready" are answered while
+// searching. Output lines are written under a mutex.
+#include "../src/book.h"
+#include "../src/protocol.h"
+#include "../src/search.h"
+
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+static std::mutex outputLock;
+
+static void Reply(const std::string &line) {
+  std::lock_guard<std::mutex> guard(outputLock);
+  fwrite(line.data(), 1, line.size(), stdout);
+  fputc('\n', stdout);
+  fflush(stdout);
+}
+
+// ----------------------------------------------------------------------------
+// Time budget for clock-based "go": spread the remaining time over the moves
+// we still expect to play and add most of the increment.
+// ----------------------------------------------------------------------------
+static double Budget(const Board &b, double remaining, double inc) {
+  int ourMovesLeft = (__builtin_popcountll(b.Empty()) + 1) / 2;
+  double ms = remaining / (ourMovesLeft > 4 ? ourMovesLeft : 4) + inc * 0.8;
+  if (ms > remaining * 0.5)
+    ms = remaining * 0.5;
+  return ms > 1 ? ms : 1;
+}
+
+int main(int argc, char **argv) {
+  int threads = 1;
+  size_t hash = 1 << 20;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--threads"))
+      threads = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--hash"))
+      hash = (size_t)atoll(argv[i + 1]);
+  }
+
+  Searcher searcher(hash, threads);
+  Book book;
+  int size = 3, winLen = 3;
+  Board position(size, winLen);
+  std::thread worker;
+
+  auto finishSearch = [&] {
+    if (worker.joinable())
+      worker.join();
+  };
+
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    std::vector<std::string> t = SplitTokens(line);
+    if (t.empty())
+      continue;
+    const std::string &cmd = t[0];
+
+    if (cmd == "ttt") {
+      Reply("id name TicTacToe-raylib");
+      Reply("id author TicTacToe-raylib contributors");
+      Reply("tttok");
+    } else if (cmd == "isready") {
+      Reply("readyok");
+    } else if (cmd == "newgame" && t.size() >= 3) {
+      finishSearch();
+      int s = atoi(t[1].c_str()), k = atoi(t[2].c_str());
+      if (s >= 1 && s <= MAX_SIDE && k >= 1 && k <= s) {
+        if (s != size || k != winLen)
+          searcher.Table().Clear(); // keep the table across same-shape games
+        size = s;
+        winLen = k;
+        char path[128];
+        BookPath(path, sizeof(path), size, winLen);
+        book.Open(path, size, winLen);
+      }
+      position = Board(size, winLen);
+    } else if (cmd == "position") {
+      finishSearch();
+      Board b;
+      if (ParsePosition(t, size, winLen, b))
+        position = b;
+    } else if (cmd == "go") {
+      finishSearch();
+      SearchLimits limits;
+      double xtime = -1, otime = -1, xinc = 0, oinc = 0;
+      for (size_t i = 1; i + 1 < t.size(); i += 2) {
+        double v = atof(t[i + 1].c_str());
+        if (t[i] == "movetime")
+          limits.timeMs = v;
+        else if (t[i] == "xtime")
+          xtime = v;
+        else if (t[i] == "otime")
+          otime = v;
+        else if (t[i] == "xinc")
+          xinc = v;
+        else if (t[i] == "oinc")
+          oinc = v;
+        else if (t[i] == "depth")
+          limits.maxDepth = (int)v;
+      }
+      double ours = position.side == 0 ? xtime : otime;
+      if (ours >= 0)
+        limits.timeMs = Budget(position, ours, position.side == 0 ? xinc : oinc);
+
+      int bookMove;
+      if (book.Probe(position, &bookMove)) {
+        Reply("bestmove " + std::to_string(bookMove));
+        continue;
+      }
+
+      searcher.ClearStop();
+      Board root = position;
+      worker = std::thread([&searcher, root, limits] {
+        SearchResult r = searcher.Search(root, limits);
+        char info[128];
+        snprintf(info, sizeof(info), "info depth %d score %d nodes %llu",
+                 r.depth, r.score, (unsigned long long)r.nodes);
+        Reply(info);
+        Reply("bestmove " + std::to_string(r.move));
+      });
+    } else if (cmd == "stop") {
+      searcher.Stop();
+      finishSearch();
+    } else if (cmd == "quit") {
+      break;
+    }
+  }
+
+  searcher.Stop();
+  finishSearch();
+  return 0;
+}
@@ -0,0 +1,213 @@
+// ============================================================================
+// export_bench.cpp — Correctness and speed of the replay export encoder
+// ============================================================================
+// Pushes --frames synthetic 300×400 frames (flat colours and moving
+// squares like a replay, with every eighth frame pure noise so the LZW code
+// table fills and resets) through FrameEncoder into a GIF, then decodes the
+// file with a separate, straightforward GIF decoder and checks every pixel
+// against GifWriter::Index() of the source frame and every frame delay.
+//
+// Reports encoded frames per second and how often the producer found the
+// bounded queue full. The replay export renders far faster than this, so
+// the encoder rate is what an export runs at.
+//
+// USAGE:
+//   export_bench [--frames N] [--out FILE]
+//
+#include "../src/video.h"
+
+#include <csignal>
+#include <cstdlib>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int W = 300, H = 400, FPS = 30;
+
+// Frame k, rows bottom-up like glReadPixels().
+static void MakeFrame(int k, uint8_t *rgba) {
+  uint64_t r = 0x9E3779B97F4A7C15ull * (k + 1);
+  for (int y = 0; y < H; y++)
+    for (int x = 0; x < W; x++) {
+      uint8_t *p = rgba + ((size_t)(H - 1 - y) * W + x) * 4;
+      if (k % 8 == 7) {
+        r = r * 6364136223846793005ull + 1442695040888963407ull;
+        p[0] = (uint8_t)(r >> 56);
+        p[1] = (uint8_t)(r >> 48);
+        p[2] = (uint8_t)(r >> 40);
+      } else {
+        bool square = (x / 40 + y / 40 + k) % 5 == 0;
+        p[0] = square ? 200 : 245;
+        p[1] = square ? 30 : 245;
+        p[2] = (uint8_t)(y * 255 / H);
+      }
+      p[3] = 255;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Reference decoder: frame delays and index images of a GIF written by
+// GifWriter (global table, full-size frames, no interlace).
+// ----------------------------------------------------------------------------
+struct Decoded {
+  std::vector<int> delays;
+  std::vector<std::vector<uint8_t>> frames;
+};
+
+static bool Lzw(const std::vector<uint8_t> &data, int minSize,
+                std::vector<uint8_t> &out) {
+  int clear = 1 << minSize, end = clear + 1;
+  std::vector<int> prefix(4096), length(4096);
+  std::vector<uint8_t> suffix(4096), first(4096);
+  for (int i = 0; i < clear; i++) {
+    prefix[i] = -1;
+    suffix[i] = first[i] = (uint8_t)i;
+    length[i] = 1;
+  }
+  int width = minSize + 1, avail = end + 1, old = -1;
+  size_t bitPos = 0;
+  for (;;) {
+    if (bitPos + width > data.size() * 8)
+      return false;
+    int code = 0;
+    for (int b = 0; b < width; b++, bitPos++)
+      code |= (data[bitPos / 8] >> (bitPos % 8) & 1) << b;
+    if (code == clear) {
+      width = minSize + 1;
+      avail = end + 1;
+      old = -1;
+      continue;
+    }
+    if (code == end)
+      return true;
+    if (code > avail || (code == avail && old < 0))
+      return false;
+    if (old >= 0 && avail < 4096) {
+      prefix[avail] = old;
+      suffix[avail] = first[code == avail ? old : code];
+      first[avail] = first[old];
+      length[avail] = length[old] + 1;
+      avail++;
+      if (avail == 1 << width && width < 12)
+        width++;
+    }
+    size_t at = out.size();
+    out.resize(at + length[code]);
+    for (int c = code, i = length[code] - 1; c >= 0; c = prefix[c], i--)
+      out[at + i] = suffix[c];
+    old = code;
+  }
+}
+
+static bool Decode(const char *path, Decoded &d) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  std::vector<uint8_t> file;
+  for (int c; (c = fgetc(f)) != EOF;)
+    file.push_back((uint8_t)c);
+  fclose(f);
+
+  size_t at = 13 + 256 * 3;
+  if (file.size() < at || memcmp(file.data(), "GIF89a", 6) != 0)
+    return false;
+  int delay = 0;
+  while (at < file.size()) {
+    uint8_t tag = file[at++];
+    if (tag == 0x3B)
+      return true;
+    if (tag == 0x21) {
+      uint8_t label = file[at++];
+      if (label == 0xF9)
+        delay = file[at + 2] | file[at + 3] << 8;
+      while (file[at])
+        at += file[at] + 1;
+      at++;
+    } else if (tag == 0x2C) {
+      at += 9;
+      int minSize = file[at++];
+      std::vector<uint8_t> data;
+      while (file[at]) {
+        data.insert(data.end(), &file[at + 1], &file[at + 1] + file[at]);
+        at += file[at] + 1;
+      }
+      at++;
+      d.frames.emplace_back();
+      if (!Lzw(data, minSize, d.frames.back()))
+        return false;
+      d.delays.push_back(delay);
+    } else {
+      return false;
+    }
+  }
+  return false;
+}
+
+int main(int argc, char **argv) {
+  int frames = 240;
+  const char *out = "/tmp/export_bench.gif";
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--frames"))
+      frames = atoi(v);
+    else if (!strcmp(k, "--out"))
+      out = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+
+  // Frames are made up front so the timing is the encoder's alone.
+  std::vector<std::vector<uint8_t>> source(16);
+  for (int k = 0; k < (int)source.size(); k++) {
+    source[k].resize((size_t)W * H * 4);
+    MakeFrame(k, source[k].data());
+  }
+  auto Hold = [](int k) { return 1 + k % 3 * 7; }; // 1, 8 or 15 frames
+
+  signal(SIGPIPE, SIG_IGN); // a failing ffmpeg fails the run instead
+  FrameEncoder encoder;
+  if (!encoder.Open(out, W, H, FPS)) {
+    fprintf(stderr, "cannot create %s\n", out);
+    return 1;
+  }
+  Clock::time_point t0 = Clock::now();
+  for (int k = 0; k < frames; k++) {
+    uint8_t *buffer = encoder.Acquire();
+    memcpy(buffer, source[k % source.size()].data(), (size_t)W * H * 4);
+    encoder.Submit(buffer, Hold(k));
+  }
+  if (!encoder.Close()) {
+    fprintf(stderr, "writing %s failed\n", out);
+    return 1;
+  }
+  double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  printf("encode  %d frames in %.2f s: %.0f frames/s, queue full %llu times\n",
+         frames, secs, frames / secs, (unsigned long long)encoder.Waits());
+
+  Decoded d;
+  if (!Decode(out, d) || (int)d.frames.size() != frames) {
+    fprintf(stderr, "%s does not decode\n", out);
+    return 1;
+  }
+  for (int k = 0; k < frames; k++) {
+    const uint8_t *src = source[k % source.size()].data();
+    if (d.delays[k] != (Hold(k) * 100 + FPS / 2) / FPS ||
+        d.frames[k].size() != (size_t)W * H) {
+      fprintf(stderr, "frame %d: wrong delay or size\n", k);
+      return 1;
+    }
+    for (int y = 0; y < H; y++)
+      for (int x = 0; x < W; x++) {
+        const uint8_t *p = src + ((size_t)(H - 1 - y) * W + x) * 4;
+        if (d.frames[k][(size_t)y * W + x] !=
+            GifWriter::Index(p[0], p[1], p[2])) {
+          fprintf(stderr, "frame %d: pixel %d,%d differs\n", k, x, y);
+          return 1;
+        }
+      }
+  }
+  printf("check   %d frames decode back pixel for pixel\n", frames);
+  remove(out);
+  return 0;
+}
@@ -0,0 +1,221 @@
+// ============================================================================
+// gravity_bench.cpp — Correctness and speed of the 7×6 gravity solver
+// ============================================================================
+// Three passes over positions reached by random play:
+//
+//   rules  → GravityBoard::Result() against a cell-by-cell four-in-a-row
+//            scan after every move of --games random games
+//   solver → GravitySolver::Solve() against a plain alpha-beta search on
+//            the array board, for --verify positions with 10 or fewer
+//            empty cells (exact scores must match)
+//   speed  → time and nodes to solve --positions positions after 12, 16,
+//            20 and 24 stones, each with a cold transposition table, and
+//            how many of them the game's per-move budget (--budget) solves
+//
+// USAGE:
+//   gravity_bench [--games N] [--verify N] [--positions N] [--budget NODES]
+//
+#include "../src/gravity.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t rng = 0x243F6A8885A308D3ull;
+static int Random(int n) { return (int)((rng = SplitMix64(rng)) % n); }
+
+// ----------------------------------------------------------------------------
+// Reference board: grid[col][row], row 0 at the bottom.
+// ----------------------------------------------------------------------------
+struct Grid {
+  int cell[GravityBoard::WIDTH][GravityBoard::HEIGHT] = {};
+  int height[GravityBoard::WIDTH] = {};
+  int moves = 0;
+
+  bool Wins(int col, int row, int p) const {
+    static const int DIRS[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+    for (const auto &d : DIRS) {
+      int n = 1;
+      for (int s = -1; s <= 1; s += 2)
+        for (int k = 1; k < 4; k++) {
+          int c = col + s * k * d[0], r = row + s * k * d[1];
+          if (c < 0 || c >= GravityBoard::WIDTH || r < 0 ||
+              r >= GravityBoard::HEIGHT || cell[c][r] != p)
+            break;
+          n++;
+        }
+      if (n >= 4)
+        return true;
+    }
+    return false;
+  }
+};
+
+// Exact score by full-window alpha-beta, same convention as the solver.
+static int Reference(Grid &g, int alpha, int beta) {
+  int p = g.moves & 1 ? RESULT_O : RESULT_X;
+  for (int c = 0; c < GravityBoard::WIDTH; c++)
+    if (g.height[c] < GravityBoard::HEIGHT && g.Wins(c, g.height[c], p))
+      return (GravityBoard::CELLS + 1 - g.moves) / 2;
+  if (g.moves == GravityBoard::CELLS)
+    return 0;
+
+  int best = -GravityBoard::CELLS;
+  for (int c = 0; c < GravityBoard::WIDTH; c++) {
+    if (g.height[c] == GravityBoard::HEIGHT)
+      continue;
+    g.cell[c][g.height[c]++] = p;
+    g.moves++;
+    int s = -Reference(g, -beta, -alpha);
+    g.moves--;
+    g.cell[c][--g.height[c]] = 0;
+    if (s > best)
+      best = s;
+    if (s > alpha)
+      alpha = s;
+    if (alpha >= beta)
+      break;
+  }
+  return best;
+}
+
+// Random game of `stones` moves that nobody has won and where the side to
+// move can't win at once. Returns false if this attempt ran into a result.
+static bool RandomPosition(int stones, GravityBoard &b, Grid &g) {
+  b = GravityBoard();
+  g = Grid();
+  for (int i = 0; i < stones; i++) {
+    int col;
+    do
+      col = Random(GravityBoard::WIDTH);
+    while (!b.CanPlay(col));
+    g.cell[col][g.height[col]++] = b.SideToMove();
+    g.moves++;
+    b.Play(col);
+    if (b.Result() != RESULT_NONE)
+      return false;
+  }
+  for (int c = 0; c < GravityBoard::WIDTH; c++)
+    if (b.CanPlay(c) && b.IsWinningMove(c))
+      return false;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  int games = 100000, verify = 300, positions = 40;
+  uint64_t budget = 100000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--games"))
+      games = atoi(v);
+    else if (!strcmp(k, "--verify"))
+      verify = atoi(v);
+    else if (!strcmp(k, "--positions"))
+      positions = atoi(v);
+    else if (!strcmp(k, "--budget"))
+      budget = strtoull(v, nullptr, 10);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+
+  // --------------------------------------------------------------------------
+  // rules
+  // --------------------------------------------------------------------------
+  uint64_t moves = 0, wins = 0;
+  for (int n = 0; n < games; n++) {
+    GravityBoard b;
+    Grid g;
+    for (;;) {
+      int col;
+      do
+        col = Random(GravityBoard::WIDTH);
+      while (!b.CanPlay(col));
+      int p = b.SideToMove(), row = g.height[col];
+      bool won = g.Wins(col, row, p);
+      if (b.IsWinningMove(col) != won || b.Height(col) != row) {
+        fprintf(stderr, "rules mismatch in game %d\n", n);
+        return 1;
+      }
+      g.cell[col][g.height[col]++] = p;
+      g.moves++;
+      b.Play(col);
+      moves++;
+      int expect = RESULT_NONE;
+      if (won)
+        expect = p;
+      else if (g.moves == GravityBoard::CELLS)
+        expect = RESULT_DRAW;
+      if (b.Result() != expect || b.Cell(col, row) != p) {
+        fprintf(stderr, "result mismatch in game %d\n", n);
+        return 1;
+      }
+      if (expect != RESULT_NONE) {
+        wins += expect != RESULT_DRAW;
+        break;
+      }
+    }
+  }
+  printf("rules   %d games, %llu moves, %llu wins: all match\n", games,
+         (unsigned long long)moves, (unsigned long long)wins);
+
+  // --------------------------------------------------------------------------
+  // solver
+  // --------------------------------------------------------------------------
+  GravitySolver solver;
+  int checked = 0;
+  while (checked < verify) {
+    GravityBoard b;
+    Grid g;
+    if (!RandomPosition(GravityBoard::CELLS - 10 + Random(4), b, g))
+      continue;
+    int s, r = Reference(g, -GravityBoard::CELLS, GravityBoard::CELLS);
+    if (!solver.Solve(b, &s) || s != r) {
+      fprintf(stderr, "solver says %d, reference %d\n", s, r);
+      return 1;
+    }
+    checked++;
+  }
+  printf("solver  %d late positions: scores match the reference\n", checked);
+
+  // --------------------------------------------------------------------------
+  // speed
+  // --------------------------------------------------------------------------
+  printf("speed   cold table, %d positions per row, budget %llu nodes\n",
+         positions, (unsigned long long)budget);
+  for (int stones : {12, 16, 20, 24}) {
+    double total = 0, worst = 0;
+    uint64_t nodes = 0;
+    int inBudget = 0;
+    for (int n = 0; n < positions;) {
+      GravityBoard b;
+      Grid g;
+      if (!RandomPosition(stones, b, g))
+        continue;
+      n++;
+
+      GravitySolver cold;
+      uint64_t before = cold.Nodes();
+      Clock::time_point t0 = Clock::now();
+      int s;
+      cold.Solve(b, &s);
+      double ms =
+          std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+      total += ms;
+      worst = ms > worst ? ms : worst;
+      nodes += cold.Nodes() - before;
+
+      GravitySolver game;
+      inBudget += game.BestMove(b, budget).solved;
+    }
+    printf("  %2d stones  %9.2f ms avg  %9.2f ms max  %11.0f nodes avg  "
+           "%3d/%d within budget\n",
+           stones, total / positions, worst, (double)nodes / positions,
+           inBudget, positions);
+  }
+  return 0;
+}
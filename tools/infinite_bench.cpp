@@ -0,0 +1,143 @@
+// ============================================================================
+// infinite_bench.cpp — Correctness and cost of the sparse infinite board
+// ============================================================================
+// Plays random stones in clusters scattered over a huge area (coordinates
+// up to ±--spread, negative ones included, so chunk edges and the sign
+// boundary are crossed constantly) and checks every Place() result against
+// a brute-force line count over a plain std::map.
+//
+// Reports:
+//   place → ns per Place() (including the win check)
+//   view  → ns per ForEachStone() over a 10×10 viewport, and how many
+//           stones it returned on average
+//   chunks per stone, to show memory follows stones, not extent
+//
+// USAGE:
+//   infinite_bench [--stones N] [--spread S] [--win K]
+//
+#include "../src/infinite.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double NsSince(Clock::time_point t0) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// Reference: longest run through (x, y) counted cell by cell.
+static bool NaiveWins(const std::map<std::pair<int, int>, int> &cells, int x,
+                      int y, int player, int win) {
+  static const int DIRS[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+  for (const auto &d : DIRS) {
+    int run = 1;
+    for (int s = -1; s <= 1; s += 2)
+      for (int i = 1;; i++) {
+        auto it = cells.find({x + s * i * d[0], y + s * i * d[1]});
+        if (it == cells.end() || it->second != player)
+          break;
+        run++;
+      }
+    if (run >= win)
+      return true;
+  }
+  return false;
+}
+
+int main(int argc, char **argv) {
+  int stones = 200000, spread = 1 << 28, win = 5;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--stones"))
+      stones = atoi(v);
+    else if (!strcmp(k, "--spread"))
+      spread = atoi(v);
+    else if (!strcmp(k, "--win"))
+      win = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+
+  // Stones land near cluster centres (13×13 areas, about a quarter filled),
+  // like real play that wanders around the plane.
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<int> far(-spread, spread), near(-6, 6);
+  std::vector<std::pair<int, int>> centres(stones / 40 + 1);
+  for (auto &c : centres)
+    c = {far(rng), far(rng)};
+
+  std::vector<std::pair<int, int>> moves;
+  std::map<std::pair<int, int>, int> reference;
+  while ((int)moves.size() < stones) {
+    const auto &c = centres[rng() % centres.size()];
+    std::pair<int, int> m{c.first + near(rng), c.second + near(rng)};
+    if (reference.emplace(m, 1 + (int)(moves.size() & 1)).second)
+      moves.push_back(m);
+  }
+
+  // Correctness pass against the reference.
+  {
+    InfiniteBoard board(win);
+    std::map<std::pair<int, int>, int> cells;
+    int wins = 0;
+    for (size_t i = 0; i < moves.size(); i++) {
+      int player = 1 + (int)(i & 1);
+      auto [x, y] = moves[i];
+      cells[{x, y}] = player;
+      bool got = board.Place(x, y, player);
+      if (got != NaiveWins(cells, x, y, player, win)) {
+        fprintf(stderr, "mismatch at move %zu (%d, %d)\n", i, x, y);
+        return 1;
+      }
+      if (board.Get(x, y) != player) {
+        fprintf(stderr, "Get mismatch at (%d, %d)\n", x, y);
+        return 1;
+      }
+      wins += got;
+    }
+    for (size_t i = moves.size(); i-- > 0;)
+      board.Remove(moves[i].first, moves[i].second);
+    if (board.Stones() || board.Chunks()) {
+      fprintf(stderr, "Remove left %zu stones in %zu chunks\n", board.Stones(),
+              board.Chunks());
+      return 1;
+    }
+    printf("%d stones over ±%d, win %d: %d winning placements verified\n",
+           stones, spread, win, wins);
+  }
+
+  // Timing pass.
+  InfiniteBoard board(win);
+  Clock::time_point t0 = Clock::now();
+  int wins = 0;
+  for (size_t i = 0; i < moves.size(); i++)
+    wins += board.Place(moves[i].first, moves[i].second, 1 + (int)(i & 1));
+  double placeNs = NsSince(t0) / (double)moves.size();
+
+  const int views = 100000;
+  long found = 0;
+  t0 = Clock::now();
+  for (int i = 0; i < views; i++) {
+    const auto &c = centres[i % centres.size()];
+    board.ForEachStone(c.first - 5, c.second - 5, c.first + 4, c.second + 4,
+                       [&](int, int, int) { found++; });
+  }
+  double viewNs = NsSince(t0) / views;
+
+  printf("  place  %8.1f ns/stone (%d wins)\n", placeNs, wins);
+  printf("  view   %8.1f ns per 10x10 viewport, %.1f stones each\n", viewNs,
+         (double)found / views);
+  printf("  memory %zu chunks for %zu stones (%.3f chunks/stone)\n",
+         board.Chunks(), board.Stones(),
+         (double)board.Chunks() / (double)board.Stones());
+  return 0;
+}
@@ -0,0 +1,177 @@
+// ============================================================================
+// jobs_bench.cpp — Spawn / steal overhead of the job system
+// ============================================================================
+// For each worker count W in 0, 1, 2, 4, ... up to --threads:
+//
+//   spawn     → ns per empty job created, queued and run as children of one
+//               root, spawned from inside a worker in batches
+//   fork/join → ns per job of a recursive binary fork/join tree of --depth
+//               levels (every job forks two children and waits), plus how
+//               many jobs were stolen
+//   parfor    → ns per item of a ParallelFor over --items tiny items
+//
+// Then, once with all workers busy on background work:
+//
+//   priority  → delay before a freshly submitted JOB_HIGH job starts,
+//               compared to a JOB_NORMAL job submitted the same way
+//
+// A std::thread create+join per task is printed as the baseline that the job
+// system replaces.
+//
+// USAGE:
+//   jobs_bench [--threads T] [--jobs N] [--depth D] [--items N]
+//
+#include "../src/jobs.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+static double NsSince(Clock::time_point t0) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// Spin for about `us` microseconds (stand-in for real background work).
+static void BusyWork(double us) {
+  Clock::time_point t0 = Clock::now();
+  while (NsSince(t0) < us * 1000.0) {
+  }
+}
+
+// Run `f` as one job inside the pool so nested spawns use a worker's deque.
+template <typename F> static void RunInPool(JobSystem &jobs, F f) {
+  Job *job = jobs.Create(f);
+  jobs.Run(job);
+  jobs.Wait(job);
+}
+
+static void Fork(JobSystem &jobs, int depth) {
+  if (depth == 0)
+    return;
+  Job *root = jobs.Create([] {});
+  jobs.Run(jobs.CreateChild(root, [&jobs, depth] { Fork(jobs, depth - 1); }));
+  jobs.Run(jobs.CreateChild(root, [&jobs, depth] { Fork(jobs, depth - 1); }));
+  jobs.Run(root);
+  jobs.Wait(root);
+}
+
+int main(int argc, char **argv) {
+  int maxThreads = 0, depth = 14;
+  long count = 1 << 18;
+  size_t items = 1 << 22;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--threads"))
+      maxThreads = atoi(v);
+    else if (!strcmp(k, "--jobs"))
+      count = atol(v);
+    else if (!strcmp(k, "--depth"))
+      depth = atoi(v);
+    else if (!strcmp(k, "--items"))
+      items = (size_t)atoll(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (maxThreads <= 0)
+    maxThreads = (int)std::thread::hardware_concurrency();
+  if (maxThreads <= 0)
+    maxThreads = 1;
+
+  printf("%u hw threads, %ld spawns, fork depth %d, %zu parfor items\n",
+         std::thread::hardware_concurrency(), count, depth, items);
+
+  // Baseline: one OS thread per task.
+  {
+    const int n = 2000;
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < n; i++)
+      std::thread([] {}).join();
+    printf("  std::thread create+join     %9.0f ns/task\n", NsSince(t0) / n);
+  }
+
+  printf("\n  workers   spawn ns/job   fork ns/job   stolen   parfor ns/item\n");
+  for (int w = 0;; w = w ? w * 2 : 1) {
+    if (w > maxThreads)
+      w = maxThreads;
+    JobSystem jobs(w);
+
+    // Spawn: batches well below the per-thread job ring size.
+    const long batch = (long)JOB_POOL_SIZE / 4;
+    Clock::time_point t0 = Clock::now();
+    RunInPool(jobs, [&] {
+      for (long done = 0; done < count; done += batch) {
+        Job *root = jobs.Create([] {});
+        for (long i = 0; i < batch; i++)
+          jobs.Run(jobs.CreateChild(root, [] {}));
+        jobs.Run(root);
+        jobs.Wait(root);
+      }
+    });
+    double spawnNs = NsSince(t0) / (double)count;
+
+    // Fork/join tree: 2^(depth+1) - 1 jobs.
+    uint64_t stolenBefore = jobs.Stats().stolen;
+    t0 = Clock::now();
+    RunInPool(jobs, [&] { Fork(jobs, depth); });
+    double forkNs = NsSince(t0) / (double)((2ull << depth) - 1);
+    uint64_t stolen = jobs.Stats().stolen - stolenBefore;
+
+    // ParallelFor over tiny items.
+    std::vector<uint32_t> data(items, 1);
+    std::atomic<uint64_t> sum{0};
+    t0 = Clock::now();
+    jobs.ParallelFor(0, items, 4096, [&](size_t b, size_t e) {
+      uint64_t s = 0;
+      for (size_t i = b; i < e; i++)
+        s += data[i] * 3u;
+      sum.fetch_add(s, std::memory_order_relaxed);
+    });
+    double parNs = NsSince(t0) / (double)items;
+    if (sum.load() != items * 3) {
+      fprintf(stderr, "ParallelFor lost items\n");
+      return 1;
+    }
+
+    printf("  %7d   %12.1f   %11.1f   %6llu   %14.3f\n", w, spawnNs, forkNs,
+           (unsigned long long)stolen, parNs);
+    if (w == maxThreads)
+      break;
+  }
+
+  // Priority: saturate the pool with 2 ms background jobs, then measure how
+  // long a new job waits before it starts.
+  {
+    JobSystem jobs(maxThreads);
+    printf("\n  priority latency with %d busy workers:\n", jobs.Workers());
+    for (JobPriority p : {JOB_NORMAL, JOB_HIGH}) {
+      Job *background = jobs.Create([] {});
+      for (int i = 0; i < 64 * (jobs.Workers() + 1); i++)
+        jobs.Run(jobs.CreateChild(background, [] { BusyWork(2000); }));
+      jobs.Run(background);
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+      Clock::time_point submitted = Clock::now();
+      std::atomic<double> startedNs{-1.0};
+      Job *probe = jobs.Create(
+          [&] { startedNs.store(NsSince(submitted)); }, p);
+      jobs.Run(probe);
+      // Poll instead of Wait(): a helping caller would run the probe itself.
+      while (!probe->Finished())
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      jobs.Wait(background);
+      printf("    %-10s starts after %8.2f ms\n",
+             p == JOB_HIGH ? "JOB_HIGH" : "JOB_NORMAL", startedNs.load() / 1e6);
+    }
+    JobStats s = jobs.Stats();
+    printf("  totals: %llu executed, %llu stolen, %llu inline, %llu sleeps\n",
+           (unsigned long long)s.executed, (unsigned long long)s.stolen,
+           (unsigned long long)s.inline_, (unsigned long long)s.sleeps);
+  }
+  return 0;
+}
@@ -0,0 +1,336 @@
+// ============================================================================
+// notakto_table.cpp — Derive and check NOTAKTO_VALUE (src/notakto.h)
+// ============================================================================
+// The quotient monoid and its P set are known; what a program has to work
+// out is which element each single 3×3 board maps to. This tool:
+//
+//   1. lists the live boards up to the 8 symmetries of the square
+//   2. solves, by brute force with memoisation, every sum of one and two
+//      boards (plus the sums of three added as counterexamples, if any)
+//   3. finds an assignment of quotient elements to boards such that each
+//      of those sums is a P-position exactly when the product of its
+//      elements is in P (backtracking with forward checking; each board's
+//      domain starts as the elements with its own outcome)
+//   4. checks the assignment on every sum of three boards, repeating from 3
+//      with any failing sum as an extra constraint
+//
+// --emit prints the resulting 512-entry table for src/notakto.h. Without it
+// the tool checks the table compiled into src/notakto.h instead: every sum
+// of up to three boards, then --samples random sums of --boards boards
+// against brute force, and reports how fast NotaktoPosition::BestMove() is
+// on --big boards.
+//
+// USAGE:
+//   notakto_table [--emit] [--samples N] [--boards B] [--big N]
+//
+#include "../src/notakto.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Boards up to symmetry
+// ----------------------------------------------------------------------------
+static int SYM[8][9];
+static int canonical[512]; // mask → canonical mask
+static int boardId[512];   // canonical live mask → id, -1 otherwise
+static std::vector<int> boardMask; // id → canonical mask
+
+static void BuildBoards() {
+  for (int s = 0; s < 8; s++)
+    for (int r = 0; r < 3; r++)
+      for (int c = 0; c < 3; c++) {
+        int rr = r, cc = c;
+        if (s & 1)
+          std::swap(rr, cc);
+        if (s & 2)
+          rr = 2 - rr;
+        if (s & 4)
+          cc = 2 - cc;
+        SYM[s][r * 3 + c] = rr * 3 + cc;
+      }
+  for (int m = 0; m < 512; m++) {
+    int best = 512;
+    for (int s = 0; s < 8; s++) {
+      int t = 0;
+      for (int i = 0; i < 9; i++)
+        if (m >> i & 1)
+          t |= 1 << SYM[s][i];
+      best = std::min(best, t);
+    }
+    canonical[m] = best;
+    boardId[m] = -1;
+  }
+  for (int m = 0; m < 512; m++)
+    if (canonical[m] == m && !NotaktoPosition::Dead((uint16_t)m)) {
+      boardId[m] = (int)boardMask.size();
+      boardMask.push_back(m);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Brute-force outcome of a sum of boards (ids sorted, at most 8 boards).
+// True = P-position: the player to move loses.
+// ----------------------------------------------------------------------------
+static std::unordered_map<uint64_t, bool> memo;
+
+static uint64_t Pack(const std::vector<int> &ids) {
+  uint64_t k = 0;
+  for (int id : ids)
+    k = k << 8 | uint64_t(id + 1);
+  return k;
+}
+
+static bool Losing(std::vector<int> ids) {
+  std::sort(ids.begin(), ids.end());
+  uint64_t key = Pack(ids);
+  auto it = memo.find(key);
+  if (it != memo.end())
+    return it->second;
+
+  // No live board: the previous player killed the last one and lost.
+  bool losing = !ids.empty();
+  for (size_t i = 0; i < ids.size() && losing; i++) {
+    if (i && ids[i] == ids[i - 1])
+      continue;
+    int m = boardMask[ids[i]];
+    for (int c = 0; c < 9 && losing; c++) {
+      if (m >> c & 1)
+        continue;
+      int next = m | 1 << c;
+      std::vector<int> child = ids;
+      if (NotaktoPosition::Dead((uint16_t)next))
+        child.erase(child.begin() + i);
+      else
+        child[i] = boardId[canonical[next]];
+      if (Losing(child))
+        losing = false;
+    }
+  }
+  memo.emplace(key, losing);
+  return losing;
+}
+
+// ----------------------------------------------------------------------------
+// Assignment search
+// ----------------------------------------------------------------------------
+struct Triple {
+  int x, y, z;
+  bool losing;
+};
+
+static std::vector<std::vector<char>> pairLosing; // [i][j]
+static std::vector<Triple> triples;
+static std::vector<int> value; // id → element
+
+static bool LosingProduct(int x, int y, int z) {
+  return NotaktoLosing(NotaktoMul(NotaktoMul(x, y), z));
+}
+
+static bool Consistent(int upTo) {
+  for (const Triple &t : triples)
+    if (t.x <= upTo && t.y <= upTo && t.z <= upTo &&
+        LosingProduct(value[t.x], value[t.y], value[t.z]) != t.losing)
+      return false;
+  return true;
+}
+
+static bool Assign(int i, std::vector<uint32_t> &domain) {
+  int n = (int)boardMask.size();
+  if (i == n)
+    return true;
+  for (int x = 0; x < NOTAKTO_ELEMENTS; x++) {
+    if (!(domain[i] >> x & 1))
+      continue;
+    value[i] = x;
+    if (!Consistent(i))
+      continue;
+    std::vector<uint32_t> next = domain;
+    bool ok = true;
+    for (int j = i + 1; j < n && ok; j++) {
+      for (int y = 0; y < NOTAKTO_ELEMENTS; y++)
+        if ((next[j] >> y & 1) &&
+            NotaktoLosing(NotaktoMul(x, y)) != (bool)pairLosing[i][j])
+          next[j] &= ~(1u << y);
+      ok = next[j] != 0;
+    }
+    if (ok && Assign(i + 1, next))
+      return true;
+  }
+  return false;
+}
+
+static bool DeriveValues() {
+  int n = (int)boardMask.size();
+  pairLosing.assign(n, std::vector<char>(n));
+  for (int i = 0; i < n; i++)
+    for (int j = i; j < n; j++)
+      pairLosing[i][j] = pairLosing[j][i] = Losing({i, j});
+
+  for (;;) {
+    std::vector<uint32_t> domain(n, 0);
+    for (int i = 0; i < n; i++) {
+      bool single = Losing({i});
+      for (int x = 0; x < NOTAKTO_ELEMENTS; x++)
+        if (NotaktoLosing(x) == single &&
+            NotaktoLosing(NotaktoMul(x, x)) == (bool)pairLosing[i][i])
+          domain[i] |= 1u << x;
+    }
+    value.assign(n, 0);
+    if (!Assign(0, domain))
+      return false;
+
+    // Check every sum of three; retry with the first failure as a constraint.
+    bool clean = true;
+    for (int i = 0; i < n && clean; i++)
+      for (int j = i; j < n && clean; j++)
+        for (int k = j; k < n && clean; k++) {
+          bool l = Losing({i, j, k});
+          if (LosingProduct(value[i], value[j], value[k]) != l) {
+            triples.push_back(Triple{i, j, k, l});
+            clean = false;
+          }
+        }
+    if (clean)
+      return true;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Checks of the compiled-in table
+// ----------------------------------------------------------------------------
+static uint64_t rng = 0x9E3779B97F4A7C15ull;
+static int Random(int n) {
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return (int)(rng % (uint64_t)n);
+}
+
+static int TableValue(const std::vector<int> &ids) {
+  int v = NOTAKTO_IDENTITY;
+  for (int id : ids)
+    v = NotaktoMul(v, NOTAKTO_VALUE[boardMask[id]]);
+  return v;
+}
+
+int main(int argc, char **argv) {
+  bool emit = false;
+  int samples = 2000, boards = 4, big = 24;
+  for (int i = 1; i < argc; i++) {
+    const char *k = argv[i];
+    if (!strcmp(k, "--emit")) {
+      emit = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", k);
+      return 1;
+    }
+    const char *v = argv[++i];
+    if (!strcmp(k, "--samples"))
+      samples = atoi(v);
+    else if (!strcmp(k, "--boards"))
+      boards = std::min(8, atoi(v));
+    else if (!strcmp(k, "--big"))
+      big = std::min(NOTAKTO_MAX_BOARDS, atoi(v));
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+
+  BuildBoards();
+  int n = (int)boardMask.size();
+
+  if (emit) {
+    if (!DeriveValues()) {
+      fprintf(stderr, "no assignment matches the brute-force outcomes\n");
+      return 1;
+    }
+    fprintf(stderr, "%d live boards, %zu extra constraints\n", n,
+            triples.size());
+    for (int m = 0; m < 512; m++) {
+      int v = NotaktoPosition::Dead((uint16_t)m)
+                  ? NOTAKTO_IDENTITY
+                  : value[boardId[canonical[m]]];
+      printf("%s%2d,%s", m % 16 ? "" : "    ", v, m % 16 == 15 ? "\n" : " ");
+    }
+    return 0;
+  }
+
+  // Symmetric boards must share a value, dead boards are the identity.
+  for (int m = 0; m < 512; m++) {
+    int expect = NotaktoPosition::Dead((uint16_t)m)
+                     ? NOTAKTO_IDENTITY
+                     : NOTAKTO_VALUE[canonical[m]];
+    if (NOTAKTO_VALUE[m] != expect) {
+      fprintf(stderr, "table entry %d breaks symmetry\n", m);
+      return 1;
+    }
+  }
+
+  // Every sum of one, two and three boards.
+  uint64_t checked = 0;
+  for (int i = 0; i < n; i++)
+    for (int j = i; j <= n; j++)
+      for (int k = j; k <= n; k++) {
+        std::vector<int> ids = {i};
+        if (j < n)
+          ids.push_back(j);
+        if (j < n && k < n)
+          ids.push_back(k);
+        else if (k < n)
+          continue;
+        if (NotaktoLosing(TableValue(ids)) != Losing(ids)) {
+          fprintf(stderr, "mismatch on a sum of %zu boards\n", ids.size());
+          return 1;
+        }
+        checked++;
+      }
+  printf("%d live boards up to symmetry; all %llu sums of 1-3 boards match\n",
+         n, (unsigned long long)checked);
+
+  // Random larger sums.
+  for (int s = 0; s < samples; s++) {
+    std::vector<int> ids;
+    for (int b = 0; b < boards; b++)
+      ids.push_back(Random(n));
+    if (NotaktoLosing(TableValue(ids)) != Losing(ids)) {
+      fprintf(stderr, "mismatch on a random sum of %d boards\n", boards);
+      return 1;
+    }
+  }
+  printf("%d random sums of %d boards match (%zu positions solved by brute "
+         "force)\n",
+         samples, boards, memo.size());
+
+  // Solver speed on many boards.
+  NotaktoPosition p;
+  p.count = big;
+  double total = 0;
+  int moves = 0, perfect = 0;
+  for (;;) {
+    auto t0 = std::chrono::steady_clock::now();
+    int b, c;
+    perfect += p.BestMove(&b, &c);
+    total += std::chrono::duration<double, std::nano>(
+                 std::chrono::steady_clock::now() - t0)
+                 .count();
+    if (b < 0)
+      break;
+    p.Play(b, c);
+    moves++;
+    if (p.Over())
+      break;
+  }
+  printf("BestMove on %d boards: %.0f ns per move over a %d-move game "
+         "(%d moves to a P-position)\n",
+         big, total / moves, moves, perfect);
+  return 0;
+}
@@ -0,0 +1,143 @@
+// ============================================================================
+// ponder_bench.cpp — Move latency of AiPlayer with and without pondering
+// ============================================================================
+// Plays --games games between an AiPlayer and a scripted opponent, once with
+// pondering off and once with it on, on a board the 3×3 book doesn't cover
+// (5×5 four in a row by default), so every AI move is searched.
+//
+// The opponent answers with a depth-3 search, one move in four picked at
+// random among the first few generated, and always takes --think ms of wall
+// time per move (it sleeps out the rest), like a human looking at the board.
+// That is the time the pondering AI gets to search the predicted reply.
+//
+//   latency → wall time of ChooseMove(), the delay the player sees, split
+//             into ponder hits and misses
+//   depth   → iterative-deepening depth of the move played, to show that a
+//             hit answers sooner without playing worse
+//
+// The AI plays X in even games and O in odd ones; the opponent's choices
+// come from a fixed seed, so the two runs see the same opponent (the games
+// still diverge where the AI's moves do).
+//
+// USAGE:
+//   ponder_bench [--size N] [--win K] [--games G] [--ms MS] [--think MS]
+//
+#include "../src/ai.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point t) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+struct Latency {
+  int moves = 0, hits = 0;
+  double total = 0, hitTotal = 0, worst = 0;
+  long depths = 0;
+};
+
+static Latency Run(bool ponder, int size, int winLen, int games, double ms,
+                   double thinkMs) {
+  SearchLimits limits;
+  limits.timeMs = ms;
+  AiPlayer ai(size, winLen, limits, 1 << 20, ponder);
+  Searcher opponent(1 << 18);
+  SearchLimits oppLimits;
+  oppLimits.maxDepth = 3;
+  oppLimits.timeMs = 1e9;
+
+  Latency l;
+  uint64_t r = 11;
+  for (int g = 0; g < games; g++) {
+    Board b(size, winLen);
+    int aiSide = g & 1;
+    ai.StopPondering();
+    opponent.Table().Clear();
+
+    while (!b.Over()) {
+      Clock::time_point t = Clock::now();
+      int move;
+      if (b.side == aiSide) {
+        move = ai.ChooseMove(b);
+        double took = MsSince(t);
+        const AiStats &s = ai.LastStats();
+        l.moves++;
+        l.total += took;
+        l.worst = took > l.worst ? took : l.worst;
+        l.depths += s.result.depth;
+        if (s.ponderHit) {
+          l.hits++;
+          l.hitTotal += took;
+        }
+      } else {
+        r = SplitMix64(r);
+        if (r % 4 == 0) {
+          uint8_t moves[MAX_CELLS];
+          int n = GenerateMoves(b, moves);
+          move = moves[(r >> 8) % (n < 6 ? n : 6)];
+        } else {
+          move = opponent.Search(b, oppLimits).move;
+        }
+        double left = thinkMs - MsSince(t);
+        if (left > 0)
+          std::this_thread::sleep_for(
+              std::chrono::duration<double, std::milli>(left));
+      }
+      b.Make(move);
+    }
+  }
+  ai.StopPondering();
+  return l;
+}
+
+static void Print(const char *label, const Latency &l) {
+  int misses = l.moves - l.hits;
+  printf("%-10s %3d moves  latency avg %6.1f ms  max %6.1f ms  depth avg "
+         "%.1f\n",
+         label, l.moves, l.total / (l.moves ? l.moves : 1), l.worst,
+         (double)l.depths / (l.moves ? l.moves : 1));
+  if (l.hits)
+    printf("%-10s %3d hits (%.0f%%) avg %6.1f ms, %d misses avg %6.1f ms\n",
+           "", l.hits, 100.0 * l.hits / l.moves, l.hitTotal / l.hits, misses,
+           misses ? (l.total - l.hitTotal) / misses : 0.0);
+}
+
+int main(int argc, char **argv) {
+  int size = 5, winLen = 4, games = 4;
+  double ms = 200.0, thinkMs = 400.0;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--size"))
+      size = atoi(v);
+    else if (!strcmp(k, "--win"))
+      winLen = atoi(v);
+    else if (!strcmp(k, "--games"))
+      games = atoi(v);
+    else if (!strcmp(k, "--ms"))
+      ms = atof(v);
+    else if (!strcmp(k, "--think"))
+      thinkMs = atof(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (size < 3 || size > MAX_SIDE || winLen < 3 || winLen > size ||
+      games < 1 || ms <= 0 || thinkMs < 0) {
+    fprintf(stderr, "invalid options\n");
+    return 1;
+  }
+
+  printf("%dx%d k=%d, %d games, %.0f ms per AI move, opponent thinks %.0f "
+         "ms\n",
+         size, size, winLen, games, ms, thinkMs);
+  Print("ponder off", Run(false, size, winLen, games, ms, thinkMs));
+  Print("ponder on", Run(true, size, winLen, games, ms, thinkMs));
+  return 0;
+}
@@ -0,0 +1,258 @@
+// ============================================================================
+// puzzle_miner.cpp — Mine "win in N" puzzles from self-play games
+// ============================================================================
+// Three passes, the expensive ones spread over every core with the job
+// system (one Searcher per thread, as in book_builder). The table is cleared
+// before every game and every candidate and no search has a deadline, so
+// the pack depends only on the options, not on the thread count or on how
+// fast the machine is:
+//
+//   1. self-play → --games games between two shallow searchers that play a
+//                  random move now and then, each from a random opening;
+//                  every position after the opening is a candidate
+//   2. dedup     → one candidate per canonical key (symmetric images and
+//                  transpositions are the same puzzle)
+//   3. verify    → a candidate is a puzzle if the side to move forces a win
+//                  with its N-th move (--min <= N <= --moves), found by
+//                  iterative deepening so N is the shortest, and no other
+//                  move also wins that fast. With --time, searches that
+//                  run out of time reject the candidate rather than guess
+//                  (and the pack then depends on the machine).
+//
+// The pack is sorted by N and canonical key and read back once to check
+// that every answer is a legal cell of its position.
+//
+// USAGE:
+//   puzzle_miner [--size N] [--win K] [--games G] [--min N] [--moves N]
+//                [--time MS] [--threads T] [--out FILE]
+//
+//   --size    board side length (default 7)
+//   --win     stones in a row to win (default 4)
+//   --games   self-play games to sample (default 400)
+//   --min     shortest win kept, in own moves (default 2)
+//   --moves   longest win searched for, in own moves (default 3)
+//   --time    time limit per verification search in ms (default 0: none)
+//   --threads threads, including the calling one (default: all hardware
+//             threads)
+//   --out     output path (default resources/puzzles_<N>x<N>_k<K>.bin)
+//
+#include "../src/jobs.h"
+#include "../src/puzzle.h"
+#include "../src/search.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+
+using Clock = std::chrono::steady_clock;
+
+// ----------------------------------------------------------------------------
+// Self-play: a random opening of 2-4 stones near the centre, then depth-2
+// searches with one move in four picked at random among the 12 best-placed
+// candidates, so games wander into sharp positions instead of repeating.
+// ----------------------------------------------------------------------------
+static void SelfPlay(uint64_t seed, int size, int winLen, Searcher &searcher,
+                     std::vector<Board> &out) {
+  Board b(size, winLen);
+  uint64_t r = SplitMix64(seed);
+  int opening = 2 + (int)(r % 3);
+  SearchLimits shallow;
+  shallow.maxDepth = 2;
+  shallow.timeMs = 1e9; // depth-bound only
+  searcher.Table().Clear();
+
+  while (!b.Over()) {
+    uint8_t moves[MAX_CELLS];
+    int n = GenerateMoves(b, moves);
+    r = SplitMix64(r);
+    int move;
+    if (b.ply < opening)
+      move = moves[r % (n < 8 ? n : 8)];
+    else if ((r >> 32) % 4 == 0)
+      move = moves[(r >> 8) % (n < 12 ? n : 12)];
+    else
+      move = searcher.Search(b, shallow).move;
+    b.Make(move);
+    if (!b.Over() && b.ply > opening)
+      out.push_back(b);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Verify: fill *out and return true if `b` is a puzzle.
+// ----------------------------------------------------------------------------
+static bool Verify(const Board &b, int minN, int maxN, double timeMs,
+                   Searcher &searcher, PuzzleEntry *out) {
+  SearchLimits limits;
+  limits.maxDepth = 2 * maxN - 1;
+  limits.timeMs = timeMs > 0 ? timeMs : 1e9;
+  searcher.Table().Clear();
+  SearchResult r = searcher.Search(b, limits);
+  if (r.score <= SCORE_MATE_BOUND)
+    return false;
+  int plies = SCORE_WIN - r.score; // 1 = the next stone wins
+  int n = (plies + 1) / 2;
+  if (n < minN)
+    return false;
+
+  // Unique: no other move forces the win within the same number of plies.
+  uint8_t moves[MAX_CELLS];
+  int count = GenerateMoves(b, moves);
+  limits.maxDepth = plies - 1;
+  for (int i = 0; i < count; i++) {
+    if (moves[i] == r.move)
+      continue;
+    Board c = b;
+    c.Make(moves[i]);
+    if (c.Over()) {
+      if (c.Result() != RESULT_DRAW)
+        return false;
+      continue;
+    }
+    SearchResult d = searcher.Search(c, limits);
+    if (d.score < -SCORE_MATE_BOUND && SCORE_WIN + d.score <= plies - 1)
+      return false; // the defender is lost just as fast
+    if (d.depth < plies - 1 && d.score >= -SCORE_MATE_BOUND &&
+        d.score <= SCORE_MATE_BOUND)
+      return false; // ran out of time: not proven either way
+  }
+
+  *out = PuzzleEntry();
+  out->stones[0] = b.stones[0];
+  out->stones[1] = b.stones[1];
+  out->answer = (uint8_t)r.move;
+  out->moves = (uint8_t)n;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  int size = 7, winLen = 4, games = 400, minN = 2, maxN = 3, threads = 0;
+  double timeMs = 0.0;
+  const char *out = nullptr;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--size"))
+      size = atoi(v);
+    else if (!strcmp(k, "--win"))
+      winLen = atoi(v);
+    else if (!strcmp(k, "--games"))
+      games = atoi(v);
+    else if (!strcmp(k, "--min"))
+      minN = atoi(v);
+    else if (!strcmp(k, "--moves"))
+      maxN = atoi(v);
+    else if (!strcmp(k, "--time"))
+      timeMs = atof(v);
+    else if (!strcmp(k, "--threads"))
+      threads = atoi(v);
+    else if (!strcmp(k, "--out"))
+      out = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (size < 3 || size > MAX_SIDE || winLen < 3 || winLen > size ||
+      minN < 1 || maxN < minN) {
+    fprintf(stderr, "invalid options\n");
+    return 1;
+  }
+  if (threads <= 0)
+    threads = (int)std::thread::hardware_concurrency();
+  if (threads <= 0)
+    threads = 1;
+
+  char defaultPath[128];
+  PuzzlePath(defaultPath, sizeof(defaultPath), size, winLen);
+  if (!out)
+    out = defaultPath;
+
+  JobSystem jobs(threads - 1);
+  std::vector<std::unique_ptr<Searcher>> searchers(jobs.Workers() + 1);
+  auto ThreadSearcher = [&]() -> Searcher & {
+    std::unique_ptr<Searcher> &s = searchers[jobs.ThreadIndex()];
+    if (!s)
+      s.reset(new Searcher(1 << 18));
+    return *s;
+  };
+  Clock::time_point t0 = Clock::now();
+
+  // 1. Self-play, one game per job; positions are kept per game so the
+  // dedup below sees them in game order whichever thread played them.
+  std::vector<std::vector<Board>> sampled(games);
+  jobs.ParallelFor(0, games, 1, [&](size_t begin, size_t end) {
+    for (size_t g = begin; g < end; g++)
+      SelfPlay(g, size, winLen, ThreadSearcher(), sampled[g]);
+  });
+
+  // 2. Deduplicate by canonical key.
+  std::vector<Board> candidates;
+  std::vector<uint64_t> keys;
+  std::unordered_set<uint64_t> seen;
+  size_t total = 0;
+  for (const std::vector<Board> &part : sampled)
+    for (const Board &b : part) {
+      total++;
+      uint64_t key = b.CanonicalHash();
+      if (seen.insert(key).second) {
+        candidates.push_back(b);
+        keys.push_back(key);
+      }
+    }
+  printf("self-play  %d games, %zu positions, %zu after dedup, %d threads\n",
+         games, total, candidates.size(), threads);
+
+  // 3. Verify, one candidate per job (their cost varies a lot).
+  std::vector<PuzzleEntry> found(candidates.size());
+  std::vector<char> isPuzzle(candidates.size(), 0);
+  jobs.ParallelFor(0, candidates.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      isPuzzle[i] = Verify(candidates[i], minN, maxN, timeMs, ThreadSearcher(),
+                           &found[i]);
+  });
+
+  std::vector<size_t> order;
+  for (size_t i = 0; i < candidates.size(); i++)
+    if (isPuzzle[i])
+      order.push_back(i);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return found[a].moves != found[b].moves ? found[a].moves < found[b].moves
+                                            : keys[a] < keys[b];
+  });
+  std::vector<PuzzleEntry> puzzles;
+  int perN[MAX_CELLS] = {0};
+  for (size_t i : order) {
+    puzzles.push_back(found[i]);
+    perN[found[i].moves]++;
+  }
+  double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+  printf("verify     %zu puzzles in %.1f s:", puzzles.size(), secs);
+  for (int n = minN; n <= maxN; n++)
+    printf("  %d x win in %d", perN[n], n);
+  printf("\n");
+
+  if (!WritePuzzlePack(out, size, winLen, puzzles)) {
+    fprintf(stderr, "failed to write %s\n", out);
+    return 1;
+  }
+
+  // Read back: every answer must be an empty cell of an unfinished game.
+  PuzzlePack pack;
+  if (!pack.Open(out, size, winLen) || pack.Count() != puzzles.size()) {
+    fprintf(stderr, "failed to reopen %s\n", out);
+    return 1;
+  }
+  for (uint32_t i = 0; i < pack.Count(); i++) {
+    const PuzzleEntry &e = pack.At(i);
+    Board b = PuzzleBoard(e, size, winLen);
+    if (b.Over() || !(b.Empty() >> e.answer & 1) ||
+        !PuzzlePack::Solves(e, e.answer)) {
+      fprintf(stderr, "puzzle %u does not read back\n", i);
+      return 1;
+    }
+  }
+  printf("wrote %u puzzles to %s\n", pack.Count(), out);
+  return 0;
+}
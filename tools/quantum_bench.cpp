@@ -0,0 +1,150 @@
+// ============================================================================
+// quantum_bench.cpp — Correctness and speed of the quantum tic-tac-toe rules
+// ============================================================================
+// Plays --games random games (random cell pairs, random collapse choices)
+// through QuantumBoard and checks after every step:
+//
+//   cycle    → Place() reports a cycle exactly when a breadth-first search
+//              over the spooky marks already connects the two cells
+//   collapse → every cell of the collapsed component is classical, every
+//              mark is either classical in one cell or spooky in both of its
+//              cells, and no spooky mark touches a classical cell
+//   moves    → a game never needs more than MAX_MOVES moves
+//
+// then times the same games without the checks (ns per move, collapses
+// included).
+//
+// USAGE:
+//   quantum_bench [--games N]
+//
+#include "../src/quantum.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t rng = 0x13198A2E03707344ull;
+static int Random(int n) { return (int)((rng = SplitMix64(rng)) % n); }
+
+// Cells reachable from `from` over spooky marks, as a 9-bit mask.
+static uint16_t Component(const QuantumBoard &q, int from) {
+  uint16_t seen = (uint16_t)(1u << from), frontier = seen;
+  while (frontier) {
+    int c = __builtin_ctz(frontier);
+    frontier &= frontier - 1;
+    for (uint16_t m = q.Spooky(c); m; m &= m - 1) {
+      int a, b;
+      q.MarkCells(__builtin_ctz(m), &a, &b);
+      int other = a == c ? b : a;
+      if (!(seen >> other & 1)) {
+        seen |= 1u << other;
+        frontier |= 1u << other;
+      }
+    }
+  }
+  return seen;
+}
+
+static bool Consistent(const QuantumBoard &q) {
+  for (int t = 1; t <= q.Moves(); t++) {
+    int a, b;
+    q.MarkCells(t, &a, &b);
+    bool inA = q.Spooky(a) >> t & 1, inB = q.Spooky(b) >> t & 1;
+    int where = (q.Classical(a) == t) + (a != b && q.Classical(b) == t);
+    if (where ? (where != 1 || inA || inB) : (!inA || !inB))
+      return false;
+  }
+  for (int c = 0; c < QuantumBoard::CELLS; c++)
+    if (q.Classical(c) && q.Spooky(c))
+      return false;
+  return true;
+}
+
+// One random step; returns false when the game is over.
+static bool Step(QuantumBoard &q, bool check, uint64_t *cycles) {
+  if (q.Result() != RESULT_NONE)
+    return false;
+  if (q.LastCell() >= 0) {
+    q.PlaceLast();
+    return true;
+  }
+  if (q.Pending()) {
+    int a, b;
+    q.MarkCells(q.Pending(), &a, &b);
+    uint16_t comp = check ? Component(q, a) : 0;
+    q.Collapse(Random(2) ? a : b);
+    if (!check)
+      return true;
+    for (int c = 0; c < QuantumBoard::CELLS; c++)
+      if ((comp >> c & 1) && !q.Classical(c)) {
+        fprintf(stderr, "cell %d of the collapsed component is open\n", c);
+        exit(1);
+      }
+    return true;
+  }
+
+  int a, b;
+  do {
+    a = Random(QuantumBoard::CELLS);
+    b = Random(QuantumBoard::CELLS);
+  } while (!q.CanPlace(a, b));
+  bool connected = check && (Component(q, a) >> b & 1);
+  bool cycle = q.Place(a, b);
+  *cycles += cycle;
+  if (check && cycle != connected) {
+    fprintf(stderr, "Place() says %s, search says %s\n",
+            cycle ? "cycle" : "no cycle", connected ? "cycle" : "no cycle");
+    exit(1);
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  int games = 200000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--games"))
+      games = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+
+  uint64_t steps = 0, cycles = 0, outcomes[4] = {0, 0, 0, 0};
+  uint64_t seed = rng;
+  for (int g = 0; g < games; g++) {
+    QuantumBoard q;
+    while (Step(q, true, &cycles)) {
+      steps++;
+      if (!Consistent(q) || q.Moves() > QuantumBoard::MAX_MOVES) {
+        fprintf(stderr, "inconsistent board in game %d\n", g);
+        return 1;
+      }
+    }
+    outcomes[q.Result()]++;
+  }
+  printf("rules   %d games, %llu steps, %llu cycles: all checks pass\n", games,
+         (unsigned long long)steps, (unsigned long long)cycles);
+  printf("        X %llu, O %llu, draws %llu\n",
+         (unsigned long long)outcomes[RESULT_X],
+         (unsigned long long)outcomes[RESULT_O],
+         (unsigned long long)outcomes[RESULT_DRAW]);
+
+  // Same games again, unchecked.
+  rng = seed;
+  uint64_t timed = 0, unused = 0;
+  Clock::time_point t0 = Clock::now();
+  for (int g = 0; g < games; g++) {
+    QuantumBoard q;
+    while (Step(q, false, &unused))
+      timed++;
+  }
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+  printf("speed   %.1f ns per step (random choice included)\n", ns / timed);
+  return 0;
+}
@@ -0,0 +1,111 @@
+// ============================================================================
+// reuse_bench.cpp — Time-to-equal-strength: persistent vs cold engines
+// ============================================================================
+// Plays a series of self-play games and, before every move, measures how long
+// each engine needs to reach a fixed strength target:
+//
+//   alpha-beta → time to complete a search to a fixed depth
+//   MCTS       → time until the root has a fixed number of visits
+//
+// "warm" engines keep their transposition table / tree across moves and
+// games (the way AiPlayer keeps its Searcher in the game; Mcts is only used
+// here); "cold" engines are cleared before every move. Equal depth / equal
+// root visits is used as the proxy for equal strength.
+//
+// USAGE:
+//   reuse_bench [--size N] [--win K] [--games G] [--depth D] [--visits V]
+//
+#include "../src/mcts.h"
+#include "../src/search.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point t) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+int main(int argc, char **argv) {
+  int size = 4, winLen = 0, games = 4, depth = 8;
+  uint32_t visits = 20000;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--size"))
+      size = atoi(v);
+    else if (!strcmp(k, "--win"))
+      winLen = atoi(v);
+    else if (!strcmp(k, "--games"))
+      games = atoi(v);
+    else if (!strcmp(k, "--depth"))
+      depth = atoi(v);
+    else if (!strcmp(k, "--visits"))
+      visits = (uint32_t)atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (winLen <= 0)
+    winLen = size;
+
+  SearchLimits limits;
+  limits.maxDepth = depth;
+  limits.timeMs = 1e9;
+
+  Searcher warmAb(1 << 20), coldAb(1 << 20);
+  Mcts warmMcts(size, winLen), coldMcts(size, winLen);
+
+  double abWarm = 0, abCold = 0, mcWarm = 0, mcCold = 0;
+  int moves = 0;
+
+  for (int g = 0; g < games; g++) {
+    Board b(size, winLen);
+    std::vector<int> history;
+    warmMcts.NewGame();
+
+    while (!b.Over()) {
+      Clock::time_point t = Clock::now();
+      SearchResult r = warmAb.Search(b, limits);
+      abWarm += MsSince(t);
+
+      coldAb.Table().Clear();
+      t = Clock::now();
+      coldAb.Search(b, limits);
+      abCold += MsSince(t);
+
+      t = Clock::now();
+      warmMcts.Run(0, visits);
+      mcWarm += MsSince(t);
+
+      coldMcts.Reset();
+      for (int m : history)
+        coldMcts.Advance(m);
+      t = Clock::now();
+      coldMcts.Run(0, visits);
+      mcCold += MsSince(t);
+
+      // Alpha-beta's choice drives the game so both engines see identical
+      // positions; the MCTS tree follows along.
+      b.Make(r.move);
+      warmMcts.Advance(r.move);
+      history.push_back(r.move);
+      moves++;
+    }
+  }
+
+  printf("%dx%d k=%d, %d games, %d positions\n", size, size, winLen, games,
+         moves);
+  char label[64];
+  snprintf(label, sizeof(label), "alpha-beta to depth %d", depth);
+  printf("%-26s: warm %8.1f ms  cold %8.1f ms  (%.2fx)\n", label, abWarm,
+         abCold, abCold / (abWarm > 0 ? abWarm : 1));
+  snprintf(label, sizeof(label), "MCTS to %u visits", visits);
+  printf("%-26s: warm %8.1f ms  cold %8.1f ms  (%.2fx)\n", label, mcWarm,
+         mcCold, mcCold / (mcWarm > 0 ? mcWarm : 1));
+  return 0;
+}
@@ -0,0 +1,99 @@
+// ============================================================================
+// script_bench.cpp — Cost of many concurrent coroutine scripts
+// ============================================================================
+// Starts --scripts scripts that each wait a pseudo-random 10–500 ms between
+// --steps steps (a wall of boards all running transitions at once) and
+// drives them with a 2 ms Tick(), like the game's logic loop.
+//
+// Reports:
+//   start   → ns per Start() (frame allocation + first resume)
+//   resume  → ns per resumed Wait() inside Tick()
+//   frames  → live frames, pool slabs and heap fallbacks, plus the general
+//             heap allocations made once the pool was warm (should be 0)
+//
+// USAGE:
+//   script_bench [--scripts N] [--steps S]
+//
+#define ARENA_COUNT_HEAP
+#include "../src/arena.h"
+#include "../src/script.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+static double NsSince(Clock::time_point t0) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+static Script Sequence(uint32_t seed, int steps, uint64_t &work) {
+  for (int i = 0; i < steps; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    co_await Wait(0.010 + (seed >> 8) % 490 / 1000.0);
+    work++;
+  }
+}
+
+int main(int argc, char **argv) {
+  int scripts = 10000, steps = 20;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--scripts"))
+      scripts = atoi(v);
+    else if (!strcmp(k, "--steps"))
+      steps = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+
+  ScriptRunner runner(scripts);
+  uint64_t work = 0;
+
+  // Warm-up round fills the pool; the measured round must not allocate.
+  for (int round = 0; round < 2; round++) {
+    uint64_t heapBefore = HeapCounters::ThreadAllocations();
+    work = 0;
+
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < scripts; i++)
+      runner.Start(Sequence((uint32_t)i * 2654435761u, steps, work));
+    double startNs = NsSince(t0) / scripts;
+    ScriptPool::Stats live = ScriptPool::ThreadStats();
+
+    double time = 0.0;
+    uint64_t ticks = 0;
+    t0 = Clock::now();
+    while (runner.Active()) {
+      time += 0.002;
+      runner.Tick(time);
+      ticks++;
+    }
+    double resumeNs = NsSince(t0) / (double)work;
+
+    if (work != (uint64_t)scripts * steps) {
+      fprintf(stderr, "lost resumes: %llu\n", (unsigned long long)work);
+      return 1;
+    }
+    if (round == 0)
+      continue;
+
+    ScriptPool::Stats s = ScriptPool::ThreadStats();
+    printf("%d scripts x %d steps, %llu ticks of 2 ms simulated time\n",
+           scripts, steps, (unsigned long long)ticks);
+    printf("  start    %8.1f ns/script\n", startNs);
+    printf("  resume   %8.1f ns/wait\n", resumeNs);
+    printf("  frames   %llu live at peak, %llu slabs (%llu KB), "
+           "%llu heap fallbacks\n",
+           (unsigned long long)live.live, (unsigned long long)s.slabs,
+           (unsigned long long)(s.slabs * ScriptPool::SLAB_BYTES / 1024),
+           (unsigned long long)s.heapFallbacks);
+    printf("  heap allocations in warm round: %llu\n",
+           (unsigned long long)(HeapCounters::ThreadAllocations() -
+                                heapBefore));
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+// ============================================================================
+// seqlock_bench.cpp — Torn-read check and cost of SeqLock publication
+// ============================================================================
+// One writer thread stores a GameState-sized value (every word equal to a
+// counter) as fast as it can, while --readers threads sample it. A sample
+// whose words differ is a torn read and fails the run.
+//
+// Reports:
+//   store  → ns per Store() with all readers running
+//   reads  → successful samples per reader per second, and how many
+//            TryLoad() attempts overlapped a store and had to be retried
+//
+// USAGE:
+//   seqlock_bench [--readers R] [--ms M] [--words W]
+//
+#include "../src/lockfree.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// About the size of the game's GameState (board + move history + stats).
+struct Sample {
+  uint64_t words[64];
+};
+
+int main(int argc, char **argv) {
+  int readers = 3, ms = 1000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--readers"))
+      readers = atoi(v);
+    else if (!strcmp(k, "--ms"))
+      ms = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+
+  SeqLock<Sample> lock;
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> torn{0};
+  std::vector<uint64_t> reads(readers), retries(readers);
+
+  std::vector<std::thread> pool;
+  for (int r = 0; r < readers; r++)
+    pool.emplace_back([&, r] {
+      Sample s;
+      uint64_t ok = 0, failed = 0, last = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (!lock.TryLoad(s)) {
+          failed++;
+          continue;
+        }
+        ok++;
+        for (uint64_t w : s.words)
+          if (w != s.words[0])
+            torn.fetch_add(1, std::memory_order_relaxed);
+        if (s.words[0] < last)
+          torn.fetch_add(1, std::memory_order_relaxed); // went backwards
+        last = s.words[0];
+      }
+      reads[r] = ok;
+      retries[r] = failed;
+    });
+
+  Sample value;
+  uint64_t stores = 0;
+  double storeNs = 0.0;
+  Clock::time_point t0 = Clock::now(), end = t0 + std::chrono::milliseconds(ms);
+  while (Clock::now() < end) {
+    Clock::time_point b0 = Clock::now();
+    for (int batch = 0; batch < 256; batch++) {
+      stores++;
+      for (uint64_t &w : value.words)
+        w = stores;
+      lock.Store(value);
+    }
+    storeNs += std::chrono::duration<double, std::nano>(Clock::now() - b0)
+                   .count();
+    // Give readers on a small machine a chance to run between bursts.
+    std::this_thread::yield();
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+  stop.store(true);
+  for (std::thread &t : pool)
+    t.join();
+
+  uint64_t totalReads = 0, totalRetries = 0;
+  for (int r = 0; r < readers; r++) {
+    totalReads += reads[r];
+    totalRetries += retries[r];
+  }
+  printf("%d readers, %zu-byte value, %.2f s\n", readers, sizeof(Sample),
+         seconds);
+  printf("  store   %8.1f ns (%llu stores, version %llu)\n",
+         storeNs / (double)stores, (unsigned long long)stores,
+         (unsigned long long)lock.Version());
+  printf("  reads   %8.0f /s per reader, %.2f%% attempts retried\n",
+         readers ? (double)totalReads / readers / seconds : 0.0,
+         totalReads + totalRetries
+             ? 100.0 * (double)totalRetries / (double)(totalReads + totalRetries)
+             : 0.0);
+  printf("  torn    %llu\n", (unsigned long long)torn.load());
+  return torn.load() ? 1 : 0;
+}
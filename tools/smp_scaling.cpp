@@ -0,0 +1,126 @@
+// ============================================================================
+// smp_scaling.cpp — Lazy SMP scaling report
+// ============================================================================
+// For each thread count T in 1, 2, 4, ... up to --max-threads:
+//
+//   time-to-depth → mean wall-clock time for a T-thread Searcher to finish
+//                   --depth on a fixed set of early positions (cold table)
+//   Elo           → T threads vs 1 thread at --ms per move, --games games
+//                   from varied two-move openings, colours alternating
+//
+// Elo is estimated from the match score s as -400 * log10(1/s - 1).
+// Results are only meaningful on a machine with at least T idle cores.
+//
+// USAGE:
+//   smp_scaling [--size N] [--win K] [--depth D] [--ms MS] [--games G]
+//               [--max-threads T]
+//
+#include "../src/search.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+// Deterministic opening: two stones placed near the centre from `seed`.
+static Board Opening(int size, int winLen, int seed) {
+  Board b(size, winLen);
+  uint64_t r = SplitMix64(seed);
+  for (int i = 0; i < 2; i++) {
+    uint8_t moves[MAX_CELLS] = {0};
+    int n = GenerateMoves(b, moves);
+    b.Make(moves[(r >> (8 * i)) % (n < 8 ? n : 8)]);
+  }
+  return b;
+}
+
+// Play one game; returns 1 / 0.5 / 0 from the point of view of `a`.
+static double PlayGame(Searcher &a, Searcher &b, bool aIsX, Board pos,
+                       const SearchLimits &limits) {
+  while (!pos.Over()) {
+    bool aToMove = (pos.side == 0) == aIsX;
+    SearchResult r = (aToMove ? a : b).Search(pos, limits);
+    pos.Make(r.move);
+  }
+  if (pos.winner == RESULT_DRAW)
+    return 0.5;
+  return (pos.winner == RESULT_X) == aIsX ? 1.0 : 0.0;
+}
+
+int main(int argc, char **argv) {
+  int size = 6, winLen = 4, depth = 8, games = 20, maxThreads = 0;
+  double ms = 50.0;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--size"))
+      size = atoi(v);
+    else if (!strcmp(k, "--win"))
+      winLen = atoi(v);
+    else if (!strcmp(k, "--depth"))
+      depth = atoi(v);
+    else if (!strcmp(k, "--ms"))
+      ms = atof(v);
+    else if (!strcmp(k, "--games"))
+      games = atoi(v);
+    else if (!strcmp(k, "--max-threads"))
+      maxThreads = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (maxThreads <= 0)
+    maxThreads = (int)std::thread::hardware_concurrency();
+  if (maxThreads <= 0)
+    maxThreads = 1;
+
+  printf("%dx%d k=%d, depth %d, %g ms/move, %d games, %u hw threads\n", size,
+         size, winLen, depth, ms, games, std::thread::hardware_concurrency());
+  printf("%7s  %14s  %8s  %10s  %7s\n", "threads", "time-to-depth", "speedup",
+         "score", "Elo");
+
+  const int POSITIONS = 6;
+  double baseTime = 0;
+
+  for (int t = 1; t <= maxThreads; t *= 2) {
+    // Time to depth on a cold table.
+    SearchLimits fixed;
+    fixed.maxDepth = depth;
+    fixed.timeMs = 1e9;
+    double total = 0;
+    for (int p = 0; p < POSITIONS; p++) {
+      Searcher s(1 << 20, t);
+      Board b = Opening(size, winLen, p);
+      Clock::time_point start = Clock::now();
+      s.Search(b, fixed);
+      total += std::chrono::duration<double, std::milli>(Clock::now() - start)
+                   .count();
+    }
+    double mean = total / POSITIONS;
+    if (t == 1)
+      baseTime = mean;
+
+    // Match against the single-threaded engine.
+    double score = 0;
+    SearchLimits timed;
+    timed.timeMs = ms;
+    if (t > 1) {
+      Searcher multi(1 << 20, t), single(1 << 20, 1);
+      for (int g = 0; g < games; g++)
+        score += PlayGame(multi, single, g % 2 == 0,
+                          Opening(size, winLen, 1000 + g / 2), timed);
+      score /= games;
+    } else {
+      score = 0.5;
+    }
+    double s = score <= 0.0 ? 0.001 : score >= 1.0 ? 0.999 : score;
+    double elo = -400.0 * std::log10(1.0 / s - 1.0) + 0.0; // no "-0"
+
+    printf("%7d  %11.1f ms  %7.2fx  %9.1f%%  %+7.0f\n", t, mean,
+           baseTime / mean, score * 100.0, elo);
+  }
+  return 0;
+}
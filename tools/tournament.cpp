@@ -0,0 +1,272 @@
+// ============================================================================
+// tournament.cpp — Round-robin tournament between external TTTP engines
+// ============================================================================
+// Every pair of engines plays --games games (colours alternating, each
+// opening played once with each colour). Up to --concurrency games run at the
+// same time; every game slot owns one process per engine and reuses it for
+// all of its games.
+//
+// All engine pipes are multiplexed with a single poll() loop: the runner never
+// blocks on one engine, and each move costs one pipelined write
+// ("position ...\ngo ...\n") plus the read that delivers "bestmove".
+//
+// With --archive every finished game (forfeits included) is appended to a
+// game archive (src/archive.h) that the replay scene can page through.
+//
+// With --clock BASE+INC (seconds, e.g. 10+0.1) games are played on a
+// GameClock (src/clock.h) instead of a fixed time per move. The runner is
+// the authority: each engine is charged from the moment poll() returned
+// with its opponent's reply (its own "go" is written right after) to the
+// moment poll() returned with its reply, gets the increment and loses on
+// time when its flag falls. Each "go" asks for a share of the engine's
+// remaining time.
+//
+// USAGE:
+//   tournament --engine CMD --engine CMD [--engine CMD ...]
+//              [--size N] [--win K] [--games G] [--concurrency C] [--ms MS]
+//              [--clock BASE+INC] [--archive FILE]
+//
+#include "../src/archive.h"
+#include "../src/clock.h"
+#include "../src/protocol.h"
+#include "../src/search.h"
+
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <memory>
+#include <poll.h>
+
+using Clock = std::chrono::steady_clock;
+
+// ----------------------------------------------------------------------------
+// One scheduled game: which engines play X and O, and its opening seed.
+// ----------------------------------------------------------------------------
+struct Pairing {
+  int x, o;
+  int opening;
+};
+
+// ----------------------------------------------------------------------------
+// A game slot: its own engine processes and the game currently running.
+// ----------------------------------------------------------------------------
+struct Slot {
+  std::vector<std::unique_ptr<EngineClient>> clients;
+  int game = -1; // index into the schedule, -1 when idle
+  Board pos;
+  uint8_t played[MAX_CELLS]; // moves of the game so far, for the archive
+  Clock::time_point asked;
+  GameClock clock; // with --clock
+};
+
+// Deterministic two-stone opening so colour-swapped games start identically.
+// The stones played are stored in `played`.
+static Board Opening(int size, int winLen, int seed, uint8_t *played) {
+  Board b(size, winLen);
+  uint64_t r = SplitMix64(seed + 12345);
+  for (int i = 0; i < 2 && !b.Over(); i++) {
+    uint8_t moves[MAX_CELLS];
+    int n = GenerateMoves(b, moves);
+    played[b.ply] = moves[(r >> (8 * i)) % (n < 8 ? n : 8)];
+    b.Make(played[b.ply]);
+  }
+  return b;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> engines;
+  int size = 3, winLen = 0, games = 10, concurrency = 4;
+  double ms = 100.0, base = 0.0, increment = 0.0;
+  const char *archivePath = nullptr;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--engine"))
+      engines.push_back(v);
+    else if (!strcmp(k, "--size"))
+      size = atoi(v);
+    else if (!strcmp(k, "--win"))
+      winLen = atoi(v);
+    else if (!strcmp(k, "--games"))
+      games = atoi(v);
+    else if (!strcmp(k, "--concurrency"))
+      concurrency = atoi(v);
+    else if (!strcmp(k, "--ms"))
+      ms = atof(v);
+    else if (!strcmp(k, "--clock"))
+      sscanf(v, "%lf+%lf", &base, &increment);
+    else if (!strcmp(k, "--archive"))
+      archivePath = v;
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (winLen <= 0)
+    winLen = size;
+  if (engines.size() < 2) {
+    fprintf(stderr, "need at least two --engine commands\n");
+    return 1;
+  }
+  int E = (int)engines.size();
+  bool clocked = base > 0.0;
+  signal(SIGPIPE, SIG_IGN); // an engine that dies forfeits, nothing more
+
+  ArchiveWriter archive;
+  if (archivePath && !archive.Open(archivePath, size, winLen)) {
+    fprintf(stderr, "cannot open archive %s (or it holds another shape)\n",
+            archivePath);
+    return 1;
+  }
+
+  std::vector<Pairing> schedule;
+  for (int a = 0; a < E; a++)
+    for (int b = a + 1; b < E; b++)
+      for (int g = 0; g < games; g++) {
+        int opening = (a * E + b) * 1000 + g / 2;
+        schedule.push_back(g % 2 == 0 ? Pairing{a, b, opening}
+                                      : Pairing{b, a, opening});
+      }
+
+  std::vector<double> score(E, 0.0);
+  std::vector<int> played(E, 0);
+  size_t nextGame = 0, finished = 0;
+  uint64_t moves = 0;
+
+  std::vector<Slot> slots(concurrency < 1 ? 1 : concurrency);
+  for (Slot &s : slots)
+    s.clients.resize(E);
+
+  // Ask the engine to move in slot s's current position. On a clock it may
+  // use a twentieth of its time plus most of the increment; the first
+  // request of a game starts the clock.
+  auto ask = [&](Slot &s) {
+    const Pairing &p = schedule[s.game];
+    int who = s.pos.side == 0 ? p.x : p.o;
+    double budget = ms;
+    if (clocked) {
+      double left = s.clock.Remaining(s.pos.side, MonotonicNs()) * 1e-6;
+      budget = left / 20 + increment * 800.0;
+      budget = budget < left / 2 ? budget : left / 2;
+    }
+    s.clients[who]->Go(s.pos, budget);
+    s.asked = Clock::now();
+    if (clocked && s.clock.Running() < 0)
+      s.clock.Start(s.pos.side, MonotonicNs());
+  };
+
+  // Record a result (winner: RESULT_X/O/DRAW) and free the slot.
+  auto finish = [&](Slot &s, int winner) {
+    const Pairing &p = schedule[s.game];
+    double xs = winner == RESULT_X ? 1.0 : winner == RESULT_DRAW ? 0.5 : 0.0;
+    score[p.x] += xs;
+    score[p.o] += 1.0 - xs;
+    played[p.x]++;
+    played[p.o]++;
+    if (archive.Opened() && !archive.Append(s.played, s.pos.ply, winner))
+      fprintf(stderr, "cannot append to %s\n", archivePath);
+    s.game = -1;
+    finished++;
+  };
+
+  Clock::time_point start = Clock::now();
+  while (finished < schedule.size()) {
+    // Hand out games to idle slots.
+    for (Slot &s : slots) {
+      if (s.game >= 0 || nextGame >= schedule.size())
+        continue;
+      s.game = (int)nextGame++;
+      const Pairing &p = schedule[s.game];
+      for (int e : {p.x, p.o}) {
+        if (!s.clients[e]) {
+          s.clients[e].reset(new EngineClient());
+          if (!s.clients[e]->Start(engines[e].c_str(), size, winLen)) {
+            fprintf(stderr, "cannot start %s\n", engines[e].c_str());
+            return 1;
+          }
+        } else {
+          s.clients[e]->NewGame(size, winLen);
+        }
+      }
+      s.pos = Opening(size, winLen, p.opening, s.played);
+      s.clock.Reset((int64_t)(base * NS_PER_SECOND),
+                    (int64_t)(increment * NS_PER_SECOND));
+      ask(s);
+    }
+
+    // Wait for any engine output (or writability if output is queued).
+    std::vector<pollfd> fds;
+    for (Slot &s : slots)
+      for (auto &c : s.clients)
+        if (c && c->Running()) {
+          fds.push_back({c->Process().Fd(), POLLIN, 0});
+          if (c->Process().WantsWrite())
+            fds.push_back({c->Process().WriteFd(), POLLOUT, 0});
+        }
+    poll(fds.data(), fds.size(), 50);
+    ReapEngines(); // processes of forfeited engines, killed earlier
+    int64_t polled = MonotonicNs(); // arrival time of whatever poll() saw
+
+    // Collect moves.
+    for (Slot &s : slots) {
+      if (s.game < 0)
+        continue;
+      const Pairing &p = schedule[s.game];
+      int who = s.pos.side == 0 ? p.x : p.o;
+      EngineClient &c = *s.clients[who];
+
+      int move;
+      bool got = c.Poll(&move);
+      double waited =
+          std::chrono::duration<double, std::milli>(Clock::now() - s.asked)
+              .count();
+
+      // A crashed, illegal or hopelessly late engine forfeits the game, as
+      // does one whose flag fell. Its process is replaced so a stale reply
+      // cannot leak into the next.
+      int winnerIfForfeit = s.pos.side == 0 ? RESULT_O : RESULT_X;
+      bool late = clocked ? (got ? !s.clock.Press(polled)
+                                 : s.clock.Flagged(polled) >= 0)
+                          : !got && waited > ms * 3 + 1000;
+      if (!c.Running() || late) {
+        fprintf(stderr, "%s forfeits (%s)\n", engines[who].c_str(),
+                !c.Running() ? "crashed"
+                : clocked    ? "lost on time"
+                             : "timeout");
+        s.clients[who].reset();
+        finish(s, winnerIfForfeit);
+        continue;
+      }
+      if (!got)
+        continue;
+      if (move < 0 || move >= s.pos.Cells() ||
+          !(s.pos.Empty() & (1ull << move))) {
+        fprintf(stderr, "%s played illegal move %d\n", engines[who].c_str(),
+                move);
+        finish(s, winnerIfForfeit);
+        continue;
+      }
+
+      s.played[s.pos.ply] = (uint8_t)move;
+      s.pos.Make(move);
+      moves++;
+      if (s.pos.Over())
+        finish(s, s.pos.winner);
+      else
+        ask(s);
+    }
+  }
+
+  double secs =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  printf("%zu games, %llu moves in %.1f s (%d concurrent)\n", schedule.size(),
+         (unsigned long long)moves, secs, (int)slots.size());
+  for (int e = 0; e < E; e++) {
+    double s = played[e] ? score[e] / played[e] : 0.5;
+    double c = s <= 0.0 ? 0.001 : s >= 1.0 ? 0.999 : s;
+    printf("  %-40s %5.1f / %3d  (%5.1f%%, %+5.0f Elo vs field)\n",
+           engines[e].c_str(), score[e], played[e], s * 100.0,
+           -400.0 * std::log10(1.0 / c - 1.0) + 0.0);
+  }
+  return 0;
+}
@@ -0,0 +1,164 @@
+// ============================================================================
+// variant_bench.cpp — Correctness and speed of the compile-time rule variants
+// ============================================================================
+//   perft  → the full 3×3 game tree walked with VariantBoard<ClassicRules>
+//            and with the hand-written Board: the leaf and result counts
+//            must agree (255168 games), and the node rates show what the
+//            rules template costs
+//   solve  → the values of the 3×3 variants from the empty board must be
+//            the known ones: classic and misère are draws, wild is a win
+//            for the first player
+//   chaos  → Order and Chaos: a perft to --depth plies and --playouts
+//            random games (how often Order wins by chance)
+//
+// USAGE:
+//   variant_bench [--rounds N] [--depth D] [--playouts N]
+//
+#include "../src/variants.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+struct Counts {
+  uint64_t nodes = 0;
+  uint64_t result[4] = {0, 0, 0, 0};
+};
+
+template <class Rules>
+static void Perft(VariantBoard<Rules> &b, int depth, Counts &c) {
+  c.nodes++;
+  if (b.Over() || depth == 0) {
+    c.result[b.winner]++;
+    return;
+  }
+  uint16_t moves[2 * VariantBoard<Rules>::CELLS];
+  int n = b.GenerateMoves(moves);
+  for (int i = 0; i < n; i++) {
+    b.Make(moves[i]);
+    Perft(b, depth - 1, c);
+    b.Unmake(moves[i]);
+  }
+}
+
+static void Perft(Board &b, Counts &c) {
+  c.nodes++;
+  if (b.Over()) {
+    c.result[b.winner]++;
+    return;
+  }
+  for (uint64_t e = b.Empty(); e; e &= e - 1) {
+    int cell = __builtin_ctzll(e);
+    b.Make(cell);
+    Perft(b, c);
+    b.Unmake(cell);
+  }
+}
+
+static double Seconds(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+template <class Rules>
+static bool CheckSolve(const char *name, int expected) {
+  VariantSolver<Rules> solver;
+  VariantBoard<Rules> b;
+  Clock::time_point t0 = Clock::now();
+  int v = solver.Solve(b);
+  printf("solve   %-8s %-5s (%llu positions, %.1f ms)\n", name,
+         v > 0 ? "win" : v < 0 ? "loss" : "draw",
+         (unsigned long long)solver.Nodes(), Seconds(t0) * 1e3);
+  return v == expected;
+}
+
+int main(int argc, char **argv) {
+  int rounds = 20, depth = 3, playouts = 100000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *k = argv[i], *v = argv[i + 1];
+    if (!strcmp(k, "--rounds"))
+      rounds = atoi(v);
+    else if (!strcmp(k, "--depth"))
+      depth = atoi(v);
+    else if (!strcmp(k, "--playouts"))
+      playouts = atoi(v);
+    else {
+      fprintf(stderr, "unknown option %s\n", k);
+      return 1;
+    }
+  }
+  if (rounds < 1 || depth < 1 || playouts < 0) {
+    fprintf(stderr, "invalid options\n");
+    return 1;
+  }
+
+  // Perft, template against hand-written.
+  Counts tc, bc;
+  Clock::time_point t0 = Clock::now();
+  for (int r = 0; r < rounds; r++) {
+    VariantBoard<ClassicRules> b;
+    tc = Counts();
+    Perft(b, 9, tc);
+  }
+  double tSecs = Seconds(t0);
+  t0 = Clock::now();
+  for (int r = 0; r < rounds; r++) {
+    Board b(3, 3);
+    bc = Counts();
+    Perft(b, bc);
+  }
+  double bSecs = Seconds(t0);
+  uint64_t games = tc.result[1] + tc.result[2] + tc.result[3];
+  printf("perft   3x3: %llu nodes, %llu games (X %llu, O %llu, draw %llu)\n",
+         (unsigned long long)tc.nodes, (unsigned long long)games,
+         (unsigned long long)tc.result[1], (unsigned long long)tc.result[2],
+         (unsigned long long)tc.result[3]);
+  printf("        VariantBoard<ClassicRules> %.1f Mnodes/s, Board %.1f "
+         "Mnodes/s\n",
+         tc.nodes * rounds / tSecs * 1e-6, bc.nodes * rounds / bSecs * 1e-6);
+  if (memcmp(&tc, &bc, sizeof(Counts)) != 0 || games != 255168) {
+    fprintf(stderr, "perft counts differ from Board\n");
+    return 1;
+  }
+
+  // Known values of the 3×3 variants.
+  bool ok = CheckSolve<ClassicRules>("classic", 0);
+  ok &= CheckSolve<MisereRules>("misere", 0);
+  ok &= CheckSolve<WildRules>("wild", 1);
+  if (!ok) {
+    fprintf(stderr, "a variant has the wrong value\n");
+    return 1;
+  }
+
+  // Order and Chaos.
+  Counts oc;
+  VariantBoard<OrderChaosRules> start;
+  t0 = Clock::now();
+  Perft(start, depth, oc);
+  double pSecs = Seconds(t0);
+  printf("chaos   perft(%d): %llu nodes in %.2f s, %.1f Mnodes/s\n", depth,
+         (unsigned long long)oc.nodes, pSecs, oc.nodes / pSecs * 1e-6);
+
+  uint64_t r = 1, orderWins = 0, plies = 0;
+  t0 = Clock::now();
+  for (int g = 0; g < playouts; g++) {
+    VariantBoard<OrderChaosRules> b;
+    uint16_t moves[2 * VariantBoard<OrderChaosRules>::CELLS];
+    while (!b.Over()) {
+      int n = b.GenerateMoves(moves);
+      r = SplitMix64(r);
+      b.Make(moves[r % n]);
+    }
+    orderWins += b.winner == RESULT_X;
+    plies += b.ply;
+  }
+  double gSecs = Seconds(t0);
+  if (playouts)
+    printf("        %d random games: Order wins %.1f%%, %.1f plies each, "
+           "%.0f games/s\n",
+           playouts, 100.0 * orderWins / playouts, (double)plies / playouts,
+           playouts / gSecs);
+  return 0;
+}